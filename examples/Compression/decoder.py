@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+#
+# decoder.py
+#
+# Backend decoder for payloads compressed by the RAK3172 driver (RAK3172_COMPRESSION).
+#
+# Usage:
+#   python3 decoder.py <hex payload>
+#
+
+import sys
+import struct
+
+CODEC_ID_RAW = 0x00
+CODEC_ID_LZ = 0x01
+CODEC_ID_DELTA16 = 0x02
+
+LZ_MIN_MATCH = 3
+
+def decode_lz(data: bytes) -> bytes:
+    output = bytearray()
+    i = 0
+
+    while(i < len(data)):
+        flags = data[i]
+        i += 1
+
+        for bit in range(8):
+            if(i >= len(data)):
+                break
+
+            if(flags & (1 << bit)):
+                offset = data[i] + 1
+                length = data[i + 1] + LZ_MIN_MATCH
+                i += 2
+
+                # Matches can overlap the output. Copy byte by byte.
+                for _ in range(length):
+                    output.append(output[-offset])
+            else:
+                output.append(data[i])
+                i += 1
+
+    return bytes(output)
+
+def decode_delta16(data: bytes) -> bytes:
+    output = bytearray()
+    previous = 0
+    value = 0
+    shift = 0
+
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+
+        if((byte & 0x80) == 0):
+            delta = (value >> 1) ^ -(value & 0x01)
+            previous = ((previous + delta + 0x8000) & 0xFFFF) - 0x8000
+            output += struct.pack("<h", previous)
+            value = 0
+            shift = 0
+
+    return bytes(output)
+
+DECODERS = {
+    CODEC_ID_RAW: lambda data: bytes(data),
+    CODEC_ID_LZ: decode_lz,
+    CODEC_ID_DELTA16: decode_delta16,
+}
+
+def decode(payload: bytes) -> bytes:
+    """ Remove the codec header and decompress the payload. """
+    if(len(payload) == 0):
+        raise ValueError("Empty payload")
+
+    codec = payload[0]
+    if(codec not in DECODERS):
+        raise ValueError("Unknown codec 0x{:02X}".format(codec))
+
+    return DECODERS[codec](payload[1:])
+
+def split_records(payload: bytes) -> list:
+    """ Split a coalesced uplink (RAK3172_UPLINK_COALESCE) into the length prefixed records. """
+    records = []
+    i = 0
+
+    while(i < len(payload)):
+        length = payload[i]
+        records.append(payload[i + 1:i + 1 + length])
+        i += 1 + length
+
+    return records
+
+if(__name__ == "__main__"):
+    if(len(sys.argv) != 2):
+        print("Usage: {} <hex payload>".format(sys.argv[0]))
+        sys.exit(1)
+
+    print(decode(bytes.fromhex(sys.argv[1])).hex().upper())
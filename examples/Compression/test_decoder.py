@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+#
+# test_decoder.py
+#
+# Round trip test for the backend decoder. The vector file is written by the host test "test/host/test_codec.cpp".
+# Each line contains the uncompressed data and the payload with codec header, which was compressed by the driver, as hex string.
+#
+# Usage:
+#   python3 test_decoder.py <vector file>
+#
+
+import sys
+
+import decoder
+
+if(__name__ == "__main__"):
+    if(len(sys.argv) != 2):
+        print("Usage: {} <vector file>".format(sys.argv[0]))
+        sys.exit(1)
+
+    failed = 0
+    uncompressed = 0
+    compressed = 0
+
+    with open(sys.argv[1], "r") as file:
+        lines = file.read().splitlines()
+
+    for line in lines:
+        data, payload = [bytes.fromhex(field) for field in line.split()]
+
+        if(decoder.decode(payload) != data):
+            print("Decoding failed: {}".format(payload.hex().upper()))
+            failed += 1
+
+        uncompressed += len(data)
+        compressed += len(payload)
+
+    # Coalesced uplinks contain length prefixed records.
+    records = [bytes([0x02, 0x41, 0x42]), bytes([0x00]), bytes([0x01, 0x43])]
+    if(decoder.split_records(b"".join([bytes([len(record)]) + record for record in records])) != records):
+        print("Splitting of records failed")
+        failed += 1
+
+    print("{} payloads, {} of {} bytes, {} failed".format(len(lines), compressed, uncompressed, failed))
+
+    sys.exit(1 if((failed > 0) or (len(lines) == 0)) else 0)
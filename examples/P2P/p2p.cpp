@@ -58,7 +58,7 @@ static void applicationTask(void* p_Parameter)
     {
         ESP_LOGI(TAG, " RSSI: %i", Message.RSSI);
         ESP_LOGI(TAG, " SNR: %i", Message.SNR);
-        ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+        ESP_LOGI(TAG, " Payload: %s", RAK3172_Rx_GetPayload(Message).c_str());
     }
 
     Error = RAK3172_P2P_Listen(_Device, 60000);
@@ -77,7 +77,7 @@ static void applicationTask(void* p_Parameter)
             {
                 ESP_LOGI(TAG, " RSSI: %i", Message.RSSI);
                 ESP_LOGI(TAG, " SNR: %i", Message.SNR);
-                ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+                ESP_LOGI(TAG, " Payload: %s", RAK3172_Rx_GetPayload(Message).c_str());
             }
         }
         else
@@ -12,7 +12,9 @@
 
 #include "settings/LoRaWAN_Default.h"
 
-static RTC_NOINIT_ATTR RAK3172_t _Device;
+static RTC_NOINIT_ATTR RAK3172_Snapshot_t _Snapshot;
+
+static RAK3172_t _Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, GPIO_NUM_12, GPIO_NUM_14, 9600);
 
 static StackType_t _applicationStack[8192];
 
@@ -24,12 +26,19 @@ static const char* TAG 							= "main";
 
 static void applicationTask(void* p_Parameter)
 {
-    if((rtc_get_reset_reason(0) == POWERON_RESET) && (rtc_get_reset_reason(1) == EXT_CPU_RESET))
+    bool isResumed = false;
+
+    // Try to resume the driver from the snapshot in the RTC memory. Use a full initialization when no valid snapshot is available.
+    if((rtc_get_reset_reason(0) == DEEPSLEEP_RESET) || (rtc_get_reset_reason(1) == DEEPSLEEP_RESET))
+    {
+        isResumed = (RAK3172_Resume(_Device, _Snapshot) == RAK3172_ERR_OK);
+    }
+
+    if(isResumed == false)
     {
         RAK3172_Error_t Error;
         RAK3172_Info_t Info;
 
-		_Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, GPIO_NUM_12, GPIO_NUM_14, 9600);
         _Device.Info = &Info;
 
         Error = RAK3172_Init(_Device);
@@ -47,13 +56,13 @@ static void applicationTask(void* p_Parameter)
         {
             ESP_LOGE(TAG, "Cannot initialize RAK3172 LoRaWAN! Error: 0x%04X", Error);
         }
+
+        _Device.Info = NULL;
     }
-    else if((rtc_get_reset_reason(0) == DEEPSLEEP_RESET) || (rtc_get_reset_reason(1) == DEEPSLEEP_RESET))
+    else
     {
         RAK3172_Error_t Error;
 
-        RAK3172_WakeUp(_Device);
-
         if(RAK3172_LoRaWAN_isJoined(_Device) == false)
         {
             ESP_LOGI(TAG, "Not joined. Rejoin...");
@@ -91,14 +100,14 @@ static void applicationTask(void* p_Parameter)
                     ESP_LOGI(TAG, " RSSI: %i", Message.RSSI);
                     ESP_LOGI(TAG, " SNR: %i", Message.SNR);
                     ESP_LOGI(TAG, " Port: %u", Message.Port);
-                    ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+                    ESP_LOGI(TAG, " Payload: %s", RAK3172_Rx_GetPayload(Message).c_str());
                 }
             }
         }
     }
 
-	// Prepare the driver for entering sleep mode.
-    RAK3172_Deinit(_Device);
+	// Prepare the driver for entering sleep mode and store the driver state in the RTC memory.
+    RAK3172_Suspend(_Device, &_Snapshot);
 
     // Disable the RTC fast memory during sleep.
 	esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_FAST_MEM, ESP_PD_OPTION_OFF);
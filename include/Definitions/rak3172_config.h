@@ -45,9 +45,13 @@
                                                                                                         .isBusy = false,                                \
                                                                                                         .RxBuffer = NULL,                               \
                                                                                                         .MessageQueue = NULL,                           \
+                                                                                                        .FreeQueue = NULL,                              \
+                                                                                                        .LinePool = NULL,                               \
                                                                                                         .EventQueue = NULL,                             \
                                                                                                         .ReceiveQueue = NULL,                           \
                                                                                                         .isJoinEvent = false,                           \
+                                                                                                        .Lock = NULL,                                   \
+                                                                                                        .Events = NULL,                                 \
                                                                                                     },                                                  \
                                                                                                     .LoRaWAN = {                                        \
                                                                                                         .Join = RAK_JOIN_ABP,                           \
@@ -86,9 +90,13 @@
                                                                                     .isBusy = false,                                                \
                                                                                     .RxBuffer = NULL,                                               \
                                                                                     .MessageQueue = NULL,                                           \
+                                                                                    .FreeQueue = NULL,                                              \
+                                                                                    .LinePool = NULL,                                               \
                                                                                     .EventQueue = NULL,                                             \
                                                                                     .ReceiveQueue = NULL,                                           \
                                                                                     .isJoinEvent = false,                                           \
+                                                                                    .Lock = NULL,                                                   \
+                                                                                    .Events = NULL,                                                 \
                                                                                 },                                                                  \
                                                                                 .LoRaWAN = {                                                        \
                                                                                     .Join = RAK_JOIN_ABP,                                           \
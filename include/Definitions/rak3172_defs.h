@@ -27,6 +27,7 @@
 #include <freertos/task.h>
 #include <freertos/event_groups.h>
 #include <freertos/queue.h>
+#include <freertos/semphr.h>
 
 #include <string>
 #include <stdint.h>
@@ -45,10 +46,67 @@
  */
 #define RAK3172_NO_TIMEOUT                                      0
 
+/** @brief Idle time in milliseconds before the driver probes a booting module with an "AT" command.
+ */
+#define RAK3172_READY_PROBE_INTERVAL                            100
+
+/** @brief Valid flags for the parameter cache entries.
+ */
+#define RAK3172_CACHE_BAND                                      (0x01 << 0)
+#define RAK3172_CACHE_SUB_BAND                                  (0x01 << 1)
+#define RAK3172_CACHE_DATARATE                                  (0x01 << 2)
+#define RAK3172_CACHE_RETRIES                                   (0x01 << 3)
+#define RAK3172_CACHE_CONFIRMATION                              (0x01 << 4)
+#define RAK3172_CACHE_ADR                                       (0x01 << 5)
+#define RAK3172_CACHE_JOIN_MODE                                 (0x01 << 6)
+#define RAK3172_CACHE_RX2_DELAY                                 (0x01 << 7)
+
+/** @brief Event group bits for the module events.
+ */
+#define RAK3172_EVENT_JOINED                                    (0x01 << 0)
+#define RAK3172_EVENT_JOIN_FAILED                               (0x01 << 1)
+#define RAK3172_EVENT_CONFIRMED_OK                              (0x01 << 2)
+#define RAK3172_EVENT_CONFIRMED_FAILED                          (0x01 << 3)
+#define RAK3172_EVENT_ASYNC_STOPPED                             (0x01 << 4)
+#define RAK3172_EVENT_UPLINK_STOPPED                            (0x01 << 5)
+
+/** @brief Maximum number of duty cycle sub bands of a frequency band.
+ */
+#define RAK3172_DUTY_CYCLE_SUB_BANDS                            6
+
 /** @brief Hook for a custom wait callback.
  */
 typedef void (*RAK3172_Wait_t)(void);
 
+/** @brief Data segment for the scatter-gather transmit functions.
+ */
+typedef struct
+{
+    const void* p_Data;                                 /**< Pointer to segment data. */
+    size_t Length;                                      /**< Length of the segment in bytes. */
+} RAK3172_Segment_t;
+
+/** @brief          Compression function of a codec.
+ *                  NOTE: The function must not allocate memory.
+ *  @param p_Input  Pointer to uncompressed data
+ *  @param Length   Length of the uncompressed data
+ *  @param p_Output Pointer to output buffer
+ *  @param Size     Size of the output buffer
+ *  @param p_Arg    User defined argument
+ *  @return         Length of the compressed data
+ *                  0 when the data can not be compressed into the output buffer
+ */
+typedef size_t (*RAK3172_Codec_Encode_t)(const uint8_t* p_Input, size_t Length, uint8_t* p_Output, size_t Size, void* p_Arg);
+
+/** @brief RAK3172 codec object.
+ */
+typedef struct
+{
+    uint8_t ID;                                         /**< Codec ID. Transmitted in front of the compressed data. */
+    RAK3172_Codec_Encode_t Encode;                      /**< Compression function. */
+    void* p_Arg;                                        /**< User defined argument for the compression function. */
+} RAK3172_Codec_t;
+
 /** @brief  Encryption key definition.
  *          NOTE: Only used with RUI3 API support enabled.
  */
@@ -238,6 +296,39 @@ typedef struct
     std::string RepoInfo;               /**< Firmware repo information. */
 } RAK3172_Info_t;
 
+/** @brief RAK3172 receive line object.
+ */
+typedef struct
+{
+    char Data[CONFIG_RAK3172_UART_LINE_LENGTH + 1];     /**< Line content without line endings (zero terminated). */
+    uint16_t Length;                                    /**< Length of the line content in bytes. */
+} RAK3172_Line_t;
+
+/** @brief RAK3172 batch command object.
+ */
+typedef struct
+{
+    std::string Command;                                /**< RAK3172 command. */
+    std::string* p_Value;                               /**< (Optional) Pointer to returned value. Set to NULL when the command doesn´t return a value. */
+    RAK3172_Error_t Error;                              /**< Result of the command. Set by "RAK3172_SendBatch". */
+} RAK3172_BatchItem_t;
+
+/** @brief RAK3172 parameter cache object.
+ */
+typedef struct
+{
+    uint32_t Valid;                                     /**< Valid cache entries (see RAK3172_CACHE_*). */
+    RAK3172_Band_t Band;                                /**< Cached frequency band. */
+    RAK3172_SubBand_t SubBand;                          /**< Cached sub band. */
+    RAK3172_DataRate_t DataRate;                        /**< Cached data rate.
+                                                             NOTE: Only valid as long as ADR is disabled. */
+    uint8_t Retries;                                    /**< Cached number of confirmed payload retransmissions. */
+    bool Confirmation;                                  /**< Cached confirmation mode. */
+    bool ADR;                                           /**< Cached ADR status. */
+    RAK3172_JoinMode_t JoinMode;                        /**< Cached join mode. */
+    uint32_t RX2Delay;                                  /**< Cached RX2 delay in milliseconds. */
+} RAK3172_Cache_t;
+
 /** @brief RAK3172 device object definition.
  */
 typedef struct
@@ -262,9 +353,15 @@ typedef struct
                                              NOTE: Managed by the driver. */
         bool isBusy;                    /**< #true when the device is busy.
                                              NOTE: Managed by the driver. */
+        bool isEchoDisabled;            /**< #true when the echo mode of the module is disabled.
+                                             NOTE: Managed by the driver. */
         uint8_t* RxBuffer;              /**< Pointer to receive buffer.
                                              NOTE: Managed by the driver. */
-        QueueHandle_t MessageQueue;     /**< Module Rx message queue used by the receiving task.
+        QueueHandle_t MessageQueue;     /**< Module Rx message queue used by the receiving task. The queue transports the indices of the line pool slots.
+                                             NOTE: Managed by the driver. */
+        QueueHandle_t FreeQueue;        /**< Queue with the indices of all unused line pool slots.
+                                             NOTE: Managed by the driver. */
+        RAK3172_Line_t* LinePool;       /**< Pointer to the receive line pool.
                                              NOTE: Managed by the driver. */
         QueueHandle_t EventQueue;       /**< Event queue used by the UART driver for the pattern detection.
                                              NOTE: Managed by the driver. */
@@ -272,6 +369,42 @@ typedef struct
                                              NOTE: Managed by the driver. */
         bool isJoinEvent;               /**< #true when a join event has occured.
                                              NOTE: Only used for module firmware without RUI3 interface! */
+        SemaphoreHandle_t Lock;         /**< Lock to serialize the communication with the module.
+                                             NOTE: Managed by the driver. */
+        EventGroupHandle_t Events;      /**< Event group with the module events.
+                                             NOTE: Managed by the driver. */
+        #ifdef CONFIG_RAK3172_ASYNC_ENABLE
+            TaskHandle_t AsyncHandle;   /**< Handle for the asynchronous command worker.
+                                             NOTE: Managed by the driver. */
+            QueueHandle_t AsyncQueue;   /**< Command queue for the asynchronous command worker.
+                                             NOTE: Managed by the driver. */
+        #endif
+        #ifdef CONFIG_RAK3172_COMPRESSION
+            const RAK3172_Codec_t* Codec;   /**< Codec used by the transmit functions. NULL when the payload is transmitted without codec header.
+                                                 NOTE: Managed by the driver. */
+        #endif
+        #ifdef CONFIG_RAK3172_UPLINK_ENABLE
+            TaskHandle_t UplinkHandle;  /**< Handle for the uplink sender task.
+                                             NOTE: Managed by the driver. */
+            QueueHandle_t UplinkQueue;  /**< Queue with the pending uplinks.
+                                             NOTE: Managed by the driver. */
+            uint32_t UplinkTicket;      /**< Ticket of the last submitted uplink.
+                                             NOTE: Managed by the driver. */
+            #ifdef CONFIG_RAK3172_UPLINK_COALESCE
+                uint8_t CoalesceBuffer[CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE];     /**< Records for the next coalesced uplink.
+                                                                                     NOTE: Managed by the driver. */
+                uint16_t CoalesceLength;                                        /**< Length of the records in the coalescing buffer.
+                                                                                     NOTE: Managed by the driver. */
+                uint16_t CoalesceLimit;                                         /**< Maximum payload size of the coalesced uplink.
+                                                                                     NOTE: Managed by the driver. */
+                uint8_t CoalescePort;                                           /**< Port of the coalesced uplink.
+                                                                                     NOTE: Managed by the driver. */
+                uint8_t CoalesceRecords;                                        /**< Number of records in the coalescing buffer.
+                                                                                     NOTE: Managed by the driver. */
+                unsigned long CoalesceDeadline;                                 /**< Transmission deadline of the coalesced uplink in milliseconds since boot.
+                                                                                     NOTE: Managed by the driver. */
+            #endif
+        #endif
     } Internal;
     struct
     {
@@ -282,7 +415,19 @@ typedef struct
         bool ConfirmError;              /**< Message confirmation failed.
                                              NOTE: Managed by the driver. */
         uint8_t AttemptCounter;         /**< Attempt counter for the join process.
-                                             NOTE: Managed by the driver and only used when RUI3 isn´t used. */
+                                             NOTE: Managed by the driver. */
+        uint8_t JoinInterval;           /**< Interval between two join attempts in seconds.
+                                             NOTE: Managed by the driver. */
+        bool isAutoJoin;                /**< Auto join enabled for the join process.
+                                             NOTE: Managed by the driver. */
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_FRAGMENTATION
+            uint8_t MessageID;          /**< ID of the last fragmented message.
+                                             NOTE: Managed by the driver. */
+        #endif
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+            unsigned long DutyCycle[RAK3172_DUTY_CYCLE_SUB_BANDS];  /**< End of the off time for each duty cycle sub band in milliseconds since boot.
+                                                                         NOTE: Managed by the driver. */
+        #endif
     } LoRaWAN;
     struct
     {
@@ -299,13 +444,60 @@ typedef struct
         QueueHandle_t ListenQueue;      /**< Listen queue used by the "RAK3172_P2P_Listen" function.
                                              NOTE: Managed by the driver. */
     } P2P;
+    RAK3172_Cache_t Cache;              /**< Cached module parameters.
+                                             NOTE: Managed by the driver. */
+    struct
+    {
+        uint32_t CacheHits;             /**< Number of getter calls served from the cache. */
+        uint32_t CacheMisses;           /**< Number of getter calls which required a module request. */
+        uint32_t ReadyLatency;          /**< Time between the last reset and the ready module in milliseconds. */
+        uint32_t ModeSwitchLatency;     /**< Duration of the last mode switch in milliseconds. */
+        uint32_t JoinAttempts;          /**< Number of join requests transmitted by the join scheduler. */
+        uint32_t JoinAirtime;           /**< Airtime of the join requests transmitted by the join scheduler in milliseconds. */
+        uint32_t SkippedCommands;       /**< Number of retry and confirmation commands skipped by the transmit function because the setting was already applied. */
+        uint32_t UplinkCompleted;       /**< Number of successful uplinks from the uplink queue. */
+        uint32_t UplinkDropped;         /**< Number of uplinks which were rejected by the full uplink queue or failed after all retries. */
+        uint32_t UplinkLatency;         /**< Time between the submission and the completion of the last uplink from the uplink queue in milliseconds. */
+        uint32_t CoalescedRecords;      /**< Number of records transmitted in coalesced uplinks. */
+        uint32_t CoalescedFrames;       /**< Number of coalesced uplinks. The packing ratio is CoalescedRecords / CoalescedFrames. */
+        uint32_t CodecInput;            /**< Number of LoRaWAN payload bytes passed into the codec. */
+        uint32_t CodecOutput;           /**< Number of LoRaWAN payload bytes transmitted by the codec including the codec header. */
+        uint32_t DutyCycleBlocked;      /**< Number of uplinks rejected by the duty cycle ledger without a module request. */
+        uint32_t AckLatency;            /**< Time between the transmission and the confirmation of the last confirmed uplink in milliseconds. */
+        uint32_t AckTimeouts;           /**< Number of confirmed uplinks without a confirmation result before the deadline. */
+    } Statistics;
 } RAK3172_t;
 
+/** @brief Maximum length of the information strings stored in a driver snapshot.
+ */
+#define RAK3172_SNAPSHOT_INFO_LENGTH                            32
+
+/** @brief RAK3172 driver snapshot object. Use this object to keep the driver state in the RTC memory during deep sleep.
+ *         NOTE: The object must only be written by "RAK3172_Suspend".
+ */
+typedef struct
+{
+    uint32_t Magic;                                     /**< Magic number to detect a valid snapshot. */
+    RAK3172_Mode_t Mode;                                /**< Device mode. */
+    RAK3172_Baud_t Baudrate;                            /**< Module baud rate. */
+    bool isEchoDisabled;                                /**< #true when the echo mode of the module is disabled. */
+    bool isJoined;                                      /**< LoRaWAN join status. */
+    RAK3172_JoinMode_t Join;                            /**< LoRaWAN join mode. */
+    RAK3172_Cache_t Cache;                              /**< Cached module parameters. */
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        uint32_t DutyCycle[RAK3172_DUTY_CYCLE_SUB_BANDS];   /**< Remaining off time for each duty cycle sub band in milliseconds. */
+    #endif
+    char Firmware[RAK3172_SNAPSHOT_INFO_LENGTH + 1];    /**< Firmware version string. */
+    char Serial[RAK3172_SNAPSHOT_INFO_LENGTH + 1];      /**< Serial number string. */
+} RAK3172_Snapshot_t;
+
 /** @brief RAK3172 message receive object.
  */
 typedef struct
 {
-    std::string Payload;                /**< Received payload. */
+    uint8_t Payload[CONFIG_RAK3172_UART_RX_PAYLOAD_SIZE];   /**< Received payload (binary).
+                                                                 NOTE: Use "RAK3172_Rx_GetPayload" to get the payload as hex string. */
+    uint16_t Length;                    /**< Length of the received payload in bytes. */
     int8_t RSSI;                        /**< Receiving RSSI value. */
     int8_t SNR;                         /**< Receiving SNR value. */
     uint8_t Port;                       /**< Port number.
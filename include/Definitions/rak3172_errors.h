@@ -93,4 +93,8 @@ typedef uint32_t RAK3172_Error_t;
  */
 #define RAK3172_ERR_RESTRICTED          (RAK3172_ERR_BASE + 10)
 
+/** @brief The baud rate of the module is unknown. A module reset is necessary.
+ */
+#define RAK3172_ERR_BAUDRATE_UNKNOWN    (RAK3172_ERR_BASE + 11)
+
 #endif /* RAK3172_ERRORS_H_ */
\ No newline at end of file
@@ -20,6 +20,8 @@
 #ifndef RAK3172_LORAWAN_H_
 #define RAK3172_LORAWAN_H_
 
+#include <vector>
+
 #include "rak3172_defs.h"
 
 #ifdef CONFIG_RAK3172_USE_RUI3
@@ -34,6 +36,53 @@
     #include "rak3172_lorawan_class_b.h"
 #endif
 
+#ifdef CONFIG_RAK3172_UPLINK_ENABLE
+    #include "rak3172_lorawan_uplink.h"
+#endif
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+    #include "rak3172_lorawan_dutycycle.h"
+#endif
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_FRAGMENTATION
+    #include "rak3172_lorawan_fragment.h"
+#endif
+
+/** @brief Additional bytes of an uplink frame without MAC commands (MHDR + FHDR + FPort + MIC).
+ */
+#define RAK3172_LORAWAN_FRAME_OVERHEAD                          13
+
+/** @brief Maximum application payload of an uplink frame in bytes. The module splits longer payload into multiple frames.
+ */
+#define RAK3172_LORAWAN_FRAME_PAYLOAD_MAX                       242
+
+/** @brief RAK3172 LoRaWAN configuration object.
+ */
+typedef struct
+{
+    RAK3172_Class_t Class;                              /**< LoRaWAN device class. */
+    RAK3172_Band_t Band;                                /**< LoRaWAN frequency band. */
+    RAK3172_SubBand_t SubBand;                          /**< LoRa sub band.
+                                                             NOTE: Only needed when US915, AU915 or CN470 band is used. Otherwise set it to RAK_SUB_BAND_NONE! */
+    bool UseADR;                                        /**< Enable adaptive data rate. */
+    uint8_t TxPwr;                                      /**< Tx power in dB. */
+    RAK3172_JoinMode_t JoinMode;                        /**< LoRaWAN join mode. */
+    const uint8_t* p_Key1;                              /**< Pointer to key 1 (OTAA: DEVEUI, ABP: APPSKEY). */
+    const uint8_t* p_Key2;                              /**< Pointer to key 2 (OTAA: APPEUI, ABP: NWKSKEY). */
+    const uint8_t* p_Key3;                              /**< Pointer to key 3 (OTAA: APPKEY, ABP: DEVADDR). */
+} RAK3172_LoRaWAN_Config_t;
+
+/** @brief LoRaWAN join scheduler object.
+ */
+typedef struct
+{
+    uint8_t Attempts;                                   /**< Maximum number of join attempts. */
+    RAK3172_DataRate_t DataRateMax;                     /**< Data rate for the first join attempts. */
+    RAK3172_DataRate_t DataRateMin;                     /**< Most robust data rate used for the last join attempts. */
+    uint8_t AttemptsPerDataRate;                        /**< Number of join attempts before the next lower data rate is used. */
+    uint32_t Jitter;                                    /**< Maximum random delay in milliseconds added before each join attempt. */
+} RAK3172_LoRaWAN_JoinSchedule_t;
+
 /** @brief          Initialize the RAK3172 SoM in LoRaWAN mode.
  *  @param p_Device RAK3172 device object
  *  @param TxPwr    Tx power in dB
@@ -59,6 +108,19 @@
  */
 RAK3172_Error_t RAK3172_LoRaWAN_Init(RAK3172_t& p_Device, uint8_t TxPwr, RAK3172_JoinMode_t JoinMode, const uint8_t* const p_Key1, const uint8_t* const p_Key2, const uint8_t* const p_Key3, RAK3172_Class_t Class, RAK3172_Band_t Band, RAK3172_SubBand_t Subband = RAK_SUB_BAND_NONE, bool UseADR = true, uint32_t Timeout = 10);
 
+/** @brief              Apply a LoRaWAN configuration to the module.
+ *                      The current configuration is read from the module and only the differing parameters are written.
+ *                      All parameters after the band are written when the band changes, because the module resets them.
+ *                      NOTE: A rejoin is necessary when the keys or the join mode have changed.
+ *  @param p_Device     RAK3172 device object
+ *  @param Config       Desired LoRaWAN configuration
+ *  @param p_Changes    (Optional) Pointer to list of the written commands
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                      RAK3172_ERR_INVALID_MODE when the device is not in LoRaWAN mode
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Apply(RAK3172_t& p_Device, const RAK3172_LoRaWAN_Config_t& Config, std::vector<std::string>* const p_Changes = NULL);
+
 /** @brief              Set the keys for OTAA mode.
  *  @param p_Device     RAK3172 device object
  *  @param p_DEVEUI     Pointer to LoRaWAN DEVEUI (8 Bytes)
@@ -91,7 +153,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
  *                          NOTE: Set to 0 to disable the timeout function.
  *                          NOTE: Only used when \ref Block is set to #true (default).
  *  @param Block            (Optional) Enable / Disable the blocking of this function
- *                          NOTE: Only supported with RUI3 firmware.
+ *                          NOTE: Use \ref RAK3172_LoRaWAN_WaitJoin to wait for the result when the function is not blocking.
  *  @param EnableAutoJoin   (Optional) Enable auto join after power up
  *  @param Interval         (Optional) Reattempt interval
  *  @param on_Wait          (Optional) Hook for a custom wait function
@@ -104,6 +166,120 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
  */
 RAK3172_Error_t RAK3172_LoRaWAN_StartJoin(RAK3172_t& p_Device, uint8_t Attempts = 5, uint32_t Timeout = 0, bool Block = true, bool EnableAutoJoin = false, uint8_t Interval = 10, RAK3172_Wait_t on_Wait = NULL);
 
+/** @brief                  Start the joining process and return immediately.
+ *                          The event task sets the event bits RAK3172_EVENT_JOINED or RAK3172_EVENT_JOIN_FAILED in the event group of the device when the join process has finished.
+ *                          NOTE: Use \ref RAK3172_LoRaWAN_WaitJoin to wait for the result. Firmware without RUI3 repeats the join attempts in this function.
+ *  @param p_Device         RAK3172 device object
+ *  @param Attempts         (Optional) No. of join attempts
+ *  @param EnableAutoJoin   (Optional) Enable auto join after power up
+ *  @param Interval         (Optional) Reattempt interval
+ *  @return                 RAK3172_ERR_OK when the join process was started
+ *                          RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                          RAK3172_ERR_BUSY when the device is busy
+ *                          RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_StartJoinAsync(RAK3172_t& p_Device, uint8_t Attempts = 5, bool EnableAutoJoin = false, uint8_t Interval = 10);
+
+/** @brief                  Wait for the result of the joining process. The calling task is blocked until the event task reports the result.
+ *  @param p_Device         RAK3172 device object
+ *  @param Timeout          (Optional) Timeout in seconds
+ *                          NOTE: Set to 0 to disable the timeout function.
+ *  @param on_Wait          (Optional) Hook for a custom wait function
+ *                          NOTE: The hook is called every 20 ms. Without a hook the task doesn´t wake up until the join process has finished.
+ *  @return                 RAK3172_ERR_OK when joined
+ *                          RAK3172_ERR_FAIL when all join attempts have failed
+ *                          RAK3172_ERR_TIMEOUT when a join timeout has occured
+ *                          RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_WaitJoin(RAK3172_t& p_Device, uint32_t Timeout = 0, RAK3172_Wait_t on_Wait = NULL);
+
+/** @brief              Join the network with a back-off between the join attempts.
+ *                      The data rate is lowered from \ref DataRateMax to \ref DataRateMin during the attempts. The delay between two attempts
+ *                      follows the aggregated duty cycle of the LoRaWAN specification for join requests (1 % during the first hour, 0.1 % during the next
+ *                      10 hours, 0.01 % afterwards) plus a random jitter.
+ *                      NOTE: This is a blocking function! The number of attempts and the used airtime are stored in the statistics of the device object.
+ *  @param p_Device     RAK3172 device object
+ *  @param Schedule     Join scheduler object
+ *  @param Timeout      (Optional) Timeout in seconds
+ *                      NOTE: Set to 0 to disable the timeout function.
+ *  @return             RAK3172_ERR_OK when joined
+ *                      RAK3172_ERR_FAIL when all join attempts have failed
+ *                      RAK3172_ERR_TIMEOUT when the next join attempt is not possible before the timeout
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_JoinScheduled(RAK3172_t& p_Device, const RAK3172_LoRaWAN_JoinSchedule_t& Schedule, uint32_t Timeout = 0);
+
+/** @brief                      Join the network and search the sub band of the gateway.
+ *                              The sub bands are tested in ascending order. The last successful sub band is tested first and stored after a successful join.
+ *                              The delay between two attempts uses the off time and the jitter of \ref RAK3172_LoRaWAN_GetJoinDelay.
+ *                              NOTE: Only supported with the US915 and AU915 frequency band.
+ *                              NOTE: The sub band is stored in the NVS. The application must call "nvs_flash_init" before this function.
+ *                              NOTE: This is a blocking function! The search stops when the join airtime of the first hour (1 % duty cycle) is used up.
+ *  @param p_Device             RAK3172 device object
+ *  @param AttemptsPerSubBand   (Optional) Number of join attempts for each sub band
+ *  @param Timeout              (Optional) Timeout in seconds
+ *                              NOTE: Set to 0 to disable the timeout function.
+ *  @param Jitter               (Optional) Maximum random delay in milliseconds added before each join attempt
+ *  @return                     RAK3172_ERR_OK when joined
+ *                              RAK3172_ERR_FAIL when all join attempts have failed
+ *                              RAK3172_ERR_TIMEOUT when a join timeout has occured
+ *                              RAK3172_ERR_INVALID_ARG when an invalid argument was passed or when the frequency band has no sub bands
+ *                              RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_JoinSubBandDiscovery(RAK3172_t& p_Device, uint8_t AttemptsPerSubBand = 2, uint32_t Timeout = 0, uint32_t Jitter = 5000);
+
+/** @brief                  Calculate the time on air of a LoRa frame.
+ *  @param SF               Spreading factor (5 - 12)
+ *  @param Bandwidth        Bandwidth in kHz
+ *  @param CodingRate       Coding rate
+ *  @param Preamble         Number of preamble symbols
+ *  @param Length           Length of the payload in bytes
+ *  @param ImplicitHeader   (Optional) #true when the frame doesn´t have a header
+ *  @param CRC              (Optional) #true when the frame uses a payload CRC
+ *  @return                 Time on air in milliseconds
+ *                          0 when an invalid argument is passed into the function
+ */
+uint32_t RAK3172_GetTimeOnAir(uint8_t SF, uint16_t Bandwidth, RAK3172_CR_t CodingRate, uint16_t Preamble, uint16_t Length, bool ImplicitHeader = false, bool CRC = true);
+
+/** @brief          Calculate the time on air of a LoRaWAN frame.
+ *  @param Band     Frequency band
+ *  @param DR       Data rate
+ *  @param Length   Length of the PHY payload in bytes
+ *  @return         Time on air in milliseconds
+ *                  0 when the data rate isn´t defined for the band
+ */
+uint32_t RAK3172_LoRaWAN_GetTimeOnAir(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint16_t Length);
+
+/** @brief          Calculate the time on air of an application payload. The module splits payload with more than
+ *                  \ref RAK3172_LORAWAN_FRAME_PAYLOAD_MAX bytes into multiple frames.
+ *  @param Band     Frequency band
+ *  @param DR       Data rate
+ *  @param Length   Length of the application payload in bytes
+ *  @return         Time on air of all frames in milliseconds
+ *                  0 when the data rate isn´t defined for the band
+ */
+uint32_t RAK3172_LoRaWAN_GetPayloadTimeOnAir(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint16_t Length);
+
+/** @brief          Get the maximum application payload size of a data rate.
+ *  @param Band     Frequency band
+ *  @param DR       Data rate
+ *  @return         Maximum payload size in bytes without MAC commands in the frame header
+ *                  0 when the data rate isn´t defined for the band
+ */
+uint8_t RAK3172_LoRaWAN_GetMaxPayload(RAK3172_Band_t Band, RAK3172_DataRate_t DR);
+
+/** @brief              Get the delay before the next join attempt.
+ *                      The off time follows the aggregated duty cycle of the LoRaWAN specification for join requests (1 % during the first hour,
+ *                      0.1 % during the next 10 hours, 0.01 % afterwards). A random jitter is added to the off time.
+ *  @param Airtime      Time on air of the last join request in milliseconds
+ *  @param Elapsed      Time since the start of the join process in milliseconds
+ *  @param Duration     Time since the start of the last join attempt in milliseconds. This time is part of the off time
+ *  @param Jitter       Maximum random delay in milliseconds
+ *  @return             Delay in milliseconds
+ */
+uint32_t RAK3172_LoRaWAN_GetJoinDelay(uint32_t Airtime, unsigned long Elapsed, unsigned long Duration, uint32_t Jitter);
+
 /** @brief          Stop the joining process.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -148,18 +324,43 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
  *  @param Retries      Number of confirmed payload retransmissions
  *  @param Confirmed    (Optional) Enable message confirmation
  *                      NOTE: Only neccessary when payload is greater than 1024 bytes (long payload)
- *  @param Wait         (Optional) Hook for a custom wait function that is called during each sleep iteration
+ *  @param Wait         (Optional) Hook for a custom wait function that is called every 20 ms while waiting for the confirmation
  *                      NOTE: The function call is time critical. Prevent long wait periods!
+ *                      NOTE: The task sleeps without periodic wake ups until the confirmation result arrives when no hook is used.
  *  @return             RAK3172_ERR_OK when successful
  *                      RAK3172_ERR_BUSY when the device is busy
  *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                      RAK3172_ERR_NOT_CONNECTED when the device is not joined
  *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  *                      RAK3172_ERR_INVALID_RESPONSE when a send confirmation is required, but a confirmation error has occured
+ *                      RAK3172_ERR_TIMEOUT when no confirmation result is reported before the deadline from the RX2 delay and the retries
  *                      RAK3172_ERR_RESTRICTED when a duty cycle restriction error has occured
  */
 RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, uint8_t Retries, bool Confirmed = false, RAK3172_Wait_t Wait = NULL);
 
+/** @brief              Start a LoRaWAN data transmission with a payload from multiple data segments.
+ *                      The segments are encoded one after another into the transmit command without an intermediate buffer.
+ *                      NOTE: This is a blocking function!
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Segments   Pointer to data segments
+ *  @param Count        Number of data segments
+ *  @param Retries      Number of confirmed payload retransmissions
+ *  @param Confirmed    (Optional) Enable message confirmation
+ *  @param Wait         (Optional) Hook for a custom wait function that is called every 20 ms while waiting for the confirmation
+ *                      NOTE: The function call is time critical. Prevent long wait periods!
+ *                      NOTE: The task sleeps without periodic wake ups until the confirmation result arrives when no hook is used.
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_BUSY when the device is busy
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_NOT_CONNECTED when the device is not joined
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ *                      RAK3172_ERR_INVALID_RESPONSE when a send confirmation is required, but a confirmation error has occured
+ *                      RAK3172_ERR_TIMEOUT when no confirmation result is reported before the deadline from the RX2 delay and the retries
+ *                      RAK3172_ERR_RESTRICTED when a duty cycle restriction error has occured
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const RAK3172_Segment_t* const p_Segments, size_t Count, uint8_t Retries, bool Confirmed = false, RAK3172_Wait_t Wait = NULL);
+
 /** @brief              Check if a downlink message was received during the last uplink and pop one message from the stack.
  *  @param p_Device     RAK3172 device object
  *  @param p_Message    Pointer to RAK3172 message object
@@ -179,16 +380,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetRetries(const RAK3172_t& p_Device, uint8_t Retries);
+RAK3172_Error_t RAK3172_LoRaWAN_SetRetries(RAK3172_t& p_Device, uint8_t Retries);
 
 /** @brief              Get the number of confirmed payload retransmissions.
  *  @param p_Device     RAK3172 device object
  *  @param p_Retries    Pointer to number of retries
+ *  @param Refresh      (Optional) Set to #true to read the value from the module instead of the cache
  *  @return             RAK3172_ERR_OK when successful
  *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetRetries(const RAK3172_t& p_Device, uint8_t* const p_Retries);
+RAK3172_Error_t RAK3172_LoRaWAN_GetRetries(RAK3172_t& p_Device, uint8_t* const p_Retries, bool Refresh = false);
 
 /** @brief          Enable / Disable the usage of the public network mode.
  *  @param p_Device RAK3172 device object
@@ -215,16 +417,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetPNM(const RAK3172_t& p_Device, bool* const p_
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetConfirmation(const RAK3172_t& p_Device, bool Enable);
+RAK3172_Error_t RAK3172_LoRaWAN_SetConfirmation(RAK3172_t& p_Device, bool Enable);
 
 /** @brief          Get the current state of the transmission confirmation mode.
  *  @param p_Device RAK3172 device object
  *  @param p_Enable Pointer to confirmation mode
+ *  @param Refresh  (Optional) Set to #true to read the value from the module instead of the cache
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(const RAK3172_t& p_Device, bool* const p_Enable);
+RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(RAK3172_t& p_Device, bool* const p_Enable, bool Refresh = false);
 
 /** @brief          Set the used frequency band.
  *  @param p_Device RAK3172 device object
@@ -233,16 +436,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(const RAK3172_t& p_Device, bool*
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetBand(const RAK3172_t& p_Device, RAK3172_Band_t Band);
+RAK3172_Error_t RAK3172_LoRaWAN_SetBand(RAK3172_t& p_Device, RAK3172_Band_t Band);
 
 /** @brief          Get the used frequency band.
  *  @param p_Device RAK3172 device object
  *  @param p_Band   Pointer to frequency band
+ *  @param Refresh  (Optional) Set to #true to read the value from the module instead of the cache
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_t* const p_Band);
+RAK3172_Error_t RAK3172_LoRaWAN_GetBand(RAK3172_t& p_Device, RAK3172_Band_t* const p_Band, bool Refresh = false);
 
 /** @brief          Set the sub band for the LoRaWAN communication.
  *  @param p_Device RAK3172 device object
@@ -252,16 +456,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_
  *                  RAK3172_ERR_INVALID_RESPONSE when the device is operating in the wrong frequency band
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t Band);
+RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(RAK3172_t& p_Device, RAK3172_SubBand_t Band);
 
 /** @brief          Get the sub band for the LoRaWAN communication.
  *  @param p_Device RAK3172 device object
  *  @param Band     Pointer to frequency sub band
+ *  @param Refresh  (Optional) Set to #true to read the value from the module instead of the cache
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t* const p_Band);
+RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(RAK3172_t& p_Device, RAK3172_SubBand_t* const p_Band, bool Refresh = false);
 
 /** @brief          Set the Tx power of the RAK3172.
  *                  NOTE: The index of the Tx power and the resulting power depends on the selected region!
@@ -272,7 +477,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_Su
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(const RAK3172_t& p_Device, uint8_t TxPwr);
+RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(RAK3172_t& p_Device, uint8_t TxPwr);
 
 /** @brief          Set the join delay on the RX window 1.
  *  @param p_Device RAK3172 device object
@@ -317,7 +522,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetJoin2Delay(const RAK3172_t& p_Device, uint32_
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetRX1Delay(const RAK3172_t& p_Device, uint32_t Delay);
+RAK3172_Error_t RAK3172_LoRaWAN_SetRX1Delay(RAK3172_t& p_Device, uint32_t Delay);
 
 /** @brief          Set the delay of RX window 1.
  *  @param p_Device RAK3172 device object
@@ -353,7 +558,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX2Freq(const RAK3172_t& p_Device, uint32_t*
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Delay(const RAK3172_t& p_Device, uint32_t Delay);
+RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Delay(RAK3172_t& p_Device, uint32_t Delay);
 
 /** @brief          Set the delay of RX window 2.
  *  @param p_Device RAK3172 device object
@@ -371,7 +576,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX2Delay(const RAK3172_t& p_Device, uint32_t*
  *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetRX2DataRate(const RAK3172_t& p_Device, uint8_t DataRate);
+RAK3172_Error_t RAK3172_LoRaWAN_SetRX2DataRate(RAK3172_t& p_Device, uint8_t DataRate);
 
 /** @brief              Get the data rate of the received window 2.
  *  @param p_Device     RAK3172 device object
@@ -409,7 +614,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRSSI(const RAK3172_t& p_Device, int8_t* p_RSS
  *                  RAK3172_ERR_INVALID_RESPONSE when the device is operating in the wrong frequency band
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* const p_Duty);
+RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(RAK3172_t& p_Device, uint8_t* const p_Duty);
 
 /** @brief          Set the data rate of the LoRa module.
  *  @param p_Device RAK3172 device object
@@ -419,17 +624,18 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* cons
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t DR);
+RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t DR);
 
 /** @brief          Get the data rate of the LoRa module.
  *  @param p_Device RAK3172 device object
  *  @param p_DR     Pointer to data rate
+ *  @param Refresh  (Optional) Set to #true to read the value from the module instead of the cache
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR);
+RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR, bool Refresh = false);
 
 /** @brief          Enable / Disable the adaptive data rate.
  *  @param p_Device RAK3172 device object
@@ -439,17 +645,29 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_D
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetADR(const RAK3172_t& p_Device, bool Enable);
+RAK3172_Error_t RAK3172_LoRaWAN_SetADR(RAK3172_t& p_Device, bool Enable);
 
 /** @brief          Get the status of the adaptive data rate option.
  *  @param p_Device RAK3172 device object
  *  @param p_Enable Pointer to adaptive data rate status
+ *  @param Refresh  (Optional) Set to #true to read the value from the module instead of the cache
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
+ *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_GetADR(RAK3172_t& p_Device, bool* const p_Enable, bool Refresh = false);
+
+/** @brief          Get the data rate for the payload size of queued uplinks.
+ *                  NOTE: DR0 is used when the adaptive data rate option is enabled, because the ADR can lower the data rate before the transmission.
+ *  @param p_Device RAK3172 device object
+ *  @param p_DR     Pointer to data rate
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_Enable);
+RAK3172_Error_t RAK3172_LoRaWAN_GetUplinkDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR);
 
 /** @brief          Set the LoRaWAN join mode.
  *  @param p_Device RAK3172 device object
@@ -459,17 +677,18 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(const RAK3172_t& p_Device, RAK3172_JoinMode_t Mode);
+RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(RAK3172_t& p_Device, RAK3172_JoinMode_t Mode);
 
 /** @brief          Get the current LoRaWAN join mode.
  *  @param p_Device RAK3172 device object
  *  @param p_Mode   Pointer to join mode
+ *  @param Refresh  (Optional) Set to #true to read the value from the module instead of the cache
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_GetJoinMode(const RAK3172_t& p_Device, RAK3172_JoinMode_t* const p_Mode);
+RAK3172_Error_t RAK3172_LoRaWAN_GetJoinMode(RAK3172_t& p_Device, RAK3172_JoinMode_t* const p_Mode, bool Refresh = false);
 
 /** @brief          Get the RSSI value of the last packet.
  *  @param p_Device RAK3172 device object
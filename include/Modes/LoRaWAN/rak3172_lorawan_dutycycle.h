@@ -0,0 +1,59 @@
+ /*
+ * rak3172_lorawan_dutycycle.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LORAWAN_DUTYCYCLE_H_
+#define RAK3172_LORAWAN_DUTYCYCLE_H_
+
+#include "rak3172_defs.h"
+
+/** @brief              Get the inverse duty cycle of a transmission. The sub band is blocked for the time on air multiplied with this factor.
+ *  @param Band         Frequency band
+ *  @param Frequency    (Optional) Frequency of the transmission in Hz
+ *                      NOTE: Set to 0 to use the default uplink channels of the frequency band.
+ *  @return             Inverse duty cycle (100 for 1 %)
+ *                      1 when the frequency band doesn´t use a duty cycle
+ */
+uint16_t RAK3172_LoRaWAN_DutyCycle_GetFactor(RAK3172_Band_t Band, uint32_t Frequency = 0);
+
+/** @brief              Get the time until the duty cycle allows the next transmission.
+ *  @param p_Device     RAK3172 device object
+ *  @param Frequency    (Optional) Frequency of the transmission in Hz
+ *                      NOTE: Set to 0 to use the default uplink channels of the frequency band.
+ *  @return             Wait time in milliseconds
+ *                      0 when the transmission is allowed or the frequency band doesn´t use a duty cycle
+ */
+uint32_t RAK3172_LoRaWAN_DutyCycle_GetWait(RAK3172_t& p_Device, uint32_t Frequency = 0);
+
+/** @brief              Add a transmission to the duty cycle ledger.
+ *                      NOTE: This function is called by "RAK3172_LoRaWAN_Transmit".
+ *  @param p_Device     RAK3172 device object
+ *  @param Length       Length of the application payload in bytes
+ *  @param Frequency    (Optional) Frequency of the transmission in Hz
+ *                      NOTE: Set to 0 to use the default uplink channels of the frequency band.
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_DutyCycle_Add(RAK3172_t& p_Device, uint16_t Length, uint32_t Frequency = 0);
+
+/** @brief          Clear the duty cycle ledger.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_LoRaWAN_DutyCycle_Clear(RAK3172_t& p_Device);
+
+#endif /* RAK3172_LORAWAN_DUTYCYCLE_H_ */
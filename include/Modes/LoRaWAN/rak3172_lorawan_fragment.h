@@ -0,0 +1,114 @@
+ /*
+ * rak3172_lorawan_fragment.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LORAWAN_FRAGMENT_H_
+#define RAK3172_LORAWAN_FRAGMENT_H_
+
+#include "rak3172_defs.h"
+#include "rak3172_lorawan_uplink.h"
+
+/** @brief Size of the fragment header in bytes (message ID, fragment index, fragment count).
+ */
+#define RAK3172_FRAGMENT_HEADER_SIZE                            3
+
+/** @brief Maximum number of fragments of a message.
+ */
+#define RAK3172_FRAGMENT_MAX_COUNT                              255
+
+/** @brief Reassembly object for fragmented downlinks.
+ */
+typedef struct
+{
+    uint8_t* p_Buffer;                                  /**< Pointer to message buffer. */
+    size_t Size;                                        /**< Size of the message buffer in bytes. */
+    size_t Length;                                      /**< Length of the reassembled message in bytes.
+                                                             NOTE: Only valid when the message is complete. */
+    uint8_t ID;                                         /**< ID of the current message.
+                                                             NOTE: Managed by the driver. */
+    uint8_t Count;                                      /**< Number of fragments of the current message. 0 when no message is active.
+                                                             NOTE: Managed by the driver. */
+    uint8_t Received;                                   /**< Number of received fragments of the current or the last complete message.
+                                                             NOTE: Managed by the driver. */
+    uint16_t FragmentSize;                              /**< Payload size of all fragments except the last one. 0 when unknown.
+                                                             NOTE: Managed by the driver. */
+    uint16_t LastSize;                                  /**< Payload size of the last fragment. 0 when unknown.
+                                                             NOTE: Managed by the driver. */
+    uint32_t Bitmap[(RAK3172_FRAGMENT_MAX_COUNT + 31) / 32];    /**< Received fragments.
+                                                                     NOTE: Managed by the driver. */
+    uint32_t Dropped;                                   /**< Number of incomplete messages which were replaced by a new message. */
+} RAK3172_Reassembly_t;
+
+/** @brief              Split a message into fragments which fit into the current data rate and queue them for the uplink sender task.
+ *                      Each fragment starts with a header of \ref RAK3172_FRAGMENT_HEADER_SIZE bytes.
+ *                      NOTE: The fragments fit into the most robust data rate of the band (DR0) when ADR is enabled, because the ADR
+ *                      can lower the data rate before the fragments are transmitted. Disable ADR to use the current data rate.
+ *                      NOTE: The fragments which were queued before an error remain in the queue.
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Buffer     Pointer to message
+ *  @param Length       Length of the message
+ *  @param Confirmed    (Optional) Set to #true to transmit confirmed fragments
+ *  @param Retries      (Optional) Number of confirmed payload retransmissions
+ *  @param on_Done      (Optional) Completion callback for each fragment
+ *  @param p_Arg        (Optional) User defined argument for the callback
+ *  @param p_Ticket     (Optional) Pointer to ticket of the last fragment
+ *  @param Timeout      (Optional) Time in milliseconds to wait for free space in the uplink queue for each fragment
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function or the message needs too many fragments
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ *                      RAK3172_ERR_BUSY when the uplink queue is full
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_TransmitFragmented(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, size_t Length, bool Confirmed = false, uint8_t Retries = 0,
+                                                   RAK3172_Uplink_Callback_t on_Done = NULL, void* p_Arg = NULL, RAK3172_Ticket_t* const p_Ticket = NULL, uint32_t Timeout = 0);
+
+/** @brief              Prepare a reassembly object.
+ *  @param p_Context    Pointer to reassembly object
+ *  @param p_Buffer     Pointer to message buffer
+ *  @param Size         Size of the message buffer in bytes
+ */
+void RAK3172_LoRaWAN_Reassembly_Init(RAK3172_Reassembly_t* const p_Context, uint8_t* const p_Buffer, size_t Size);
+
+/** @brief              Add a received fragment to the reassembly object. The fragments can be received in any order.
+ *                      A fragment with a new message ID replaces an incomplete message.
+ *  @param p_Context    Pointer to reassembly object
+ *  @param p_Fragment   Pointer to fragment with header
+ *  @param Length       Length of the fragment
+ *  @param p_Complete   Pointer to completion status. #true when all fragments of the message are received
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_RESPONSE when the fragment doesn´t match the current message
+ *                      RAK3172_ERR_NO_MEM when the message buffer is too small
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Reassemble(RAK3172_Reassembly_t* const p_Context, const uint8_t* const p_Fragment, size_t Length, bool* const p_Complete);
+
+/** @brief              Add a received downlink to the reassembly object.
+ *  @param p_Context    Pointer to reassembly object
+ *  @param Message      Received downlink
+ *  @param p_Complete   Pointer to completion status. #true when all fragments of the message are received
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_RESPONSE when the fragment doesn´t match the current message
+ *                      RAK3172_ERR_NO_MEM when the message buffer is too small
+ */
+inline __attribute__((always_inline)) RAK3172_Error_t RAK3172_LoRaWAN_Reassemble(RAK3172_Reassembly_t* const p_Context, const RAK3172_Rx_t& Message, bool* const p_Complete)
+{
+    return RAK3172_LoRaWAN_Reassemble(p_Context, Message.Payload, Message.Length, p_Complete);
+}
+
+#endif /* RAK3172_LORAWAN_FRAGMENT_H_ */
@@ -0,0 +1,114 @@
+ /*
+ * rak3172_lorawan_uplink.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 driver for ESP32.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LORAWAN_UPLINK_H_
+#define RAK3172_LORAWAN_UPLINK_H_
+
+#include "rak3172_defs.h"
+
+/** @brief Ticket to identify a queued uplink.
+ */
+typedef uint32_t RAK3172_Ticket_t;
+
+/** @brief          Completion callback for queued uplinks.
+ *                  NOTE: The callback is executed in the context of the sender task. Don´t block inside the callback!
+ *  @param Ticket   Ticket of the uplink
+ *  @param Error    Result of the transmission
+ *  @param Latency  Time between the submission and the completion of the uplink in milliseconds
+ *  @param p_Arg    User defined argument
+ */
+typedef void (*RAK3172_Uplink_Callback_t)(RAK3172_Ticket_t Ticket, RAK3172_Error_t Error, uint32_t Latency, void* p_Arg);
+
+/** @brief              Queue a LoRaWAN uplink for the sender task and return immediately.
+ *                      The sender task transmits the uplinks in order and repeats the transmission when the module is busy or when the transmission is restricted.
+ *                      NOTE: The sender task is created with the first call of this function.
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Buffer     Pointer to data buffer. The data are copied into the queue
+ *  @param Length       Length of buffer
+ *  @param Confirmed    (Optional) Set to #true to transmit a confirmed uplink
+ *  @param Retries      (Optional) Number of confirmed payload retransmissions
+ *  @param on_Done      (Optional) Completion callback
+ *  @param p_Arg        (Optional) User defined argument for the callback
+ *  @param p_Ticket     (Optional) Pointer to ticket of the uplink
+ *  @param Timeout      (Optional) Time in milliseconds to wait for free space in the uplink queue
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the interface is not initialized
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ *                      RAK3172_ERR_NO_MEM when the sender task Cannot be created
+ *                      RAK3172_ERR_BUSY when the uplink queue is full
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Submit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, bool Confirmed = false, uint8_t Retries = 0,
+                                       RAK3172_Uplink_Callback_t on_Done = NULL, void* p_Arg = NULL, RAK3172_Ticket_t* const p_Ticket = NULL, uint32_t Timeout = 0);
+
+#ifdef CONFIG_RAK3172_UPLINK_COALESCE
+    /** @brief          Add a record to the coalescing buffer. The records are transmitted as one unconfirmed uplink when the next record doesn´t fit into
+     *                  the maximum payload of the current data rate, when a record for another port is added, when the oldest record reaches the age
+     *                  deadline or when \ref RAK3172_LoRaWAN_Flush is called.
+     *                  Each record is stored with a leading length byte.
+     *  @param p_Device RAK3172 device object
+     *  @param Port     LoRaWAN port
+     *  @param p_Record Pointer to record
+     *  @param Length   Length of the record
+     *  @return         RAK3172_ERR_OK when successful
+     *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function or the record doesn´t fit into an uplink
+     *                  RAK3172_ERR_INVALID_STATE when the interface is not initialized
+     *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+     *                  RAK3172_ERR_NO_MEM when the sender task Cannot be created
+     *                  RAK3172_ERR_BUSY when the uplink queue is full. The record isn´t added
+     */
+    RAK3172_Error_t RAK3172_LoRaWAN_Coalesce(RAK3172_t& p_Device, uint8_t Port, const void* const p_Record, uint8_t Length);
+
+    /** @brief          Queue the records from the coalescing buffer for transmission.
+     *  @param p_Device RAK3172 device object
+     *  @return         RAK3172_ERR_OK when successful
+     *                  RAK3172_ERR_BUSY when the uplink queue is full
+     */
+    RAK3172_Error_t RAK3172_LoRaWAN_Flush(RAK3172_t& p_Device);
+
+    /** @brief          Get the average number of records in a coalesced uplink.
+     *  @param p_Device RAK3172 device object
+     *  @return         Packing ratio
+     */
+    inline __attribute__((always_inline)) float RAK3172_LoRaWAN_GetPackingRatio(const RAK3172_t& p_Device)
+    {
+        if(p_Device.Statistics.CoalescedFrames == 0)
+        {
+            return 0.0f;
+        }
+
+        return static_cast<float>(p_Device.Statistics.CoalescedRecords) / p_Device.Statistics.CoalescedFrames;
+    }
+#endif
+
+/** @brief          Get the number of pending uplinks.
+ *  @param p_Device RAK3172 device object
+ *  @return         Number of uplinks in the uplink queue
+ */
+uint32_t RAK3172_LoRaWAN_GetUplinkQueueDepth(const RAK3172_t& p_Device);
+
+/** @brief          Stop the sender task and drop all pending uplinks. The sender task finishes the current uplink and completes all
+ *                  pending uplinks with RAK3172_ERR_INVALID_STATE before it stops. The function returns when the sender task has stopped.
+ *                  NOTE: This function is called by "RAK3172_Deinit". Don´t call it from an uplink callback.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_LoRaWAN_Uplink_Deinit(RAK3172_t& p_Device);
+
+#endif /* RAK3172_LORAWAN_UPLINK_H_ */
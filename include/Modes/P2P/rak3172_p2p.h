@@ -20,6 +20,8 @@
 #ifndef RAK3172_P2P_H_
 #define RAK3172_P2P_H_
 
+#include <vector>
+
 #include "rak3172_defs.h"
 
 #ifdef CONFIG_RAK3172_USE_RUI3
@@ -35,6 +37,20 @@ inline __attribute__((always_inline)) bool RAK3172_P2P_isListening(RAK3172_t& p_
     return (p_Device.P2P.isRxTimeout == false);
 }
 
+/** @brief RAK3172 LoRa P2P configuration object.
+ */
+typedef struct
+{
+    uint32_t Frequency;                                 /**< Transmission frequency. */
+    RAK3172_PSF_t SF;                                   /**< Spreading factor. */
+    RAK3172_BW_t Bandwidth;                             /**< Transmission bandwidth. */
+    RAK3172_CR_t CodeRate;                              /**< Transmission coderate. */
+    uint16_t Preamble;                                  /**< Transmission preamble.
+                                                             NOTE: Value must be greater than 2 or 5 (when using RUI3)! */
+    uint8_t Power;                                      /**< Transmission power in dBm.
+                                                             NOTE: Only values between 5 and 22 are allowed! */
+} RAK3172_P2P_Config_t;
+
 /** @brief              Initialize the RAK3172 SoM in P2P mode.
  *                      NOTE: You must call RAK3172_Init first!
  *  @param p_Device     RAK3172 device object
@@ -53,6 +69,17 @@ inline __attribute__((always_inline)) bool RAK3172_P2P_isListening(RAK3172_t& p_
  */
 RAK3172_Error_t RAK3172_P2P_Init(RAK3172_t& p_Device, uint32_t Frequency, RAK3172_PSF_t SF, RAK3172_BW_t Bandwidth, RAK3172_CR_t CodeRate, uint16_t Preamble, uint8_t Power, uint32_t Timeout = 10);
 
+/** @brief              Apply a P2P configuration to the module.
+ *                      The current configuration is read from the module and only written when it differs.
+ *  @param p_Device     RAK3172 device object
+ *  @param Config       Desired P2P configuration
+ *  @param p_Changes    (Optional) Pointer to list of the written commands
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                      RAK3172_ERR_INVALID_MODE when the device is not in P2P mode
+ */
+RAK3172_Error_t RAK3172_P2P_Apply(RAK3172_t& p_Device, const RAK3172_P2P_Config_t& Config, std::vector<std::string>* const p_Changes = NULL);
+
 /** @brief          Read the P2P configuration from the device.
  *  @param p_Device RAK3172 device object
  *  @param p_Config Pointer to configuration string
@@ -191,6 +218,17 @@ RAK3172_Error_t RAK3172_P2P_GetPower(const RAK3172_t& p_Device, uint8_t* const p
  */
 RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const uint8_t* const p_Buffer, uint8_t Length);
 
+/** @brief              Start a LoRa P2P transmission with a payload from multiple data segments.
+ *                      The segments are encoded one after another into the transmit command without an intermediate buffer.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Segments   Pointer to data segments
+ *  @param Count        Number of data segments
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function or the payload is longer than 255 bytes
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as P2P device. Please call \ref RAK3172_P2P_Init first
+ */
+RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const RAK3172_Segment_t* const p_Segments, size_t Count);
+
 /** @brief              Receive a single P2P packet.
  *                      NOTE: This is a blocking fuction!
  *  @param p_Device     RAK3172 device object
@@ -42,6 +42,14 @@
     #include "Update/rak3172_ymodem.h"
 #endif
 
+#ifdef CONFIG_RAK3172_ASYNC_ENABLE
+    #include "rak3172_async.h"
+#endif
+
+#ifdef CONFIG_RAK3172_COMPRESSION
+    #include "rak3172_codec.h"
+#endif
+
 /** @brief  Get the version number of the RAK3172 library.
  *  @return Library version
  */
@@ -62,6 +70,21 @@ inline __attribute__((always_inline)) RAK3172_Baud_t RAK3172_GetBaud(const RAK31
     return p_Device.UART.Baudrate;
 }
 
+/** @brief          Invalidate the cached module parameters.
+ *                  NOTE: The cache is invalidated by the driver when the module is reset or the mode is changed.
+ *  @param p_Device RAK3172 device object
+ */
+inline __attribute__((always_inline)) void RAK3172_Cache_Invalidate(RAK3172_t& p_Device)
+{
+    p_Device.Cache.Valid = 0;
+}
+
+/** @brief          Get the payload of a received message as hex string.
+ *  @param p_Message Received message
+ *  @return         Hex encoded payload
+ */
+std::string RAK3172_Rx_GetPayload(const RAK3172_Rx_t& p_Message);
+
 /** @brief          Initialize the driver and the RAK3172 module.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -77,11 +100,17 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device);
 void RAK3172_Deinit(RAK3172_t& p_Device);
 
 /** @brief          Set the baudrate of the module.
+ *                  The line rate of the running driver is changed and the link is verified with the new baud rate.
+ *                  The driver returns to the old baud rate when the module does not answer. When the module doesn´t answer with
+ *                  the old baud rate too, the new baud rate is tried again and the module is switched back to the old baud rate.
  *  @param p_Device RAK3172 device object
  *  @param Baudrate Module baudrate
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
+ *                  RAK3172_ERR_FAIL when the module still uses the old baud rate
+ *                  RAK3172_ERR_TIMEOUT when the module does not answer to the baud rate command
+ *                  RAK3172_ERR_BAUDRATE_UNKNOWN when the module does not answer with the old or the new baud rate. A module reset is necessary
  */
 RAK3172_Error_t RAK3172_SetBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate);
 
@@ -93,6 +122,39 @@ RAK3172_Error_t RAK3172_SetBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate
  */
 RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device);
 
+/** @brief              Store the driver state in a snapshot and deinitialize the driver.
+ *                      NOTE: Use this function instead of "RAK3172_Deinit" before entering the deep sleep mode and place the snapshot in the RTC memory.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Snapshot   Pointer to snapshot object
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the device was not initialized before
+ */
+RAK3172_Error_t RAK3172_Suspend(RAK3172_t& p_Device, RAK3172_Snapshot_t* const p_Snapshot);
+
+/** @brief              Restore the driver from a snapshot without communicating with the module.
+ *                      NOTE: Call "RAK3172_Init" when this function fails.
+ *                      NOTE: The remaining off time of the duty cycle sub bands starts again with the wake up, because the sleep time isn´t known.
+ *  @param p_Device     RAK3172 device object
+ *  @param Snapshot     Snapshot object from "RAK3172_Suspend"
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when the snapshot is invalid or the echo mode of the module was not disabled
+ *                      RAK3172_ERR_INVALID_STATE when the serial interface Cannot initialized
+ */
+RAK3172_Error_t RAK3172_Resume(RAK3172_t& p_Device, const RAK3172_Snapshot_t& Snapshot);
+
+/** @brief          Wait until the module is able to process commands.
+ *                  The function returns as soon as the splash screen or an "OK" for a probe "AT" command is received.
+ *                  NOTE: The measured latency is stored in the statistics of the device object.
+ *  @param p_Device RAK3172 device object
+ *  @param Timeout  Timeout in milliseconds
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
+ *                  RAK3172_ERR_INVALID_RESPONSE when the module firmware does not match the driver
+ *                  RAK3172_ERR_TIMEOUT when the module is not ready before the timeout
+ */
+RAK3172_Error_t RAK3172_WaitReady(RAK3172_t& p_Device, uint32_t Timeout);
+
 /** @brief          Perform a factory reset of the device.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -128,9 +190,53 @@ RAK3172_Error_t RAK3172_SoftReset(RAK3172_t& p_Device, uint32_t Timeout = 10);
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_FAIL when an event happens, when the status is not "OK" or when the device is busy
  *                  RAK3172_ERR_TIMEOUT when a receive timeout occurs
+ *                  NOTE: The function is thread safe. Concurrent callers wait until the active command is complete.
  */
 RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Command, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
 
+/** @brief          Transmit an AT command with a data block to the RAK3172 module.
+ *                  The data are hex encoded in small chunks directly into the UART driver and appended to the command.
+ *  @param p_Device RAK3172 device object
+ *  @param Command  RAK3172 command (i. e. "AT+SEND=1:")
+ *  @param p_Data   Pointer to data block
+ *  @param Length   Length of the data block
+ *  @param p_Value  (Optional) Pointer to returned value.
+ *  @param p_Status (Optional) Pointer to status string
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                  RAK3172_ERR_FAIL when an event happens, when the status is not "OK" or when the device is busy
+ *                  RAK3172_ERR_TIMEOUT when a receive timeout occurs
+ */
+RAK3172_Error_t RAK3172_SendCommandHex(const RAK3172_t& p_Device, const std::string& Command, const uint8_t* const p_Data, size_t Length, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
+
+/** @brief              Transmit an AT command with multiple data segments to the RAK3172 module.
+ *                      The segments are hex encoded one after another directly into the UART driver and appended to the command.
+ *  @param p_Device     RAK3172 device object
+ *  @param Command      RAK3172 command (i. e. "AT+SEND=1:")
+ *  @param p_Segments   Pointer to data segments
+ *  @param Count        Number of data segments
+ *  @param p_Value      (Optional) Pointer to returned value.
+ *  @param p_Status     (Optional) Pointer to status string
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_FAIL when an event happens, when the status is not "OK" or when the device is busy
+ *                      RAK3172_ERR_TIMEOUT when a receive timeout occurs
+ */
+RAK3172_Error_t RAK3172_SendCommandHex(const RAK3172_t& p_Device, const std::string& Command, const RAK3172_Segment_t* const p_Segments, size_t Count, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
+
+/** @brief          Transmit a list of AT commands to the RAK3172 module without waiting for each response.
+ *                  The responses are matched in order and the result of each command is stored in the command object.
+ *                  NOTE: Only commands which answer with an optional value and a status line are supported.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Items  Pointer to command objects
+ *  @param Count    Number of command objects
+ *  @return         RAK3172_ERR_OK when all commands are successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                  RAK3172_ERR_INVALID_STATE when the interface is not initialized
+ *                  Error code of the first failed command otherwise
+ */
+RAK3172_Error_t RAK3172_SendBatch(const RAK3172_t& p_Device, RAK3172_BatchItem_t* const p_Items, size_t Count);
+
 /** @brief              Get the firmware version of the RAK3172 module.
  *  @param p_Device     RAK3172 device object
  *  @param p_Version    Pointer to firmware version string
@@ -150,11 +256,16 @@ RAK3172_Error_t RAK3172_GetFWVersion(const RAK3172_t& p_Device, std::string* con
 RAK3172_Error_t RAK3172_GetSerialNumber(const RAK3172_t& p_Device, std::string* const p_Serial);
 
 /** @brief          Set the current operating mode for the module.
+ *                  The function returns as soon as the module reports the new mode.
+ *                  NOTE: The duration of the switch is stored in the statistics of the device object.
  *  @param p_Device RAK3172 device object
  *  @param Mode     RAK3172 operating mode
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
+ *                  RAK3172_ERR_FAIL when the module rejects the command
+ *                  RAK3172_ERR_INVALID_RESPONSE when the module reports a different mode
+ *                  RAK3172_ERR_TIMEOUT when the module does not report the new mode
  */
 RAK3172_Error_t RAK3172_SetMode(RAK3172_t& p_Device, RAK3172_Mode_t Mode);
 
@@ -0,0 +1,73 @@
+ /*
+ * rak3172_async.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 asynchronous command interface.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_ASYNC_H_
+#define RAK3172_ASYNC_H_
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+
+#include "rak3172_defs.h"
+
+/** @brief          Completion callback for asynchronous commands.
+ *                  NOTE: The callback is executed in the context of the command worker. Don´t block inside the callback!
+ *  @param Error    Result of the command
+ *  @param Value    Value returned by the module. Empty when no value was requested
+ *  @param Status   Status string returned by the module
+ *  @param p_Arg    User defined argument
+ */
+typedef void (*RAK3172_Async_Callback_t)(RAK3172_Error_t Error, const std::string& Value, const std::string& Status, void* p_Arg);
+
+/** @brief RAK3172 completion object for asynchronous commands. Unused completion methods must be set to NULL.
+ */
+typedef struct
+{
+    RAK3172_Async_Callback_t on_Done;                   /**< Function called when the command is complete. */
+    void* p_Arg;                                        /**< User defined argument for the callback. */
+    TaskHandle_t Task;                                  /**< Task notified when the command is complete.
+                                                             NOTE: The notification value contains the error code. */
+    EventGroupHandle_t EventGroup;                      /**< Event group used to signal the completion. */
+    EventBits_t OkBits;                                 /**< Event bits set when the command is successful. */
+    EventBits_t FailBits;                               /**< Event bits set when the command has failed. */
+} RAK3172_Async_Completion_t;
+
+/** @brief              Queue an AT command for the command worker and return immediately.
+ *                      NOTE: The worker is created with the first call of this function.
+ *  @param p_Device     RAK3172 device object
+ *  @param Command      RAK3172 command
+ *  @param hasValue     #true when the command returns a value line
+ *  @param Completion   Completion object
+ *  @param Timeout      (Optional) Time in milliseconds to wait for free space in the command queue
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the interface is not initialized
+ *                      RAK3172_ERR_NO_MEM when the worker Cannot be created
+ *                      RAK3172_ERR_BUSY when the command queue is full
+ */
+RAK3172_Error_t RAK3172_SendCommandAsync(RAK3172_t& p_Device, const std::string& Command, bool hasValue, const RAK3172_Async_Completion_t& Completion, uint32_t Timeout = 0);
+
+/** @brief          Stop the command worker. The worker finishes the current command and completes all pending commands
+ *                  with RAK3172_ERR_INVALID_STATE before it stops. The function returns when the worker has stopped.
+ *                  NOTE: This function is called by "RAK3172_Deinit". Don´t call it from a completion callback.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_Async_Deinit(RAK3172_t& p_Device);
+
+#endif /* RAK3172_ASYNC_H_ */
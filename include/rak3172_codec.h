@@ -0,0 +1,82 @@
+ /*
+ * rak3172_codec.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 payload compression.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_CODEC_H_
+#define RAK3172_CODEC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rak3172_defs.h"
+
+/** @brief Size of the codec header in bytes. Each payload starts with the ID of the codec.
+ */
+#define RAK3172_CODEC_HEADER_SIZE                               1
+
+/** @brief Codec IDs of the built-in codecs. The IDs 0x80 - 0xFF can be used for custom codecs.
+ */
+#define RAK3172_CODEC_ID_RAW                                    0x00
+#define RAK3172_CODEC_ID_LZ                                     0x01
+#define RAK3172_CODEC_ID_DELTA16                                0x02
+
+/** @brief LZ codec with a 256 byte window.
+ *         Format: A flag byte is followed by up to 8 items. A set flag bit (LSB first) marks a match with one byte (offset - 1)
+ *         and one byte (length - 3). A cleared flag bit marks a literal byte.
+ */
+extern const RAK3172_Codec_t RAK3172_Codec_LZ;
+
+/** @brief Delta codec for series of 16 bit little endian values.
+ *         Format: The difference to the previous value (starting with 0) is stored as zigzag encoded LEB128 varint.
+ */
+extern const RAK3172_Codec_t RAK3172_Codec_Delta16;
+
+/** @brief          Compress a payload and add the codec header. Uncompressible payloads are stored with the header #RAK3172_CODEC_ID_RAW.
+ *  @param p_Codec  Pointer to codec object
+ *  @param p_Input  Pointer to payload
+ *  @param Length   Length of the payload
+ *  @param p_Output Pointer to output buffer
+ *  @param Size     Size of the output buffer
+ *  @return         Length of the output data
+ *                  0 when the payload doesn´t fit into the output buffer
+ */
+size_t RAK3172_Codec_Encode(const RAK3172_Codec_t* const p_Codec, const uint8_t* p_Input, size_t Length, uint8_t* p_Output, size_t Size);
+
+/** @brief              Compress multiple data segments as one payload and add the codec header.
+ *                      NOTE: Multiple segments are copied into a buffer with #CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE bytes on the stack first.
+ *  @param p_Codec      Pointer to codec object
+ *  @param p_Segments   Pointer to data segments
+ *  @param Count        Number of data segments
+ *  @param p_Output     Pointer to output buffer
+ *  @param Size         Size of the output buffer
+ *  @return             Length of the output data
+ *                      0 when the payload doesn´t fit into the output buffer
+ */
+size_t RAK3172_Codec_Encode(const RAK3172_Codec_t* const p_Codec, const RAK3172_Segment_t* const p_Segments, size_t Count, uint8_t* p_Output, size_t Size);
+
+/** @brief          Set the codec for the transmit functions.
+ *                  NOTE: The codec object must be valid as long as it is used by the driver.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Codec  Pointer to codec object. Set to NULL to transmit the payload without codec header
+ */
+inline __attribute__((always_inline)) void RAK3172_SetCodec(RAK3172_t& p_Device, const RAK3172_Codec_t* const p_Codec)
+{
+    p_Device.Internal.Codec = p_Codec;
+}
+
+#endif /* RAK3172_CODEC_H_ */
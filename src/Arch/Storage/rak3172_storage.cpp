@@ -0,0 +1,92 @@
+ /*
+ * rak3172_storage.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Persistent storage wrapper for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <nvs.h>
+
+#include "rak3172_storage.h"
+
+/** @brief NVS namespace used by the driver.
+ */
+#define RAK3172_STORAGE_NAMESPACE                   "rak3172"
+
+RAK3172_Error_t RAK3172_Storage_Read(const char* p_Key, uint32_t* p_Value)
+{
+    esp_err_t Error;
+    nvs_handle_t Handle;
+
+    if((p_Key == NULL) || (p_Value == NULL))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    if(nvs_open(RAK3172_STORAGE_NAMESPACE, NVS_READONLY, &Handle) != ESP_OK)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    Error = nvs_get_u32(Handle, p_Key, p_Value);
+    nvs_close(Handle);
+
+    if(Error != ESP_OK)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_Storage_Write(const char* p_Key, uint32_t Value)
+{
+    uint32_t Stored;
+    esp_err_t Error;
+    nvs_handle_t Handle;
+
+    if(p_Key == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    if(nvs_open(RAK3172_STORAGE_NAMESPACE, NVS_READWRITE, &Handle) != ESP_OK)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    // Save flash cycles when the value is already stored.
+    if((nvs_get_u32(Handle, p_Key, &Stored) == ESP_OK) && (Stored == Value))
+    {
+        nvs_close(Handle);
+
+        return RAK3172_ERR_OK;
+    }
+
+    Error = nvs_set_u32(Handle, p_Key, Value);
+    if(Error == ESP_OK)
+    {
+        Error = nvs_commit(Handle);
+    }
+
+    nvs_close(Handle);
+
+    if(Error != ESP_OK)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    return RAK3172_ERR_OK;
+}
@@ -0,0 +1,55 @@
+ /*
+ * rak3172_storage.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Persistent storage wrapper for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_STORAGE_H_
+#define RAK3172_STORAGE_H_
+
+#include <stdint.h>
+
+#include "rak3172_errors.h"
+
+/** @brief Storage key for the module baud rate.
+ */
+#define RAK3172_STORAGE_KEY_BAUDRATE                "baud"
+
+/** @brief Storage key for the last successful LoRaWAN sub band.
+ */
+#define RAK3172_STORAGE_KEY_SUB_BAND                "subband"
+
+/** @brief          Read a value from the persistent storage.
+ *                  NOTE: The NVS must be initialized by the application.
+ *  @param p_Key    Storage key
+ *  @param p_Value  Pointer to value
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                  RAK3172_ERR_INVALID_STATE when the storage can not be opened or when the key does not exist
+ */
+RAK3172_Error_t RAK3172_Storage_Read(const char* p_Key, uint32_t* p_Value);
+
+/** @brief          Write a value into the persistent storage. The value is only written when it differs from the stored value.
+ *                  NOTE: The NVS must be initialized by the application.
+ *  @param p_Key    Storage key
+ *  @param Value    Value
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                  RAK3172_ERR_INVALID_STATE when the storage can not be opened or written
+ */
+RAK3172_Error_t RAK3172_Storage_Write(const char* p_Key, uint32_t Value);
+
+#endif /* RAK3172_STORAGE_H_ */
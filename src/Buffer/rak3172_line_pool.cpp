@@ -0,0 +1,137 @@
+ /*
+ * rak3172_line_pool.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Preallocated line pool for the RAK3172 receive task.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <stdlib.h>
+
+#include "rak3172_line_pool.h"
+
+RAK3172_Error_t RAK3172_LinePool_Init(RAK3172_t& p_Device)
+{
+    p_Device.Internal.LinePool = (RAK3172_Line_t*)malloc(CONFIG_RAK3172_UART_LINE_POOL_SIZE * sizeof(RAK3172_Line_t));
+    if(p_Device.Internal.LinePool == NULL)
+    {
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    p_Device.Internal.FreeQueue = xQueueCreate(CONFIG_RAK3172_UART_LINE_POOL_SIZE, sizeof(uint8_t));
+    if(p_Device.Internal.FreeQueue == NULL)
+    {
+        goto RAK3172_LinePool_Init_Error_1;
+    }
+
+    // The message queue must be able to hold all slots, so a line taken from the pool can always be queued.
+    p_Device.Internal.MessageQueue = xQueueCreate(CONFIG_RAK3172_UART_LINE_POOL_SIZE, sizeof(uint8_t));
+    if(p_Device.Internal.MessageQueue == NULL)
+    {
+        goto RAK3172_LinePool_Init_Error_2;
+    }
+
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UART_LINE_POOL_SIZE; i++)
+    {
+        xQueueSend(p_Device.Internal.FreeQueue, &i, 0);
+    }
+
+    return RAK3172_ERR_OK;
+
+RAK3172_LinePool_Init_Error_2:
+    vQueueDelete(p_Device.Internal.FreeQueue);
+    p_Device.Internal.FreeQueue = NULL;
+
+RAK3172_LinePool_Init_Error_1:
+    free(p_Device.Internal.LinePool);
+    p_Device.Internal.LinePool = NULL;
+
+    return RAK3172_ERR_NO_MEM;
+}
+
+void RAK3172_LinePool_Deinit(RAK3172_t& p_Device)
+{
+    if(p_Device.Internal.MessageQueue != NULL)
+    {
+        vQueueDelete(p_Device.Internal.MessageQueue);
+        p_Device.Internal.MessageQueue = NULL;
+    }
+
+    if(p_Device.Internal.FreeQueue != NULL)
+    {
+        vQueueDelete(p_Device.Internal.FreeQueue);
+        p_Device.Internal.FreeQueue = NULL;
+    }
+
+    free(p_Device.Internal.LinePool);
+    p_Device.Internal.LinePool = NULL;
+}
+
+RAK3172_Line_t* RAK3172_LinePool_Take(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+
+    if(xQueueReceive(p_Device.Internal.FreeQueue, &Index, 0) != pdPASS)
+    {
+        return NULL;
+    }
+
+    return &p_Device.Internal.LinePool[Index];
+}
+
+void RAK3172_LinePool_Push(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line)
+{
+    uint8_t Index;
+
+    Index = static_cast<uint8_t>(p_Line - p_Device.Internal.LinePool);
+    if(xQueueSend(p_Device.Internal.MessageQueue, &Index, 0) != pdPASS)
+    {
+        RAK3172_LinePool_Release(p_Device, p_Line);
+    }
+}
+
+RAK3172_Line_t* RAK3172_LinePool_Receive(const RAK3172_t& p_Device, uint32_t Timeout)
+{
+    uint8_t Index;
+
+    if(xQueueReceive(p_Device.Internal.MessageQueue, &Index, Timeout / portTICK_PERIOD_MS) != pdPASS)
+    {
+        return NULL;
+    }
+
+    return &p_Device.Internal.LinePool[Index];
+}
+
+void RAK3172_LinePool_Release(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line)
+{
+    uint8_t Index;
+
+    if(p_Line == NULL)
+    {
+        return;
+    }
+
+    Index = static_cast<uint8_t>(p_Line - p_Device.Internal.LinePool);
+    xQueueSend(p_Device.Internal.FreeQueue, &Index, 0);
+}
+
+void RAK3172_LinePool_Flush(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+
+    while(xQueueReceive(p_Device.Internal.MessageQueue, &Index, 0) == pdPASS)
+    {
+        xQueueSend(p_Device.Internal.FreeQueue, &Index, 0);
+    }
+}
@@ -0,0 +1,70 @@
+ /*
+ * rak3172_line_pool.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Preallocated line pool for the RAK3172 receive task.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LINE_POOL_H_
+#define RAK3172_LINE_POOL_H_
+
+#include "rak3172_defs.h"
+
+/** @brief          Allocate the line pool and create the message queues of the device.
+ *                  NOTE: This is the only place where line buffers get allocated.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the pool or the queues Cannot be created
+ */
+RAK3172_Error_t RAK3172_LinePool_Init(RAK3172_t& p_Device);
+
+/** @brief          Release the line pool and the message queues of the device.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_LinePool_Deinit(RAK3172_t& p_Device);
+
+/** @brief          Take an unused line buffer from the pool.
+ *                  NOTE: This function doesn´t block and should only be called by the receive task.
+ *  @param p_Device RAK3172 device object
+ *  @return         Pointer to the line buffer or NULL when no line buffer is available
+ */
+RAK3172_Line_t* RAK3172_LinePool_Take(const RAK3172_t& p_Device);
+
+/** @brief          Pass a filled line buffer to the message queue.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Line   Pointer to line buffer
+ */
+void RAK3172_LinePool_Push(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line);
+
+/** @brief          Receive the next line from the message queue.
+ *                  NOTE: The line buffer must be returned with "RAK3172_LinePool_Release" after usage.
+ *  @param p_Device RAK3172 device object
+ *  @param Timeout  Timeout in milliseconds
+ *  @return         Pointer to the line buffer or NULL when a timeout occurs
+ */
+RAK3172_Line_t* RAK3172_LinePool_Receive(const RAK3172_t& p_Device, uint32_t Timeout);
+
+/** @brief          Return a line buffer to the pool.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Line   Pointer to line buffer
+ */
+void RAK3172_LinePool_Release(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line);
+
+/** @brief          Drop all queued lines and return the line buffers to the pool.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_LinePool_Flush(const RAK3172_t& p_Device);
+
+#endif /* RAK3172_LINE_POOL_H_ */
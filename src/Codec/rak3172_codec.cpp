@@ -0,0 +1,235 @@
+ /*
+ * rak3172_codec.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 payload compression.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_COMPRESSION
+
+#include <string.h>
+
+#include "rak3172.h"
+
+/** @brief Window size of the LZ codec in bytes.
+ */
+#define RAK3172_LZ_WINDOW                       256
+
+/** @brief Minimum and maximum match length of the LZ codec in bytes.
+ */
+#define RAK3172_LZ_MIN_MATCH                    3
+#define RAK3172_LZ_MAX_MATCH                    (RAK3172_LZ_MIN_MATCH + 255)
+
+/** @brief          LZ compression function.
+ *  @param p_Input  Pointer to uncompressed data
+ *  @param Length   Length of the uncompressed data
+ *  @param p_Output Pointer to output buffer
+ *  @param Size     Size of the output buffer
+ *  @param p_Arg    Unused
+ *  @return         Length of the compressed data
+ *                  0 when the data can not be compressed into the output buffer
+ */
+static size_t RAK3172_Codec_LZ_Encode(const uint8_t* p_Input, size_t Length, uint8_t* p_Output, size_t Size, void* p_Arg)
+{
+    size_t In = 0;
+    size_t Out = 0;
+    size_t Flags;
+    size_t Start;
+    size_t Match;
+    size_t BestLength;
+    size_t BestOffset;
+
+    while(In < Length)
+    {
+        if(Out >= Size)
+        {
+            return 0;
+        }
+
+        Flags = Out++;
+        p_Output[Flags] = 0;
+
+        for(uint8_t Bit = 0; (Bit < 8) && (In < Length); Bit++)
+        {
+            // Find the longest match in the window. Matches can overlap the current position.
+            BestLength = 0;
+            BestOffset = 0;
+            Start = (In > RAK3172_LZ_WINDOW) ? (In - RAK3172_LZ_WINDOW) : 0;
+            for(size_t i = Start; i < In; i++)
+            {
+                Match = 0;
+                while(((In + Match) < Length) && (Match < RAK3172_LZ_MAX_MATCH) && (p_Input[i + Match] == p_Input[In + Match]))
+                {
+                    Match++;
+                }
+
+                if(Match > BestLength)
+                {
+                    BestLength = Match;
+                    BestOffset = In - i;
+                }
+            }
+
+            if(BestLength >= RAK3172_LZ_MIN_MATCH)
+            {
+                if((Out + 2) > Size)
+                {
+                    return 0;
+                }
+
+                p_Output[Flags] |= (0x01 << Bit);
+                p_Output[Out++] = BestOffset - 1;
+                p_Output[Out++] = BestLength - RAK3172_LZ_MIN_MATCH;
+                In += BestLength;
+            }
+            else
+            {
+                if(Out >= Size)
+                {
+                    return 0;
+                }
+
+                p_Output[Out++] = p_Input[In++];
+            }
+        }
+    }
+
+    return Out;
+}
+
+/** @brief          Delta compression function for 16 bit values.
+ *  @param p_Input  Pointer to uncompressed data
+ *  @param Length   Length of the uncompressed data
+ *  @param p_Output Pointer to output buffer
+ *  @param Size     Size of the output buffer
+ *  @param p_Arg    Unused
+ *  @return         Length of the compressed data
+ *                  0 when the data can not be compressed into the output buffer
+ */
+static size_t RAK3172_Codec_Delta16_Encode(const uint8_t* p_Input, size_t Length, uint8_t* p_Output, size_t Size, void* p_Arg)
+{
+    size_t Out = 0;
+    int16_t Value;
+    int16_t Previous = 0;
+    int32_t Delta;
+    uint32_t ZigZag;
+
+    if(Length % 2)
+    {
+        return 0;
+    }
+
+    for(size_t i = 0; i < Length; i += 2)
+    {
+        Value = static_cast<int16_t>(p_Input[i] | (p_Input[i + 1] << 8));
+        Delta = static_cast<int32_t>(Value) - Previous;
+        Previous = Value;
+
+        // Map small negative and positive differences to small unsigned numbers.
+        ZigZag = (static_cast<uint32_t>(Delta) << 1) ^ static_cast<uint32_t>(Delta >> 31);
+
+        do
+        {
+            if(Out >= Size)
+            {
+                return 0;
+            }
+
+            p_Output[Out++] = (ZigZag & 0x7F) | ((ZigZag > 0x7F) ? 0x80 : 0x00);
+            ZigZag >>= 7;
+        } while(ZigZag > 0);
+    }
+
+    return Out;
+}
+
+const RAK3172_Codec_t RAK3172_Codec_LZ = {
+    .ID = RAK3172_CODEC_ID_LZ,
+    .Encode = RAK3172_Codec_LZ_Encode,
+    .p_Arg = NULL,
+};
+
+const RAK3172_Codec_t RAK3172_Codec_Delta16 = {
+    .ID = RAK3172_CODEC_ID_DELTA16,
+    .Encode = RAK3172_Codec_Delta16_Encode,
+    .p_Arg = NULL,
+};
+
+size_t RAK3172_Codec_Encode(const RAK3172_Codec_t* const p_Codec, const uint8_t* p_Input, size_t Length, uint8_t* p_Output, size_t Size)
+{
+    size_t Compressed = 0;
+
+    if((p_Input == NULL) || (p_Output == NULL) || (Size <= RAK3172_CODEC_HEADER_SIZE))
+    {
+        return 0;
+    }
+
+    // Only use the compressed data when it is shorter than the original data.
+    if((p_Codec != NULL) && (p_Codec->Encode != NULL) && (Length > 1))
+    {
+        Compressed = p_Codec->Encode(p_Input, Length, &p_Output[RAK3172_CODEC_HEADER_SIZE], (Size - RAK3172_CODEC_HEADER_SIZE) < (Length - 1) ? (Size - RAK3172_CODEC_HEADER_SIZE) : (Length - 1),
+                                     p_Codec->p_Arg);
+    }
+
+    if(Compressed > 0)
+    {
+        p_Output[0] = p_Codec->ID;
+
+        return Compressed + RAK3172_CODEC_HEADER_SIZE;
+    }
+
+    if((Length + RAK3172_CODEC_HEADER_SIZE) > Size)
+    {
+        return 0;
+    }
+
+    p_Output[0] = RAK3172_CODEC_ID_RAW;
+    memcpy(&p_Output[RAK3172_CODEC_HEADER_SIZE], p_Input, Length);
+
+    return Length + RAK3172_CODEC_HEADER_SIZE;
+}
+
+size_t RAK3172_Codec_Encode(const RAK3172_Codec_t* const p_Codec, const RAK3172_Segment_t* const p_Segments, size_t Count, uint8_t* p_Output, size_t Size)
+{
+    size_t Length = 0;
+    uint8_t Buffer[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+
+    if((p_Segments == NULL) || (Count == 0))
+    {
+        return 0;
+    }
+    else if(Count == 1)
+    {
+        return RAK3172_Codec_Encode(p_Codec, static_cast<const uint8_t*>(p_Segments[0].p_Data), p_Segments[0].Length, p_Output, Size);
+    }
+
+    // The codecs need continuous data.
+    for(size_t i = 0; i < Count; i++)
+    {
+        if((p_Segments[i].Length > (sizeof(Buffer) - Length)) || ((p_Segments[i].p_Data == NULL) && (p_Segments[i].Length > 0)))
+        {
+            return 0;
+        }
+
+        memcpy(&Buffer[Length], p_Segments[i].p_Data, p_Segments[i].Length);
+        Length += p_Segments[i].Length;
+    }
+
+    return RAK3172_Codec_Encode(p_Codec, Buffer, Length, p_Output, Size);
+}
+
+#endif
@@ -0,0 +1,43 @@
+ /*
+ * rak3172_hex.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Hex codec for the RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_HEX_H_
+#define RAK3172_HEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief          Decode a hex string into binary data.
+ *  @param p_Hex    Pointer to hex string
+ *  @param Length   Length of the hex string
+ *  @param p_Buffer Pointer to output buffer
+ *  @param Size     Size of the output buffer
+ *  @return         Number of decoded bytes. The decoding stops at the first invalid character or when the output buffer is full.
+ */
+size_t RAK3172_Hex_Decode(const char* p_Hex, size_t Length, uint8_t* p_Buffer, size_t Size);
+
+/** @brief          Encode binary data into a hex string.
+ *                  NOTE: The output buffer must be able to store 2 * Length characters. No string terminator is added.
+ *  @param p_Data   Pointer to binary data
+ *  @param Length   Length of the binary data
+ *  @param p_Hex    Pointer to output buffer
+ */
+void RAK3172_Hex_Encode(const uint8_t* p_Data, size_t Length, char* p_Hex);
+
+#endif /* RAK3172_HEX_H_ */
@@ -0,0 +1,225 @@
+ /*
+ * rak3172_async.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 asynchronous command interface.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_ASYNC_ENABLE
+
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "../Arch/Logging/rak3172_logging.h"
+
+/** @brief Command object for the command worker.
+ */
+typedef struct
+{
+    char Command[CONFIG_RAK3172_ASYNC_COMMAND_LENGTH + 1];
+    bool hasValue;
+    bool isStop;
+    RAK3172_Async_Completion_t Completion;
+} RAK3172_Async_Item_t;
+
+static const char* TAG = "RAK3172_Async";
+
+/** @brief          Report the result of a command with all completion methods of the command.
+ *  @param Item     Command object
+ *  @param Error    Result of the command
+ *  @param Value    Value returned by the module
+ *  @param Status   Status string returned by the module
+ */
+static void RAK3172_Async_Complete(const RAK3172_Async_Item_t& Item, RAK3172_Error_t Error, const std::string& Value, const std::string& Status)
+{
+    if(Item.Completion.on_Done != NULL)
+    {
+        Item.Completion.on_Done(Error, Value, Status, Item.Completion.p_Arg);
+    }
+
+    if(Item.Completion.Task != NULL)
+    {
+        xTaskNotify(Item.Completion.Task, static_cast<uint32_t>(Error), eSetValueWithOverwrite);
+    }
+
+    if(Item.Completion.EventGroup != NULL)
+    {
+        EventBits_t Bits = (Error == RAK3172_ERR_OK) ? Item.Completion.OkBits : Item.Completion.FailBits;
+
+        if(Bits != 0)
+        {
+            xEventGroupSetBits(Item.Completion.EventGroup, Bits);
+        }
+    }
+}
+
+/** @brief          Command worker. Executes the queued commands one after another until a stop request is received.
+ *  @param p_Arg    Pointer to RAK3172 device object
+ */
+static void RAK3172_Async_WorkerTask(void* p_Arg)
+{
+    RAK3172_t* Device = static_cast<RAK3172_t*>(p_Arg);
+
+    // The strings must be destroyed before the task deletes itself.
+    {
+        std::string Value;
+        std::string Status;
+        RAK3172_Async_Item_t Item;
+        RAK3172_Error_t Error;
+
+        while(true)
+        {
+            if(xQueueReceive(Device->Internal.AsyncQueue, &Item, portMAX_DELAY) != pdPASS)
+            {
+                continue;
+            }
+
+            if(Item.isStop)
+            {
+                break;
+            }
+
+            Value.clear();
+            Status.clear();
+            Error = RAK3172_SendCommand(*Device, Item.Command, Item.hasValue ? &Value : NULL, &Status);
+
+            RAK3172_LOGD(TAG, "Command '%s' finished with 0x%X", Item.Command, static_cast<int>(Error));
+
+            RAK3172_Async_Complete(Item, Error, Value, Status);
+        }
+
+        // Complete the pending commands without a transmission.
+        Value.clear();
+        Status.clear();
+        while(xQueueReceive(Device->Internal.AsyncQueue, &Item, 0) == pdPASS)
+        {
+            RAK3172_Async_Complete(Item, RAK3172_ERR_INVALID_STATE, Value, Status);
+        }
+    }
+
+    RAK3172_LOGD(TAG, "Command worker stopped.");
+
+    xEventGroupSetBits(Device->Internal.Events, RAK3172_EVENT_ASYNC_STOPPED);
+
+    vTaskDelete(NULL);
+}
+
+/** @brief          Create the command queue and the command worker.
+ *                  NOTE: Must be called with the device lock taken.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the worker Cannot be created
+ */
+static RAK3172_Error_t RAK3172_Async_Start(RAK3172_t& p_Device)
+{
+    p_Device.Internal.AsyncQueue = xQueueCreate(CONFIG_RAK3172_ASYNC_QUEUE_LENGTH, sizeof(RAK3172_Async_Item_t));
+    if(p_Device.Internal.AsyncQueue == NULL)
+    {
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    #ifdef CONFIG_RAK3172_TASK_CORE_USE_AFFINITY
+        xTaskCreatePinnedToCore(RAK3172_Async_WorkerTask, "RAK3172-Async", CONFIG_RAK3172_ASYNC_STACK_SIZE, &p_Device, CONFIG_RAK3172_ASYNC_PRIO, &p_Device.Internal.AsyncHandle, CONFIG_RAK3172_TASK_CORE);
+    #else
+        xTaskCreate(RAK3172_Async_WorkerTask, "RAK3172-Async", CONFIG_RAK3172_ASYNC_STACK_SIZE, &p_Device, CONFIG_RAK3172_ASYNC_PRIO, &p_Device.Internal.AsyncHandle);
+    #endif
+
+    if(p_Device.Internal.AsyncHandle == NULL)
+    {
+        vQueueDelete(p_Device.Internal.AsyncQueue);
+        p_Device.Internal.AsyncQueue = NULL;
+
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    RAK3172_LOGD(TAG, "Command worker started.");
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_SendCommandAsync(RAK3172_t& p_Device, const std::string& Command, bool hasValue, const RAK3172_Async_Completion_t& Completion, uint32_t Timeout)
+{
+    RAK3172_Async_Item_t Item;
+    RAK3172_Error_t Error = RAK3172_ERR_OK;
+
+    if(Command.length() > CONFIG_RAK3172_ASYNC_COMMAND_LENGTH)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    if(p_Device.Internal.AsyncQueue == NULL)
+    {
+        xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+
+        // Check again, because another task can start the worker while this task waits for the lock.
+        if(p_Device.Internal.AsyncQueue == NULL)
+        {
+            Error = RAK3172_Async_Start(p_Device);
+        }
+
+        xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+        if(Error != RAK3172_ERR_OK)
+        {
+            return Error;
+        }
+    }
+
+    memcpy(Item.Command, Command.c_str(), Command.length() + 1);
+    Item.hasValue = hasValue;
+    Item.isStop = false;
+    Item.Completion = Completion;
+
+    if(xQueueSend(p_Device.Internal.AsyncQueue, &Item, Timeout / portTICK_PERIOD_MS) != pdPASS)
+    {
+        RAK3172_LOGW(TAG, "Command queue full!");
+
+        return RAK3172_ERR_BUSY;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_Async_Deinit(RAK3172_t& p_Device)
+{
+    RAK3172_Async_Item_t Item;
+
+    if(p_Device.Internal.AsyncQueue == NULL)
+    {
+        return;
+    }
+
+    // Let the worker finish the current command and stop itself. The stop request overtakes all pending commands.
+    memset(&Item, 0, sizeof(RAK3172_Async_Item_t));
+    Item.isStop = true;
+
+    xEventGroupClearBits(p_Device.Internal.Events, RAK3172_EVENT_ASYNC_STOPPED);
+    xQueueSendToFront(p_Device.Internal.AsyncQueue, &Item, portMAX_DELAY);
+    xEventGroupWaitBits(p_Device.Internal.Events, RAK3172_EVENT_ASYNC_STOPPED, pdTRUE, pdTRUE, portMAX_DELAY);
+
+    p_Device.Internal.AsyncHandle = NULL;
+
+    vQueueDelete(p_Device.Internal.AsyncQueue);
+    p_Device.Internal.AsyncQueue = NULL;
+}
+
+#endif
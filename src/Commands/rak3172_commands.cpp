@@ -17,77 +17,146 @@
  * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
  */
 
+#include <algorithm>
+#include <string.h>
+
 #include "rak3172.h"
 
+#include "../Buffer/rak3172_line_pool.h"
+#include "../Codec/rak3172_hex.h"
 #include "../Arch/Logging/rak3172_logging.h"
 
+/** @brief Number of bytes which are encoded at once when a data block is streamed to the module.
+ */
+#define RAK3172_STREAM_CHUNK_SIZE               32
+
+/** @brief Timeout for a mode switch in milliseconds. The module needs to restart when the mode is changed.
+ */
+#define RAK3172_SETMODE_TIMEOUT                 (10 * RAK3172_DEFAULT_WAIT_TIMEOUT)
+
+/** @brief States of the mode switch.
+ */
+typedef enum
+{
+    RAK_SETMODE_WAIT_STATUS,                    /**< Wait for the status of the "AT+NWM" command. */
+    RAK_SETMODE_WAIT_SPLASH,                    /**< Wait for the splash screen with the new mode. */
+    RAK_SETMODE_DONE,                           /**< The mode is confirmed by the module. */
+} RAK3172_SetMode_State_t;
+
 static const char* TAG = "RAK3172";
 
-RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Command, std::string* const p_Value, std::string* const p_Status)
+/** @brief              Transmit a command with an optional hex encoded data block and receive the response.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Command    Pointer to command
+ *  @param Length       Length of the command
+ *  @param p_Segments   (Optional) Pointer to data segments which should be appended as hex string
+ *  @param Count        Number of data segments
+ *  @param p_Value      (Optional) Pointer to returned value
+ *  @param p_Status     (Optional) Pointer to status string
+ *  @return             RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t RAK3172_Transmit(const RAK3172_t& p_Device, const char* p_Command, size_t Length, const RAK3172_Segment_t* p_Segments, size_t Count, std::string* const p_Value, std::string* const p_Status)
 {
-    std::string* Response = NULL;
+    RAK3172_Line_t* Response = NULL;
     RAK3172_Error_t Error = RAK3172_ERR_OK;
 
+    if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    // Serialize the access to the module. Tasks wait here instead of failing with a busy error.
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+
     if(p_Device.Internal.isBusy)
     {
         RAK3172_LOGE(TAG, "Device busy!");
 
-        return RAK3172_ERR_BUSY;
-    }
-    else if(p_Device.Internal.isInitialized == false)
-    {
-        return RAK3172_ERR_INVALID_STATE;
+        Error = RAK3172_ERR_BUSY;
+        goto RAK3172_SendCommand_Exit;
     }
 
     // Clear the queue and drop all items.
-    xQueueReset(p_Device.Internal.MessageQueue);
+    RAK3172_LinePool_Flush(p_Device);
 
     // Transmit the command.
-    RAK3172_LOGI(TAG, "Transmit command: %s", Command.c_str());
-    uart_write_bytes(p_Device.UART.Interface, static_cast<const char*>(Command.c_str()), Command.length());
+    RAK3172_LOGI(TAG, "Transmit command: %.*s", static_cast<int>(Length), p_Command);
+    uart_write_bytes(p_Device.UART.Interface, p_Command, Length);
+
+    // Encode the data in small chunks directly into the UART driver. So the memory usage doesn´t depend on the data length.
+    for(size_t j = 0; j < Count; j++)
+    {
+        char Chunk[2 * RAK3172_STREAM_CHUNK_SIZE];
+        const uint8_t* Data = static_cast<const uint8_t*>(p_Segments[j].p_Data);
+
+        RAK3172_LOGI(TAG, "     Stream %u bytes", static_cast<unsigned int>(p_Segments[j].Length));
+
+        for(size_t i = 0; i < p_Segments[j].Length; i += RAK3172_STREAM_CHUNK_SIZE)
+        {
+            size_t Bytes;
+
+            Bytes = std::min(static_cast<size_t>(RAK3172_STREAM_CHUNK_SIZE), p_Segments[j].Length - i);
+            RAK3172_Hex_Encode(&Data[i], Bytes, Chunk);
+            uart_write_bytes(p_Device.UART.Interface, Chunk, 2 * Bytes);
+        }
+    }
+
     uart_write_bytes(p_Device.UART.Interface, "\r\n", 2);
 
     // Copy the value if needed.
     if(p_Value != NULL)
     {
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+        const char* Value;
+
+        Response = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+        if(Response == NULL)
         {
-            return RAK3172_ERR_TIMEOUT;
+            Error = RAK3172_ERR_TIMEOUT;
+            goto RAK3172_SendCommand_Exit;
         }
 
+        Value = Response->Data;
+
         #ifdef CONFIG_RAK3172_USE_RUI3
             // Remove the command from the response.
-            size_t Index;
+            const char* Index;
 
-            Index = Response->find("=");
-            *Response = Response->substr(Index + 1);
+            Index = strchr(Response->Data, '=');
+            if(Index != NULL)
+            {
+                Value = Index + 1;
+            }
         #endif
 
-        *p_Value = *Response;
-        delete Response;
+        p_Value->assign(Value);
+        RAK3172_LinePool_Release(p_Device, Response);
 
         RAK3172_LOGI(TAG, "     Value: %s", p_Value->c_str());
     }
 
     #ifndef CONFIG_RAK3172_USE_RUI3
         // Receive the line feed before the status.
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+        Response = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+        if(Response == NULL)
         {
-            return RAK3172_ERR_TIMEOUT;
+            Error = RAK3172_ERR_TIMEOUT;
+            goto RAK3172_SendCommand_Exit;
         }
-        delete Response;
+        RAK3172_LinePool_Release(p_Device, Response);
     #endif
 
     // Receive the trailing status code.
-    if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+    Response = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+    if(Response == NULL)
     {
-        return RAK3172_ERR_TIMEOUT;
+        Error = RAK3172_ERR_TIMEOUT;
+        goto RAK3172_SendCommand_Exit;
     }
 
-    RAK3172_LOGI(TAG, "     Status: %s", Response->c_str());
+    RAK3172_LOGI(TAG, "     Status: %s", Response->Data);
 
     // Transmission is without error when 'OK' as status code and when no event data are received.
-    if(Response->find("OK") == std::string::npos)
+    if(strstr(Response->Data, "OK") == NULL)
     {
         Error = RAK3172_ERR_FAIL;
     }
@@ -95,11 +164,172 @@ RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Comma
     // Copy the status string if needed.
     if(p_Status != NULL)
     {
-        *p_Status = *Response;
+        p_Status->assign(Response->Data, Response->Length);
     }
     RAK3172_LOGD(TAG, "    Error: 0x%X", static_cast<int>(Error));
 
-    delete Response;
+    RAK3172_LinePool_Release(p_Device, Response);
+
+RAK3172_SendCommand_Exit:
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+    return Error;
+}
+
+RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Command, std::string* const p_Value, std::string* const p_Status)
+{
+    return RAK3172_Transmit(p_Device, Command.c_str(), Command.length(), NULL, 0, p_Value, p_Status);
+}
+
+RAK3172_Error_t RAK3172_SendCommandHex(const RAK3172_t& p_Device, const std::string& Command, const uint8_t* const p_Data, size_t Length, std::string* const p_Value, std::string* const p_Status)
+{
+    RAK3172_Segment_t Segment = {
+        .p_Data = p_Data,
+        .Length = Length,
+    };
+
+    if((p_Data == NULL) && (Length > 0))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    return RAK3172_Transmit(p_Device, Command.c_str(), Command.length(), &Segment, (p_Data != NULL) ? 1 : 0, p_Value, p_Status);
+}
+
+RAK3172_Error_t RAK3172_SendCommandHex(const RAK3172_t& p_Device, const std::string& Command, const RAK3172_Segment_t* const p_Segments, size_t Count, std::string* const p_Value, std::string* const p_Status)
+{
+    if((p_Segments == NULL) && (Count > 0))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        if((p_Segments[i].p_Data == NULL) && (p_Segments[i].Length > 0))
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
+    }
+
+    return RAK3172_Transmit(p_Device, Command.c_str(), Command.length(), p_Segments, Count, p_Value, p_Status);
+}
+
+RAK3172_Error_t RAK3172_SendBatch(const RAK3172_t& p_Device, RAK3172_BatchItem_t* const p_Items, size_t Count)
+{
+    size_t Sent = 0;
+    size_t Done = 0;
+    RAK3172_Line_t* Response;
+    RAK3172_Error_t Error = RAK3172_ERR_OK;
+
+    if((p_Items == NULL) || (Count == 0))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        p_Items[i].Error = RAK3172_ERR_TIMEOUT;
+    }
+
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+
+    if(p_Device.Internal.isBusy)
+    {
+        RAK3172_LOGE(TAG, "Device busy!");
+
+        xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+        return RAK3172_ERR_BUSY;
+    }
+
+    RAK3172_LinePool_Flush(p_Device);
+
+    while(Done < Count)
+    {
+        // Keep the window filled with commands. The responses are processed in the order of the commands.
+        while((Sent < Count) && ((Sent - Done) < CONFIG_RAK3172_UART_BATCH_WINDOW))
+        {
+            RAK3172_LOGI(TAG, "Transmit command: %s", p_Items[Sent].Command.c_str());
+            uart_write_bytes(p_Device.UART.Interface, static_cast<const char*>(p_Items[Sent].Command.c_str()), p_Items[Sent].Command.length());
+            uart_write_bytes(p_Device.UART.Interface, "\r\n", 2);
+            Sent++;
+        }
+
+        Response = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+        if(Response == NULL)
+        {
+            RAK3172_LOGE(TAG, "Timeout while waiting for the response of command %u!", static_cast<unsigned int>(Done));
+
+            break;
+        }
+
+        // Skip the empty lines between value and status.
+        if(Response->Length == 0)
+        {
+            RAK3172_LinePool_Release(p_Device, Response);
+
+            continue;
+        }
+
+        // Status lines close the current command. All other lines are values.
+        if((strcmp(Response->Data, "OK") == 0) || (strncmp(Response->Data, "AT_", 3) == 0) || (strstr(Response->Data, "ERROR") != NULL))
+        {
+            RAK3172_LOGI(TAG, "     Status: %s", Response->Data);
+
+            if(strstr(Response->Data, "OK") == NULL)
+            {
+                p_Items[Done].Error = RAK3172_ERR_FAIL;
+            }
+            else
+            {
+                p_Items[Done].Error = RAK3172_ERR_OK;
+            }
+
+            Done++;
+        }
+        else if(p_Items[Done].p_Value != NULL)
+        {
+            const char* Value;
+
+            Value = Response->Data;
+
+            #ifdef CONFIG_RAK3172_USE_RUI3
+                // Remove the command from the response.
+                const char* Index;
+
+                Index = strchr(Response->Data, '=');
+                if(Index != NULL)
+                {
+                    Value = Index + 1;
+                }
+            #endif
+
+            p_Items[Done].p_Value->assign(Value);
+
+            RAK3172_LOGI(TAG, "     Value: %s", p_Items[Done].p_Value->c_str());
+        }
+
+        RAK3172_LinePool_Release(p_Device, Response);
+    }
+
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        if(p_Items[i].Error != RAK3172_ERR_OK)
+        {
+            RAK3172_LOGE(TAG, "Command %s failed with 0x%X", p_Items[i].Command.c_str(), static_cast<int>(p_Items[i].Error));
+
+            if(Error == RAK3172_ERR_OK)
+            {
+                Error = p_Items[i].Error;
+            }
+        }
+    }
 
     return Error;
 }
@@ -127,8 +357,12 @@ RAK3172_Error_t RAK3172_GetSerialNumber(const RAK3172_t& p_Device, std::string*
 RAK3172_Error_t RAK3172_SetMode(RAK3172_t& p_Device, RAK3172_Mode_t Mode)
 {
     std::string Command;
-    std::string* Response;
-    RAK3172_Error_t Error = RAK3172_ERR_OK;
+    TickType_t Start;
+    uint32_t Elapsed;
+    RAK3172_Mode_t Confirmed;
+    RAK3172_Line_t* Response;
+    RAK3172_SetMode_State_t State;
+    RAK3172_Error_t Error = RAK3172_ERR_TIMEOUT;
 
     if(p_Device.Internal.isInitialized == false)
     {
@@ -139,65 +373,110 @@ RAK3172_Error_t RAK3172_SetMode(RAK3172_t& p_Device, RAK3172_Mode_t Mode)
         return RAK3172_ERR_OK;
     }
 
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
     p_Device.Internal.isBusy = true;
 
+    RAK3172_LinePool_Flush(p_Device);
+
     // Transmit the command.
     Command = "AT+NWM=" + std::to_string(static_cast<uint32_t>(Mode)) + "\r\n";
     uart_write_bytes(p_Device.UART.Interface, static_cast<const char*>(Command.c_str()), Command.length());
 
-    #ifndef CONFIG_RAK3172_USE_RUI3
-        // Receive the line feed before the status.
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+    // The module answers with "OK" when the mode is already active. Otherwise it restarts and reports the new mode in the splash screen.
+    State = RAK_SETMODE_WAIT_STATUS;
+    Start = xTaskGetTickCount();
+    while(State != RAK_SETMODE_DONE)
+    {
+        Elapsed = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
+        if(Elapsed >= RAK3172_SETMODE_TIMEOUT)
         {
-            Error = RAK3172_ERR_TIMEOUT;
+            RAK3172_LOGE(TAG, "Mode switch timeout!");
+
             goto RAK3172_SetMode_Exit;
         }
-        delete Response;
-    #endif
-    
 
-    // Receive the trailing status code.
-    if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, 3*RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
-    {
-        Error = RAK3172_ERR_TIMEOUT;
-        goto RAK3172_SetMode_Exit;
-    }
+        Response = RAK3172_LinePool_Receive(p_Device, RAK3172_SETMODE_TIMEOUT - Elapsed);
+        if(Response == NULL)
+        {
+            continue;
+        }
 
-    // 'OK' received, so the mode wasn´t change. Leave the function.
-    if(Response->find("OK") != std::string::npos)
-    {
-        delete Response;
+        RAK3172_LOGD(TAG, "Response: %s", Response->Data);
 
-        Error = RAK3172_ERR_OK;
-//RAK3172_LOGW(TAG, "RAK3172_SetMode: RAK3172_SetMode_Exit 3");
-        goto RAK3172_SetMode_Exit;
-    }
+        // Skip the empty lines from the firmware (i. e. the line feed before the status).
+        if(Response->Length == 0)
+        {
+            RAK3172_LinePool_Release(p_Device, Response);
 
-    // Otherwise the mode has changed and we have to receive the splash screen.
-    delete Response;
-    do
-    {
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, 3*RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == pdFAIL)
+            continue;
+        }
+
+        if(State == RAK_SETMODE_WAIT_STATUS)
         {
-            p_Device.Internal.isBusy = false;
+            if(strcmp(Response->Data, "OK") == 0)
+            {
+                Confirmed = Mode;
+                State = RAK_SETMODE_DONE;
+            }
+            else if((strncmp(Response->Data, "AT_", 3) == 0) || (strstr(Response->Data, "ERROR") != NULL))
+            {
+                RAK3172_LOGE(TAG, "Mode switch rejected: %s", Response->Data);
+
+                RAK3172_LinePool_Release(p_Device, Response);
+                Error = RAK3172_ERR_FAIL;
+
+                goto RAK3172_SetMode_Exit;
+            }
+            else
+            {
+                // The module is restarting. This line already belongs to the splash screen.
+                State = RAK_SETMODE_WAIT_SPLASH;
+            }
         }
-        else
+
+        if(State == RAK_SETMODE_WAIT_SPLASH)
         {
-            delete Response;
+            if(strstr(Response->Data, "LoRaWAN.") != NULL)
+            {
+                Confirmed = RAK_MODE_LORAWAN;
+                State = RAK_SETMODE_DONE;
+            }
+            else if(strstr(Response->Data, "LoRa P2P.") != NULL)
+            {
+                Confirmed = RAK_MODE_P2P;
+                State = RAK_SETMODE_DONE;
+            }
+            else if(strstr(Response->Data, "FSK") != NULL)
+            {
+                Confirmed = RAK_MODE_P2P_FSK;
+                State = RAK_SETMODE_DONE;
+            }
         }
-    } while(p_Device.Internal.isBusy);
 
-    // The mode was changed. Set the new mode.
-    p_Device.Mode = Mode;
+        RAK3172_LinePool_Release(p_Device, Response);
+    }
+
+    // The new mode is reported by the module. Set the new mode and drop the cached parameters from the old mode.
+    p_Device.Mode = Confirmed;
+    RAK3172_Cache_Invalidate(p_Device);
+
+    p_Device.Statistics.ModeSwitchLatency = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
+    RAK3172_LOGD(TAG, "Mode switch to %u finished after %lu ms", static_cast<uint32_t>(p_Device.Mode), static_cast<unsigned long>(p_Device.Statistics.ModeSwitchLatency));
+
+    if(Confirmed != Mode)
+    {
+        RAK3172_LOGE(TAG, "Module reports mode %u instead of %u!", static_cast<uint32_t>(Confirmed), static_cast<uint32_t>(Mode));
+
+        Error = RAK3172_ERR_INVALID_RESPONSE;
+    }
+    else
+    {
+        Error = RAK3172_ERR_OK;
+    }
 
 RAK3172_SetMode_Exit:
     p_Device.Internal.isBusy = false;
-
-//FIXME Hack. Code above is not quite good.
-vTaskDelay(1500 / portTICK_PERIOD_MS);
-RAK3172_LOGD(TAG, "RAK3172_SetMode: p_Device.Mode = %d", p_Device.Mode);
-RAK3172_GetMode(p_Device);
-RAK3172_LOGD(TAG, "RAK3172_SetMode: p_Device.Mode = %d", p_Device.Mode);
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
 
     return Error;
 }
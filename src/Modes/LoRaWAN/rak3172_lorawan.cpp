@@ -21,20 +21,257 @@
 
 #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
 
+#include <vector>
+#include <strings.h>
+
 #include "../../Arch/Logging/rak3172_logging.h"
 #include "../../Arch/Timer/rak3172_timer.h"
-
-#ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
-    #include "../../Arch/PwrMgmt/rak3172_pwrmgmt.h"
-#endif
+#include "../../Arch/Storage/rak3172_storage.h"
 
 #include "rak3172.h"
 
+#include "../../Codec/rak3172_hex.h"
+
+/** @brief Interval for the wait hook during a blocking join in milliseconds.
+ */
+#define RAK3172_JOIN_WAIT_INTERVAL              20
+
+/** @brief Interval for the wait hook while waiting for the confirmation of an uplink in milliseconds.
+ */
+#define RAK3172_CONFIRM_WAIT_INTERVAL           20
+
+/** @brief Upper limit for the time on air of a single uplink frame in milliseconds (51 bytes with SF12 / 125 kHz).
+ *         Used for the confirmation deadline when the frequency band isn´t cached.
+ */
+#define RAK3172_CONFIRM_AIRTIME_MAX             3000
+
+/** @brief RX2 delay in milliseconds which is used for the confirmation deadline when the module doesn´t report the delay.
+ */
+#define RAK3172_CONFIRM_RX2_DELAY_MAX           16000
+
+/** @brief Duration of the RX2 window with a received acknowledgement in milliseconds.
+ */
+#define RAK3172_CONFIRM_RX_WINDOW               2000
+
+/** @brief Maximum delay between the last receive window and a retransmission (ACK_TIMEOUT = 2 s +/- 1 s) in milliseconds.
+ */
+#define RAK3172_CONFIRM_ACK_TIMEOUT             3000
+
+/** @brief Additional time for the UART communication and the module processing of a confirmed uplink in milliseconds.
+ */
+#define RAK3172_CONFIRM_MARGIN                  1000
+
+/** @brief Length of the PHY payload of a join request in bytes (MHDR + JoinEUI + DevEUI + DevNonce + MIC).
+ */
+#define RAK3172_JOIN_REQUEST_LENGTH             23
+
+/** @brief Maximum wait time for the result of a single join attempt in seconds. The second join accept window opens after 6 seconds.
+ */
+#define RAK3172_JOIN_ATTEMPT_TIMEOUT            10
+
+/** @brief Join airtime in milliseconds which is allowed during the first hour (1 % duty cycle).
+ */
+#define RAK3172_JOIN_AIRTIME_BUDGET             36000
+
 static const char* TAG = "RAK3172_LoRaWAN";
 
+/** @brief          Check if a parameter can be served from the cache and update the cache statistics.
+ *  @param p_Device RAK3172 device object
+ *  @param Entry    Cache entry (see RAK3172_CACHE_*)
+ *  @param Refresh  #true to force a module request
+ *  @return         #true when the cached value is valid
+ */
+static bool RAK3172_LoRaWAN_CacheLookup(RAK3172_t& p_Device, uint32_t Entry, bool Refresh)
+{
+    if((Refresh == false) && (p_Device.Cache.Valid & Entry))
+    {
+        p_Device.Statistics.CacheHits++;
+
+        return true;
+    }
+
+    p_Device.Statistics.CacheMisses++;
+
+    return false;
+}
+
+/** @brief          Get the latest time for the confirmation result of a confirmed uplink.
+ *                  NOTE: The off time of the duty cycle between two attempts is only included when the duty cycle ledger is enabled.
+ *  @param p_Device RAK3172 device object
+ *  @param Length   Length of the application payload in bytes
+ *  @param Retries  Number of confirmed payload retransmissions
+ *  @return         Deadline in milliseconds after the module has accepted the uplink
+ */
+static uint32_t RAK3172_LoRaWAN_GetConfirmDeadline(RAK3172_t& p_Device, uint16_t Length, uint8_t Retries)
+{
+    uint32_t Airtime;
+    uint32_t Attempt;
+    uint32_t Period;
+    RAK3172_DataRate_t DR;
+    std::string Response;
+
+    // The RX2 delay only changes with a setter call or a join accept. Read it once and serve it from the cache afterwards.
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_RX2_DELAY, false) == false)
+    {
+        if(RAK3172_SendCommand(p_Device, "AT+RX2DL=?", &Response) == RAK3172_ERR_OK)
+        {
+            p_Device.Cache.RX2Delay = std::stoul(Response);
+
+            #ifdef CONFIG_RAK3172_USE_RUI3
+                p_Device.Cache.RX2Delay *= 1000;
+            #endif
+
+            p_Device.Cache.Valid |= RAK3172_CACHE_RX2_DELAY;
+        }
+        else
+        {
+            p_Device.Cache.RX2Delay = RAK3172_CONFIRM_RX2_DELAY_MAX;
+        }
+    }
+
+    // The ADR can lower the data rate during the retransmissions. Use the most robust data rate of the band when the ADR is enabled
+    // or when the ADR status isn´t cached.
+    Airtime = 0;
+    if(p_Device.Cache.Valid & RAK3172_CACHE_BAND)
+    {
+        DR = RAK_DR_0;
+        if(((p_Device.Cache.Valid & (RAK3172_CACHE_ADR | RAK3172_CACHE_DATARATE)) == (RAK3172_CACHE_ADR | RAK3172_CACHE_DATARATE)) && (p_Device.Cache.ADR == false))
+        {
+            DR = p_Device.Cache.DataRate;
+        }
+
+        Airtime = RAK3172_LoRaWAN_GetPayloadTimeOnAir(p_Device.Cache.Band, DR, Length);
+    }
+
+    if(Airtime == 0)
+    {
+        Airtime = ((Length + RAK3172_LORAWAN_FRAME_PAYLOAD_MAX - 1) / RAK3172_LORAWAN_FRAME_PAYLOAD_MAX) * RAK3172_CONFIRM_AIRTIME_MAX;
+    }
+
+    // Each attempt waits for both receive windows and the acknowledgement timeout before the next retransmission.
+    Attempt = Airtime + p_Device.Cache.RX2Delay + RAK3172_CONFIRM_RX_WINDOW + RAK3172_CONFIRM_ACK_TIMEOUT;
+
+    // The module delays a retransmission until the off time of the duty cycle has passed.
+    Period = Attempt;
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        if((p_Device.Cache.Valid & RAK3172_CACHE_BAND) && ((Airtime * RAK3172_LoRaWAN_DutyCycle_GetFactor(p_Device.Cache.Band)) > Attempt))
+        {
+            Period = Airtime * RAK3172_LoRaWAN_DutyCycle_GetFactor(p_Device.Cache.Band);
+        }
+    #endif
+
+    return (Retries * Period) + Attempt + RAK3172_CONFIRM_MARGIN;
+}
+
+/** @brief          Convert a key into a hex string.
+ *  @param p_Key    Pointer to key
+ *  @param Length   Key length in bytes
+ *  @return         Hex string
+ */
+static std::string RAK3172_LoRaWAN_KeyToString(const uint8_t* const p_Key, size_t Length)
+{
+    std::string Result(2 * Length, '0');
+
+    RAK3172_Hex_Encode(p_Key, Length, &Result[0]);
+
+    return Result;
+}
+
+/** @brief          Get the channel mask command for a sub band.
+ *  @param Band     Frequency band
+ *  @param SubBand  Sub band
+ *  @param p_Command Pointer to command string
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when the sub band is invalid for the frequency band
+ *                  RAK3172_ERR_FAIL when the frequency band doesn´t support sub bands
+ */
+static RAK3172_Error_t RAK3172_LoRaWAN_GetSubBandCommand(RAK3172_Band_t Band, RAK3172_SubBand_t SubBand, std::string* const p_Command)
+{
+    // The sub band can only be changed when using US915, AU915 or CN470 frequency band.
+    if((Band != RAK_BAND_US915) && (Band != RAK_BAND_AU915) && (Band != RAK_BAND_CN470))
+    {
+        return RAK3172_ERR_FAIL;
+    }
+    else if((SubBand > RAK_SUB_BAND_9) && (Band != RAK_BAND_CN470))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    if(SubBand == RAK_SUB_BAND_ALL)
+    {
+        *p_Command = "AT+MASK=0000";
+    }
+    else
+    {
+        char Temp[5];
+
+        sprintf(Temp, "%04X", 1 << (SubBand - 2));
+        *p_Command = "AT+MASK=" + std::string(Temp);
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+/** @brief          Convert a transmit power into the Tx power index of the frequency band.
+ *  @param Band     Frequency band
+ *  @param TxPwr    Transmit power in dBm
+ *  @return         Tx power index
+ */
+static uint8_t RAK3172_LoRaWAN_GetTxPwrIndex(RAK3172_Band_t Band, uint8_t TxPwr)
+{
+    uint8_t TxPwrIndex = 0;
+
+    RAK3172_LOGD(TAG, "Set Tx power to: %u dBm", TxPwr);
+
+    // For EU868 the maximum transmit power is +16 dB EIRP.
+    if(Band == RAK_BAND_EU868)
+    {
+        const uint8_t EIRP = 16;
+
+        if(TxPwr >= EIRP)
+        {
+            TxPwrIndex = 0;
+        }
+        else if(TxPwr < (EIRP - 14))
+        {
+            TxPwrIndex = 10;
+        }
+        else
+        {
+            TxPwrIndex = static_cast<uint8_t>((EIRP - TxPwr) / 2);
+        }
+    }
+    // For US915 the maximum transmit power is +30 dBm conducted power.
+    else if(Band == RAK_BAND_US915)
+    {
+        const uint8_t MaxPwr = 30;
+
+        if(TxPwr >= MaxPwr)
+        {
+            TxPwrIndex = 0;
+        }
+        else if(TxPwr < 10)
+        {
+            TxPwrIndex = 10;
+        }
+        else
+        {
+            TxPwrIndex = static_cast<uint8_t>((MaxPwr - TxPwr) / 2);
+        }
+    }
+    else
+    {
+        RAK3172_LOGE(TAG, "Tx power is not implemented for the selected frequency band!");
+    }
+
+    RAK3172_LOGD(TAG, "Set Tx power index: %u", TxPwrIndex);
+
+    return TxPwrIndex;
+}
+
 RAK3172_Error_t RAK3172_LoRaWAN_Init(RAK3172_t& p_Device, uint8_t TxPwr, RAK3172_JoinMode_t JoinMode, const uint8_t* const p_Key1, const uint8_t* const p_Key2, const uint8_t* const p_Key3, RAK3172_Class_t Class, RAK3172_Band_t Band, RAK3172_SubBand_t Subband, bool UseADR, uint32_t Timeout)
 {
-    std::string Command;
+    RAK3172_LoRaWAN_Config_t Config;
 
     if(((Class != RAK_CLASS_A) && (Class != RAK_CLASS_B) && (Class != RAK_CLASS_C)) || (p_Key1 == NULL) || (p_Key2 == NULL) || (p_Key3 == NULL))
     {
@@ -54,36 +291,137 @@ RAK3172_Error_t RAK3172_LoRaWAN_Init(RAK3172_t& p_Device, uint8_t TxPwr, RAK3172
 
     p_Device.Internal.isBusy = false;
 
-    Command = "AT+CLASS=";
-    Command += Class;
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, Command));
+    Config.Class = Class;
+    Config.Band = Band;
+    Config.SubBand = Subband;
+    Config.UseADR = UseADR;
+    Config.TxPwr = TxPwr;
+    Config.JoinMode = JoinMode;
+    Config.p_Key1 = p_Key1;
+    Config.p_Key2 = p_Key2;
+    Config.p_Key3 = p_Key3;
+
+    return RAK3172_LoRaWAN_Apply(p_Device, Config);
+}
 
-	RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetADR(p_Device, UseADR));
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetBand(p_Device, Band));
+RAK3172_Error_t RAK3172_LoRaWAN_Apply(RAK3172_t& p_Device, const RAK3172_LoRaWAN_Config_t& Config, std::vector<std::string>* const p_Changes)
+{
+    std::string Command;
+    std::vector<RAK3172_BatchItem_t> Desired;
+    std::vector<RAK3172_BatchItem_t> Queries;
+    std::vector<RAK3172_BatchItem_t> Writes;
+    std::vector<std::string> Values;
+    size_t BandIndex;
+    bool isBandChanged = false;
+    RAK3172_Error_t Error;
+    unsigned long Start;
+
+    if(((Config.Class != RAK_CLASS_A) && (Config.Class != RAK_CLASS_B) && (Config.Class != RAK_CLASS_C)) || (Config.p_Key1 == NULL) || (Config.p_Key2 == NULL) || (Config.p_Key3 == NULL))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+
+    Start = RAK3172_Timer_GetMilliseconds();
 
-    if(Subband != RAK_SUB_BAND_NONE)
+    // Collect the desired configuration.
+    Command = "AT+CLASS=";
+    Command += Config.Class;
+    Desired.push_back({Command, NULL, RAK3172_ERR_OK});
+    Desired.push_back({"AT+ADR=" + std::to_string(Config.UseADR), NULL, RAK3172_ERR_OK});
+    BandIndex = Desired.size();
+    Desired.push_back({"AT+BAND=" + std::to_string(static_cast<uint8_t>(Config.Band)), NULL, RAK3172_ERR_OK});
+
+    if(Config.SubBand != RAK_SUB_BAND_NONE)
     {
-        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetSubBand(p_Device, Subband))
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetSubBandCommand(Config.Band, Config.SubBand, &Command));
+        Desired.push_back({Command, NULL, RAK3172_ERR_OK});
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetTxPwr(p_Device, TxPwr));
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetJoinMode(p_Device, JoinMode));
+    Desired.push_back({"AT+TXP=" + std::to_string(RAK3172_LoRaWAN_GetTxPwrIndex(Config.Band, Config.TxPwr)), NULL, RAK3172_ERR_OK});
+    Desired.push_back({"AT+NJM=" + std::to_string(Config.JoinMode), NULL, RAK3172_ERR_OK});
 
-    p_Device.LoRaWAN.Join = JoinMode;
-    if(p_Device.LoRaWAN.Join == RAK_JOIN_OTAA)
+    if(Config.JoinMode == RAK_JOIN_OTAA)
     {
         RAK3172_LOGI(TAG, "Using OTAA mode");
 
-        return RAK3172_LoRaWAN_SetOTAAKeys(p_Device, p_Key1, p_Key2, p_Key3);
+        Desired.push_back({"AT+DEVEUI=" + RAK3172_LoRaWAN_KeyToString(Config.p_Key1, 8), NULL, RAK3172_ERR_OK});
+        Desired.push_back({"AT+APPEUI=" + RAK3172_LoRaWAN_KeyToString(Config.p_Key2, 8), NULL, RAK3172_ERR_OK});
+        Desired.push_back({"AT+APPKEY=" + RAK3172_LoRaWAN_KeyToString(Config.p_Key3, 16), NULL, RAK3172_ERR_OK});
     }
     else
     {
         RAK3172_LOGI(TAG, "Using ABP mode");
 
-        return RAK3172_LoRaWAN_SetABPKeys(p_Device, p_Key1, p_Key2, p_Key3);
+        Desired.push_back({"AT+APPSKEY=" + RAK3172_LoRaWAN_KeyToString(Config.p_Key1, 16), NULL, RAK3172_ERR_OK});
+        Desired.push_back({"AT+NWKSKEY=" + RAK3172_LoRaWAN_KeyToString(Config.p_Key2, 16), NULL, RAK3172_ERR_OK});
+        Desired.push_back({"AT+DEVADDR=" + RAK3172_LoRaWAN_KeyToString(Config.p_Key3, 4), NULL, RAK3172_ERR_OK});
+    }
+
+    // Read the current configuration with a single batch.
+    Values.resize(Desired.size());
+    for(size_t i = 0; i < Desired.size(); i++)
+    {
+        Queries.push_back({Desired[i].Command.substr(0, Desired[i].Command.find('=') + 1) + "?", &Values[i], RAK3172_ERR_OK});
+    }
+
+    Error = RAK3172_SendBatch(p_Device, Queries.data(), Queries.size());
+    if((Error == RAK3172_ERR_BUSY) || (Error == RAK3172_ERR_INVALID_STATE))
+    {
+        return Error;
+    }
+
+    // Only write the parameters which differ from the module state. Parameters which can not be read are always written.
+    // A band change resets the channel mask and the data rate of the module and changes the meaning of the power index.
+    // So all parameters after the band are written when the band is written, because the read values are outdated.
+    for(size_t i = 0; i < Desired.size(); i++)
+    {
+        const std::string Value = Desired[i].Command.substr(Desired[i].Command.find('=') + 1);
+
+        if(isBandChanged || (Queries[i].Error != RAK3172_ERR_OK) || (strcasecmp(Values[i].c_str(), Value.c_str()) != 0))
+        {
+            Writes.push_back(Desired[i]);
+
+            if(i == BandIndex)
+            {
+                isBandChanged = true;
+            }
+        }
     }
 
-    return RAK3172_ERR_INVALID_ARG;
+    if(p_Changes != NULL)
+    {
+        p_Changes->clear();
+        for(size_t i = 0; i < Writes.size(); i++)
+        {
+            p_Changes->push_back(Writes[i].Command);
+        }
+    }
+
+    if(Writes.size() > 0)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendBatch(p_Device, Writes.data(), Writes.size()));
+    }
+
+    p_Device.LoRaWAN.Join = Config.JoinMode;
+
+    p_Device.Cache.Band = Config.Band;
+    p_Device.Cache.ADR = Config.UseADR;
+    p_Device.Cache.JoinMode = Config.JoinMode;
+    p_Device.Cache.Valid |= RAK3172_CACHE_BAND | RAK3172_CACHE_ADR | RAK3172_CACHE_JOIN_MODE;
+    p_Device.Cache.Valid &= ~(RAK3172_CACHE_SUB_BAND | RAK3172_CACHE_DATARATE);
+    if(Config.SubBand != RAK_SUB_BAND_NONE)
+    {
+        p_Device.Cache.SubBand = Config.SubBand;
+        p_Device.Cache.Valid |= RAK3172_CACHE_SUB_BAND;
+    }
+
+    RAK3172_LOGI(TAG, "Configuration applied in %lu ms. %u of %u parameters changed", RAK3172_Timer_GetMilliseconds() - Start, static_cast<unsigned int>(Writes.size()), static_cast<unsigned int>(Desired.size()));
+
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(const RAK3172_t& p_Device, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY)
@@ -106,25 +444,13 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(const RAK3172_t& p_Device, const uin
     }
 
     // Copy the keys from the buffer into a string.
-    char Buffer[3];
-    for(uint8_t i = 0; i < 8; i++)
-    {
-        sprintf(Buffer, "%02X", p_APPEUI[i]);
-        AppEUIString += std::string(Buffer);
-
-        sprintf(Buffer, "%02X", p_DEVEUI[i]);
-        DevEUIString += std::string(Buffer);
-    }
-
-    for(uint8_t i = 0; i < 16; i++)
-    {
-        sprintf(Buffer, "%02X", p_APPKEY[i]);
-        AppKeyString += std::string(Buffer);
-    }
+    DevEUIString = RAK3172_LoRaWAN_KeyToString(p_DEVEUI, 8);
+    AppEUIString = RAK3172_LoRaWAN_KeyToString(p_APPEUI, 8);
+    AppKeyString = RAK3172_LoRaWAN_KeyToString(p_APPKEY, 16);
 
-    RAK3172_LOGD(TAG, "DEVEUI: %s - Size: %u", DevEUIString.c_str(), DevEUIString.length());
-    RAK3172_LOGD(TAG, "APPEUI: %s - Size: %u", AppEUIString.c_str(), AppEUIString.length());
-    RAK3172_LOGD(TAG, "APPKEY: %s - Size: %u", AppKeyString.c_str(), AppKeyString.length());
+    RAK3172_LOGD(TAG, "DEVEUI: %s - Size: %u", DevEUIString.c_str(), static_cast<unsigned int>(DevEUIString.length()));
+    RAK3172_LOGD(TAG, "APPEUI: %s - Size: %u", AppEUIString.c_str(), static_cast<unsigned int>(AppEUIString.length()));
+    RAK3172_LOGD(TAG, "APPKEY: %s - Size: %u", AppKeyString.c_str(), static_cast<unsigned int>(AppKeyString.length()));
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DEVEUI=" + DevEUIString));
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+APPEUI=" + AppEUIString));
@@ -151,25 +477,13 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
     }
 
     // Copy the keys from the buffer into a string.
-    char Buffer[3];
-    for(uint8_t i = 0; i < 16; i++)
-    {
-        sprintf(Buffer, "%02X", p_APPSKEY[i]);
-        AppSKEYString += std::string(Buffer);
-
-        sprintf(Buffer, "%02X", p_NWKSKEY[i]);
-        NwkSKEYString += std::string(Buffer);
-    }
-
-    for(uint8_t i = 0; i < 4; i++)
-    {
-        sprintf(Buffer, "%02X", p_DEVADDR[i]);
-        DevADDRString += std::string(Buffer);
-    }
+    AppSKEYString = RAK3172_LoRaWAN_KeyToString(p_APPSKEY, 16);
+    NwkSKEYString = RAK3172_LoRaWAN_KeyToString(p_NWKSKEY, 16);
+    DevADDRString = RAK3172_LoRaWAN_KeyToString(p_DEVADDR, 4);
 
-    RAK3172_LOGD(TAG, "APPSKEY: %s - Size: %u", AppSKEYString.c_str(), AppSKEYString.length());
-    RAK3172_LOGD(TAG, "NWKSKEY: %s - Size: %u", NwkSKEYString.c_str(), NwkSKEYString.length());
-    RAK3172_LOGD(TAG, "DEVADDR: %s - Size: %u", DevADDRString.c_str(), DevADDRString.length());
+    RAK3172_LOGD(TAG, "APPSKEY: %s - Size: %u", AppSKEYString.c_str(), static_cast<unsigned int>(AppSKEYString.length()));
+    RAK3172_LOGD(TAG, "NWKSKEY: %s - Size: %u", NwkSKEYString.c_str(), static_cast<unsigned int>(NwkSKEYString.length()));
+    RAK3172_LOGD(TAG, "DEVADDR: %s - Size: %u", DevADDRString.c_str(), static_cast<unsigned int>(DevADDRString.length()));
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+APPSKEY=" + AppSKEYString));
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NWKSKEY=" + NwkSKEYString));
@@ -178,118 +492,319 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
 
 RAK3172_Error_t RAK3172_LoRaWAN_StartJoin(RAK3172_t& p_Device, uint8_t Attempts, uint32_t Timeout, bool Block, bool EnableAutoJoin, uint8_t Interval, RAK3172_Wait_t on_Wait)
 {
-    #ifdef CONFIG_RAK3172_USE_RUI3
-        uint32_t TimeNow;
-    #endif
-
-    if(((Attempts == 0) && (Block == true)) || (Interval < 7))
+    if((Attempts == 0) && (Block == true))
     {
         return RAK3172_ERR_INVALID_ARG;
     }
-    else if(p_Device.Internal.isBusy)
+    else if(p_Device.LoRaWAN.isJoined)
     {
-        return RAK3172_ERR_BUSY;
+        return RAK3172_ERR_OK;
     }
-    else if(p_Device.LoRaWAN.isJoined)
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_StartJoinAsync(p_Device, Attempts, EnableAutoJoin, Interval));
+
+    if(Block == false)
     {
         return RAK3172_ERR_OK;
     }
+
+    return RAK3172_LoRaWAN_WaitJoin(p_Device, Timeout, on_Wait);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_StartJoinAsync(RAK3172_t& p_Device, uint8_t Attempts, bool EnableAutoJoin, uint8_t Interval)
+{
+    RAK3172_Error_t Error;
+
+    if(Interval < 7)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isBusy)
+    {
+        return RAK3172_ERR_BUSY;
+    }
     else if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
-    #ifndef CONFIG_RAK3172_USE_RUI3
-        else if(Block == false)
-        {
-            return RAK3172_ERR_INVALID_ARG;
-        }
-    #endif
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(EnableAutoJoin) + ":" + std::to_string(Interval) + ":" + std::to_string(Attempts)));
+    xEventGroupClearBits(p_Device.Internal.Events, RAK3172_EVENT_JOINED | RAK3172_EVENT_JOIN_FAILED);
 
     #ifndef CONFIG_RAK3172_USE_RUI3
         p_Device.Internal.isJoinEvent = false;
     #endif
 
     p_Device.LoRaWAN.AttemptCounter = Attempts + 1;
+    p_Device.LoRaWAN.JoinInterval = Interval;
+    p_Device.LoRaWAN.isAutoJoin = EnableAutoJoin;
+
+    Error = RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(EnableAutoJoin) + ":" + std::to_string(Interval) + ":" + std::to_string(Attempts));
+    if(Error != RAK3172_ERR_OK)
+    {
+        return Error;
+    }
+
+    // The flag is cleared by the event task when the join process has finished.
     p_Device.Internal.isBusy = true;
 
-    #ifdef CONFIG_RAK3172_USE_RUI3
-        TimeNow = RAK3172_Timer_GetMilliseconds() / 1000ULL;
-        do
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_WaitJoin(RAK3172_t& p_Device, uint32_t Timeout, RAK3172_Wait_t on_Wait)
+{
+    TickType_t Start;
+    TickType_t Wait;
+    uint32_t Elapsed;
+    EventBits_t Bits;
+
+    if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+
+    // The timeout is given in seconds, like the timeout of the other join functions.
+    Timeout *= 1000UL;
+
+    Start = xTaskGetTickCount();
+    while(true)
+    {
+        // Sleep until the event task reports the result of the join process. Wake up periodically only when a wait hook is used.
+        Wait = portMAX_DELAY;
+        if(Timeout != RAK3172_NO_TIMEOUT)
         {
-            if((Timeout > 0) && (((RAK3172_Timer_GetMilliseconds() / 1000ULL) - TimeNow) >= (Timeout * 1000ULL)))
-            {
-                RAK3172_LOGE(TAG, "Join timeout!");
+            Elapsed = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
+            Wait = (Elapsed < Timeout) ? ((Timeout - Elapsed) / portTICK_PERIOD_MS) : 0;
+        }
+
+        if((on_Wait != NULL) && (Wait > (RAK3172_JOIN_WAIT_INTERVAL / portTICK_PERIOD_MS)))
+        {
+            Wait = RAK3172_JOIN_WAIT_INTERVAL / portTICK_PERIOD_MS;
+        }
+
+        Bits = xEventGroupWaitBits(p_Device.Internal.Events, RAK3172_EVENT_JOINED | RAK3172_EVENT_JOIN_FAILED, pdTRUE, pdFALSE, Wait);
+        if(Bits & RAK3172_EVENT_JOINED)
+        {
+            return RAK3172_ERR_OK;
+        }
+        else if(Bits & RAK3172_EVENT_JOIN_FAILED)
+        {
+            // Firmware without RUI3 needs a new join request for each attempt.
+            #ifndef CONFIG_RAK3172_USE_RUI3
+                if(p_Device.LoRaWAN.AttemptCounter > 1)
+                {
+                    p_Device.Internal.isJoinEvent = false;
+                    RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(p_Device.LoRaWAN.isAutoJoin) + ":" + std::to_string(p_Device.LoRaWAN.JoinInterval) + ":" +
+                                                  std::to_string(p_Device.LoRaWAN.AttemptCounter - 1));
+                    p_Device.Internal.isBusy = true;
+
+                    continue;
+                }
+            #endif
+
+            RAK3172_LoRaWAN_StopJoin(p_Device);
+
+            return RAK3172_ERR_FAIL;
+        }
+
+        if((Timeout != RAK3172_NO_TIMEOUT) && (((xTaskGetTickCount() - Start) * portTICK_PERIOD_MS) >= Timeout))
+        {
+            RAK3172_LOGE(TAG, "Join timeout!");
+
+            p_Device.Internal.isBusy = false;
+            RAK3172_LoRaWAN_StopJoin(p_Device);
+
+            return RAK3172_ERR_TIMEOUT;
+        }
+
+        if(on_Wait != NULL)
+        {
+            on_Wait();
+        }
+    }
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_JoinScheduled(RAK3172_t& p_Device, const RAK3172_LoRaWAN_JoinSchedule_t& Schedule, uint32_t Timeout)
+{
+    unsigned long Start;
+    unsigned long AttemptStart;
+    uint32_t Airtime;
+    uint32_t Delay;
+    RAK3172_Band_t Band;
+    RAK3172_DataRate_t DR;
+    RAK3172_Error_t Error;
+
+    if((Schedule.Attempts == 0) || (Schedule.AttemptsPerDataRate == 0) || (Schedule.DataRateMin > Schedule.DataRateMax))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+    else if(p_Device.LoRaWAN.isJoined)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
+
+    Start = RAK3172_Timer_GetMilliseconds();
+    DR = Schedule.DataRateMax;
+    Delay = RAK3172_LoRaWAN_GetJoinDelay(0, 0, 0, Schedule.Jitter);
+    for(uint8_t i = 0; i < Schedule.Attempts; i++)
+    {
+        if((Timeout > 0) && ((RAK3172_Timer_GetMilliseconds() - Start + Delay) >= (Timeout * 1000UL)))
+        {
+            RAK3172_LOGE(TAG, "Join timeout!");
+
+            return RAK3172_ERR_TIMEOUT;
+        }
+
+        vTaskDelay(Delay / portTICK_PERIOD_MS);
+
+        // Use the more robust data rate after each block of attempts.
+        if((i > 0) && ((i % Schedule.AttemptsPerDataRate) == 0) && (DR > Schedule.DataRateMin))
+        {
+            DR = static_cast<RAK3172_DataRate_t>(DR - 1);
+        }
+
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetDataRate(p_Device, DR));
+
+        Airtime = RAK3172_LoRaWAN_GetTimeOnAir(Band, DR, RAK3172_JOIN_REQUEST_LENGTH);
+        p_Device.Statistics.JoinAttempts++;
+        p_Device.Statistics.JoinAirtime += Airtime;
+
+        RAK3172_LOGI(TAG, "Join attempt %u with DR%u (%lu ms airtime)", i + 1, DR, static_cast<unsigned long>(Airtime));
+
+        // Transmit a single join request and wait for the result.
+        AttemptStart = RAK3172_Timer_GetMilliseconds();
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_StartJoinAsync(p_Device, 0));
+        Error = RAK3172_LoRaWAN_WaitJoin(p_Device, RAK3172_JOIN_ATTEMPT_TIMEOUT);
+        if(Error == RAK3172_ERR_OK)
+        {
+            RAK3172_LOGI(TAG, "Joined after %lu ms. Join airtime: %lu ms", RAK3172_Timer_GetMilliseconds() - Start, static_cast<unsigned long>(p_Device.Statistics.JoinAirtime));
+
+            return RAK3172_ERR_OK;
+        }
+        else if((Error != RAK3172_ERR_FAIL) && (Error != RAK3172_ERR_TIMEOUT))
+        {
+            return Error;
+        }
+
+        Delay = RAK3172_LoRaWAN_GetJoinDelay(Airtime, RAK3172_Timer_GetMilliseconds() - Start, RAK3172_Timer_GetMilliseconds() - AttemptStart, Schedule.Jitter);
+    }
+
+    return RAK3172_ERR_FAIL;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_JoinSubBandDiscovery(RAK3172_t& p_Device, uint8_t AttemptsPerSubBand, uint32_t Timeout, uint32_t Jitter)
+{
+    uint32_t Stored;
+    uint32_t Airtime;
+    uint32_t Used;
+    uint32_t Delay;
+    unsigned long Start;
+    unsigned long AttemptStart;
+    RAK3172_Band_t Band;
+    RAK3172_DataRate_t DR;
+    RAK3172_SubBand_t Order[8];
+    uint8_t Count;
+    RAK3172_Error_t Error;
+
+    if(AttemptsPerSubBand == 0)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+    else if(p_Device.LoRaWAN.isJoined)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
+    if((Band != RAK_BAND_US915) && (Band != RAK_BAND_AU915))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetDataRate(p_Device, &DR));
+    Airtime = RAK3172_LoRaWAN_GetTimeOnAir(Band, DR, RAK3172_JOIN_REQUEST_LENGTH);
+
+    // Start with the last successful sub band of this frequency band.
+    Count = 0;
+    if((RAK3172_Storage_Read(RAK3172_STORAGE_KEY_SUB_BAND, &Stored) == RAK3172_ERR_OK) && ((Stored >> 8) == static_cast<uint32_t>(Band)) &&
+       ((Stored & 0xFF) >= RAK_SUB_BAND_1) && ((Stored & 0xFF) <= RAK_SUB_BAND_8))
+    {
+        Order[Count++] = static_cast<RAK3172_SubBand_t>(Stored & 0xFF);
+    }
 
-                RAK3172_LoRaWAN_StopJoin(p_Device);
+    for(uint8_t i = RAK_SUB_BAND_1; i <= RAK_SUB_BAND_8; i++)
+    {
+        if((Count == 0) || (Order[0] != i))
+        {
+            Order[Count++] = static_cast<RAK3172_SubBand_t>(i);
+        }
+    }
 
-                p_Device.Internal.isBusy = false;
+    Start = RAK3172_Timer_GetMilliseconds();
+    Used = 0;
+    Delay = RAK3172_LoRaWAN_GetJoinDelay(0, 0, 0, Jitter);
+    for(uint8_t i = 0; i < Count; i++)
+    {
+        RAK3172_LOGI(TAG, "Try sub band %u...", Order[i] - RAK_SUB_BAND_1 + 1);
 
-                return RAK3172_ERR_TIMEOUT;
-            }
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetSubBand(p_Device, Order[i]));
 
-            if(on_Wait != NULL)
+        for(uint8_t j = 0; j < AttemptsPerSubBand; j++)
+        {
+            // Stay within the aggregated join duty cycle of the first hour.
+            if((Used + Airtime) > RAK3172_JOIN_AIRTIME_BUDGET)
             {
-                on_Wait();
-            }
+                RAK3172_LOGE(TAG, "Join airtime budget exhausted!");
 
-            if(p_Device.LoRaWAN.AttemptCounter == 0)
+                return RAK3172_ERR_FAIL;
+            }
+            else if((Timeout > 0) && ((RAK3172_Timer_GetMilliseconds() - Start + Delay) >= (Timeout * 1000UL)))
             {
-                RAK3172_LoRaWAN_StopJoin(p_Device);
+                RAK3172_LOGE(TAG, "Join timeout!");
 
-                break;
+                return RAK3172_ERR_TIMEOUT;
             }
 
-            RAK3172_PwrMagnt_EnterLightSleep(p_Device);
+            // Use the same back-off as the join scheduler, because all devices search the sub band after a gateway outage.
+            vTaskDelay(Delay / portTICK_PERIOD_MS);
 
-            // We need this delay to prevent a task watchdog reset on ESP32.
-            vTaskDelay(20 / portTICK_PERIOD_MS);
-        } while((Block == true) && (p_Device.LoRaWAN.isJoined == false) && (p_Device.Internal.isBusy == true));
+            Used += Airtime;
+            p_Device.Statistics.JoinAttempts++;
+            p_Device.Statistics.JoinAirtime += Airtime;
 
-        if((Block == true) && (p_Device.LoRaWAN.isJoined == false))
-        {
-            return RAK3172_ERR_FAIL;
-        }
-    #else
-        do
-        {
-            // Join event has occured and join was not successful. Start a new join.
-            if((p_Device.Internal.isJoinEvent == true) && (p_Device.LoRaWAN.isJoined == false))
-            {
-                RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(EnableAutoJoin) + ":" + std::to_string(Interval) + ":" + std::to_string(Attempts));
-                p_Device.Internal.isJoinEvent = false;
-            }
-            // Join event has occured and join was successful.
-            else if((p_Device.Internal.isJoinEvent == true) && (p_Device.LoRaWAN.isJoined == true))
+            AttemptStart = RAK3172_Timer_GetMilliseconds();
+            RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_StartJoinAsync(p_Device, 0));
+            Error = RAK3172_LoRaWAN_WaitJoin(p_Device, RAK3172_JOIN_ATTEMPT_TIMEOUT);
+            if(Error == RAK3172_ERR_OK)
             {
-                break;
-            }
+                RAK3172_LOGI(TAG, "Joined with sub band %u after %lu ms", Order[i] - RAK_SUB_BAND_1 + 1, RAK3172_Timer_GetMilliseconds() - Start);
 
-            if(on_Wait != NULL)
-            {
-                on_Wait();
-            }
+                if(RAK3172_Storage_Write(RAK3172_STORAGE_KEY_SUB_BAND, (static_cast<uint32_t>(Band) << 8) | Order[i]) != RAK3172_ERR_OK)
+                {
+                    RAK3172_LOGW(TAG, "Can not store the sub band!");
+                }
 
-            if(p_Device.LoRaWAN.AttemptCounter == 0)
+                return RAK3172_ERR_OK;
+            }
+            else if((Error != RAK3172_ERR_FAIL) && (Error != RAK3172_ERR_TIMEOUT))
             {
-                RAK3172_LoRaWAN_StopJoin(p_Device);
-
-                break;
+                return Error;
             }
 
-            RAK3172_PwrMagnt_EnterLightSleep(p_Device);
-
-            vTaskDelay(20 / portTICK_PERIOD_MS);
-        } while(p_Device.LoRaWAN.isJoined == false);
-
-        if(p_Device.LoRaWAN.isJoined == false)
-        {
-            return RAK3172_ERR_FAIL;
+            Delay = RAK3172_LoRaWAN_GetJoinDelay(Airtime, RAK3172_Timer_GetMilliseconds() - Start, RAK3172_Timer_GetMilliseconds() - AttemptStart, Jitter);
         }
-    #endif
+    }
 
-    return RAK3172_ERR_OK;
+    return RAK3172_ERR_FAIL;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_StopJoin(const RAK3172_t& p_Device)
@@ -327,16 +842,57 @@ bool RAK3172_LoRaWAN_isJoined(RAK3172_t& p_Device, bool Refresh)
 
 RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const uint8_t* const p_Buffer, uint16_t Length, uint8_t Retries)
 {
-    return RAK3172_LoRaWAN_Transmit(p_Device, Port, p_Buffer, Length, Retries);
+    return RAK3172_LoRaWAN_Transmit(p_Device, Port, static_cast<const void*>(p_Buffer), Length, Retries, false);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, uint8_t Retries, bool Confirmed, RAK3172_Wait_t Wait)
 {
-    std::string Payload;
+    RAK3172_Segment_t Segment = {
+        .p_Data = p_Buffer,
+        .Length = Length,
+    };
+
+    if(p_Buffer == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    return RAK3172_LoRaWAN_Transmit(p_Device, Port, &Segment, 1, Retries, Confirmed, Wait);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const RAK3172_Segment_t* const p_Segments, size_t Count, uint8_t Retries, bool Confirmed, RAK3172_Wait_t Wait)
+{
+    std::string Command;
     std::string Status;
-    char Buffer[3];
+    size_t Length = 0;
+    const RAK3172_Segment_t* Segments = p_Segments;
+    uint32_t Deadline = 0;
+    uint32_t Elapsed;
+    TickType_t Start;
+    TickType_t Ticks;
+    EventBits_t Bits;
+    RAK3172_Error_t Error;
+    #ifdef CONFIG_RAK3172_COMPRESSION
+        uint8_t Compressed[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+        RAK3172_Segment_t Payload;
+    #endif
+
+    if((p_Segments == NULL) || (Count == 0) || (Port == 0) || (Port > 233) || (Retries > 7))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        if((p_Segments[i].p_Data == NULL) && (p_Segments[i].Length > 0))
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
 
-    if(((p_Buffer == NULL) && (Length == 0)) || (Length > 1000) || (Port == 0) || (Port > 233) || (Retries > 7))
+        Length += p_Segments[i].Length;
+    }
+
+    if(Length > 1000)
     {
         return RAK3172_ERR_INVALID_ARG;
     }
@@ -357,28 +913,74 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
         return RAK3172_ERR_OK;
     }
 
+    #ifdef CONFIG_RAK3172_COMPRESSION
+        if(p_Device.Internal.Codec != NULL)
+        {
+            p_Device.Statistics.CodecInput += Length;
+
+            Length = RAK3172_Codec_Encode(p_Device.Internal.Codec, p_Segments, Count, Compressed, sizeof(Compressed));
+            if(Length == 0)
+            {
+                return RAK3172_ERR_INVALID_ARG;
+            }
+
+            p_Device.Statistics.CodecOutput += Length;
+
+            Payload.p_Data = Compressed;
+            Payload.Length = Length;
+            Segments = &Payload;
+            Count = 1;
+        }
+    #endif
+
+    // Reject the uplink without a module request when the duty cycle doesn´t allow a transmission.
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        if(RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device) > 0)
+        {
+            p_Device.Statistics.DutyCycleBlocked++;
+
+            return RAK3172_ERR_RESTRICTED;
+        }
+    #endif
+
+    // Only write the settings when they differ from the last applied settings.
     if(Confirmed)
     {
-        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetRetries(p_Device, Retries));
-    }
+        if(((p_Device.Cache.Valid & RAK3172_CACHE_RETRIES) == 0) || (p_Device.Cache.Retries != Retries))
+        {
+            RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetRetries(p_Device, Retries));
+        }
+        else
+        {
+            p_Device.Statistics.SkippedCommands++;
+        }
 
-    // Encode the payload into an ASCII string.
-    for(uint8_t i = 0x00; i < Length; i++)
-    {
-        sprintf(Buffer, "%02x", ((uint8_t*)p_Buffer)[i]);
-        Payload += std::string(Buffer);
+        Deadline = RAK3172_LoRaWAN_GetConfirmDeadline(p_Device, static_cast<uint16_t>(Length), Retries);
     }
 
     if(Length > 500)
     {
-        RAK3172_SendCommand(p_Device, "AT+LPSEND=" + std::to_string(Port) + ":" + std::to_string(Confirmed) + ":" + Payload, NULL, &Status);
+        Command = "AT+LPSEND=" + std::to_string(Port) + ":" + std::to_string(Confirmed) + ":";
     }
     else
     {
-        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetConfirmation(p_Device, Confirmed));
-        RAK3172_SendCommand(p_Device, "AT+SEND=" + std::to_string(Port) + ":" + Payload, NULL, &Status);
+        if(((p_Device.Cache.Valid & RAK3172_CACHE_CONFIRMATION) == 0) || (p_Device.Cache.Confirmation != Confirmed))
+        {
+            RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetConfirmation(p_Device, Confirmed));
+        }
+        else
+        {
+            p_Device.Statistics.SkippedCommands++;
+        }
+
+        Command = "AT+SEND=" + std::to_string(Port) + ":";
     }
 
+    // Remove old confirmation results, because the event task can report the result before the module status is processed.
+    xEventGroupClearBits(p_Device.Internal.Events, RAK3172_EVENT_CONFIRMED_OK | RAK3172_EVENT_CONFIRMED_FAILED);
+
+    Error = RAK3172_SendCommandHex(p_Device, Command, Segments, Count, NULL, &Status);
+
     // The device is busy. Leave the function with an invalid state error.
     if(Status.find("AT_BUSY_ERROR") != std::string::npos)
     {
@@ -388,8 +990,20 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
     {
         return RAK3172_ERR_RESTRICTED;
     }
-    // No transmission error and no confirmation needed.
-    else if((Confirmed == false) && (Status.find("OK") == std::string::npos))
+    else if(Error != RAK3172_ERR_OK)
+    {
+        RAK3172_LOGE(TAG, "Uplink rejected with 0x%X!", static_cast<int>(Error));
+
+        return Error;
+    }
+
+    // The module has accepted the uplink.
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        RAK3172_LoRaWAN_DutyCycle_Add(p_Device, Length);
+    #endif
+
+    // No confirmation needed.
+    if(Confirmed == false)
     {
         return RAK3172_ERR_OK;
     }
@@ -397,26 +1011,46 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
     p_Device.Internal.isBusy = true;
     p_Device.LoRaWAN.ConfirmError = false;
 
-    // Wait for the confirmation if needed.
-    if(Confirmed)
+    // Sleep until the event task reports the confirmation result. Wake up periodically only when a wait hook is used.
+    Start = xTaskGetTickCount();
+    while(true)
     {
-        do
+        Elapsed = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
+        Ticks = (Elapsed < Deadline) ? ((Deadline - Elapsed) / portTICK_PERIOD_MS) : 0;
+
+        if((Wait != NULL) && (Ticks > (RAK3172_CONFIRM_WAIT_INTERVAL / portTICK_PERIOD_MS)))
         {
-            if(Wait)
-            {
-                Wait();
-            }
+            Ticks = RAK3172_CONFIRM_WAIT_INTERVAL / portTICK_PERIOD_MS;
+        }
+
+        Bits = xEventGroupWaitBits(p_Device.Internal.Events, RAK3172_EVENT_CONFIRMED_OK | RAK3172_EVENT_CONFIRMED_FAILED, pdTRUE, pdFALSE, Ticks);
+        if(Bits & (RAK3172_EVENT_CONFIRMED_OK | RAK3172_EVENT_CONFIRMED_FAILED))
+        {
+            break;
+        }
+
+        if(((xTaskGetTickCount() - Start) * portTICK_PERIOD_MS) >= Deadline)
+        {
+            RAK3172_LOGE(TAG, "No confirmation after %lu ms!", static_cast<unsigned long>(Deadline));
 
-            RAK3172_PwrMagnt_EnterLightSleep(p_Device);
+            p_Device.Internal.isBusy = false;
+            p_Device.Statistics.AckTimeouts++;
 
-            // We need this delay to prevent a task watchdog reset on ESP32.
-            vTaskDelay(20 / portTICK_PERIOD_MS);
-        } while(p_Device.Internal.isBusy);
+            return RAK3172_ERR_TIMEOUT;
+        }
+
+        if(Wait != NULL)
+        {
+            Wait();
+        }
     }
 
     p_Device.Internal.isBusy = false;
+    p_Device.Statistics.AckLatency = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
 
-    if(Confirmed && p_Device.LoRaWAN.ConfirmError)
+    RAK3172_LOGD(TAG, "Confirmation result after %lu ms", static_cast<unsigned long>(p_Device.Statistics.AckLatency));
+
+    if(Bits & RAK3172_EVENT_CONFIRMED_FAILED)
     {
         return RAK3172_ERR_INVALID_RESPONSE;
     }
@@ -426,8 +1060,6 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
 
 RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* p_Message, uint32_t Timeout)
 {
-    RAK3172_Rx_t* FromQueue = NULL;
-
     if(p_Message == NULL)
     {
         return RAK3172_ERR_INVALID_ARG;
@@ -441,22 +1073,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* p_Mes
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    if(xQueueReceive(p_Device.Internal.ReceiveQueue, &FromQueue, (Timeout * 1000UL) / portTICK_PERIOD_MS) != pdPASS)
+    if(xQueueReceive(p_Device.Internal.ReceiveQueue, p_Message, (Timeout * 1000UL) / portTICK_PERIOD_MS) != pdPASS)
     {
         return RAK3172_ERR_TIMEOUT;
     }
 
-    p_Message->RSSI = FromQueue->RSSI;
-    p_Message->SNR = FromQueue->SNR;
-    p_Message->Port = FromQueue->Port;
-    p_Message->Payload = FromQueue->Payload;
-
-    delete FromQueue;
-
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetRetries(const RAK3172_t& p_Device, uint8_t Retries)
+RAK3172_Error_t RAK3172_LoRaWAN_SetRetries(RAK3172_t& p_Device, uint8_t Retries)
 {
     if(Retries > 7)
     {
@@ -467,10 +1092,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetRetries(const RAK3172_t& p_Device, uint8_t Re
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+RETY=" + std::to_string(Retries));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RETY=" + std::to_string(Retries)));
+
+    p_Device.Cache.Retries = Retries;
+    p_Device.Cache.Valid |= RAK3172_CACHE_RETRIES;
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetRetries(const RAK3172_t& p_Device, uint8_t* const p_Retries)
+RAK3172_Error_t RAK3172_LoRaWAN_GetRetries(RAK3172_t& p_Device, uint8_t* const p_Retries, bool Refresh)
 {
     std::string Response;
 
@@ -483,9 +1113,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRetries(const RAK3172_t& p_Device, uint8_t* c
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RETY=?", &Response));
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_RETRIES, Refresh) == false)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RETY=?", &Response));
+
+        p_Device.Cache.Retries = static_cast<uint8_t>(std::stoi(Response));
+        p_Device.Cache.Valid |= RAK3172_CACHE_RETRIES;
+    }
 
-    *p_Retries = static_cast<uint8_t>(std::stoi(Response));
+    *p_Retries = p_Device.Cache.Retries;
 
     return RAK3172_ERR_OK;
 }
@@ -520,17 +1156,22 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetPNM(const RAK3172_t& p_Device, bool* const p_
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetConfirmation(const RAK3172_t& p_Device, bool Enable)
+RAK3172_Error_t RAK3172_LoRaWAN_SetConfirmation(RAK3172_t& p_Device, bool Enable)
 {
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+CFM=" + std::to_string(Enable));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+CFM=" + std::to_string(Enable)));
+
+    p_Device.Cache.Confirmation = Enable;
+    p_Device.Cache.Valid |= RAK3172_CACHE_CONFIRMATION;
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(const RAK3172_t& p_Device, bool* const p_Enable)
+RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(RAK3172_t& p_Device, bool* const p_Enable, bool Refresh)
 {
     std::string Response;
 
@@ -543,24 +1184,37 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(const RAK3172_t& p_Device, bool*
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+CFM=?", &Response));
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_CONFIRMATION, Refresh) == false)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+CFM=?", &Response));
 
-    *p_Enable = static_cast<bool>(std::stoi(Response));
+        p_Device.Cache.Confirmation = static_cast<bool>(std::stoi(Response));
+        p_Device.Cache.Valid |= RAK3172_CACHE_CONFIRMATION;
+    }
+
+    *p_Enable = p_Device.Cache.Confirmation;
 
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetBand(const RAK3172_t& p_Device, RAK3172_Band_t Band)
+RAK3172_Error_t RAK3172_LoRaWAN_SetBand(RAK3172_t& p_Device, RAK3172_Band_t Band)
 {
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+BAND=" + std::to_string(static_cast<uint8_t>(Band)));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAND=" + std::to_string(static_cast<uint8_t>(Band))));
+
+    // The module resets the channel mask and the data rate when the band is changed.
+    p_Device.Cache.Band = Band;
+    p_Device.Cache.Valid |= RAK3172_CACHE_BAND;
+    p_Device.Cache.Valid &= ~(RAK3172_CACHE_SUB_BAND | RAK3172_CACHE_DATARATE);
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_t* const p_Band)
+RAK3172_Error_t RAK3172_LoRaWAN_GetBand(RAK3172_t& p_Device, RAK3172_Band_t* const p_Band, bool Refresh)
 {
     std::string Response;
 
@@ -573,16 +1227,23 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAND=?", &Response));
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_BAND, Refresh) == false)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAND=?", &Response));
+
+        p_Device.Cache.Band = static_cast<RAK3172_Band_t>(std::stoi(Response));
+        p_Device.Cache.Valid |= RAK3172_CACHE_BAND;
+    }
 
-    *p_Band = static_cast<RAK3172_Band_t>(std::stoi(Response));
+    *p_Band = p_Device.Cache.Band;
 
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t Band)
+RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(RAK3172_t& p_Device, RAK3172_SubBand_t Band)
 {
     RAK3172_Band_t Dummy;
+    std::string Command;
 
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
@@ -594,38 +1255,21 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(const RAK3172_t& p_Device, RAK3172_Su
     }
 
     RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Dummy));
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetSubBandCommand(Dummy, Band, &Command));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, Command));
 
-    // The sub band can only be changed when using US915, AU915 or CN470 frequency band.
-    if((Dummy == RAK_BAND_US915) || (Dummy == RAK_BAND_AU915) || (Dummy == RAK_BAND_CN470))
-    {
-        if((Band > RAK_SUB_BAND_9) && (Dummy != RAK_BAND_CN470))
-        {
-            return RAK3172_ERR_INVALID_ARG;
-        }
-
-        if(Band == RAK_SUB_BAND_ALL)
-        {
-            return RAK3172_SendCommand(p_Device, "AT+MASK=0000");
-        }
-        else
-        {
-            char Temp[5];
-
-            sprintf(Temp, "%04X", 1 << (Band - 2));
-    
-            return RAK3172_SendCommand(p_Device, "AT+MASK=" + std::string(Temp));
-        }
-    }
+    p_Device.Cache.SubBand = Band;
+    p_Device.Cache.Valid |= RAK3172_CACHE_SUB_BAND;
 
-    return RAK3172_ERR_FAIL;
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t* const p_Band)
+RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(RAK3172_t& p_Device, RAK3172_SubBand_t* const p_Band, bool Refresh)
 {
     RAK3172_Band_t Dummy;
     std::string Response;
     uint32_t Mask;
-    uint8_t Shifts = 1;
+    uint8_t Shifts = 0;
 
     if(p_Band == NULL)
     {
@@ -636,92 +1280,55 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_Su
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Dummy));
-
-    if((Dummy != RAK_BAND_US915) && (Dummy != RAK_BAND_AU915) && (Dummy != RAK_BAND_CN470))
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_SUB_BAND, Refresh))
     {
-        *p_Band = RAK_SUB_BAND_NONE;
+        *p_Band = p_Device.Cache.SubBand;
 
         return RAK3172_ERR_OK;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+MASK=?", &Response));
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Dummy, Refresh));
 
-    Mask = std::stoi(Response);
-
-    if(Mask == 0)
+    if((Dummy != RAK_BAND_US915) && (Dummy != RAK_BAND_AU915) && (Dummy != RAK_BAND_CN470))
     {
-        *p_Band = RAK_SUB_BAND_ALL;
-
-        return RAK3172_ERR_OK;
+        *p_Band = RAK_SUB_BAND_NONE;
     }
     else
     {
-        while(Mask != 1)
-        {
-            Mask >>= 1;
-            Shifts++;
-        }
-
-        *p_Band = static_cast<RAK3172_SubBand_t>(Shifts + 2);
-
-        return RAK3172_ERR_OK;
-    }
-}
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+MASK=?", &Response));
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(const RAK3172_t& p_Device, uint8_t TxPwr)
-{
-    uint8_t TxPwrIndex = 0;
-    RAK3172_Band_t Band;
-
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
-
-    RAK3172_LOGD(TAG, "Set Tx power to: %u dBm", TxPwr);
-
-    // For EU868 the maximum transmit power is +16 dB EIRP.
-    if(Band == RAK_BAND_EU868)
-    {
-        const uint8_t EIRP = 16;
+        // The mask is transmitted as hex string.
+        Mask = std::stoul(Response, NULL, 16);
 
-        if(TxPwr >= EIRP)
-        {
-            TxPwrIndex = 0;
-        }
-        else if(TxPwr < (EIRP - 14))
+        if(Mask == 0)
         {
-            TxPwrIndex = 10;
+            *p_Band = RAK_SUB_BAND_ALL;
         }
         else
         {
-            TxPwrIndex = static_cast<uint8_t>((EIRP - TxPwr) / 2);
-        }
-    }
-    // For US915 the maximum transmit power is +30 dBm conducted power.
-    else if(Band == RAK_BAND_US915)
-    {
-        const uint8_t MaxPwr = 30;
+            while(Mask != 1)
+            {
+                Mask >>= 1;
+                Shifts++;
+            }
 
-        if(TxPwr >= MaxPwr)
-        {
-            TxPwrIndex = 0;
-        }
-        else if(TxPwr < 10)
-        {
-            TxPwrIndex = 10;
-        }
-        else
-        {
-            TxPwrIndex = static_cast<uint8_t>((MaxPwr - TxPwr) / 2);
+            *p_Band = static_cast<RAK3172_SubBand_t>(Shifts + RAK_SUB_BAND_1);
         }
     }
-    else
-    {
-        RAK3172_LOGE(TAG, "Tx power is not implemented for the selected frequency band!");
-    }
 
-    RAK3172_LOGD(TAG, "Set Tx power index: %u", TxPwrIndex);
+    p_Device.Cache.SubBand = *p_Band;
+    p_Device.Cache.Valid |= RAK3172_CACHE_SUB_BAND;
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(RAK3172_t& p_Device, uint8_t TxPwr)
+{
+    RAK3172_Band_t Band;
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
 
-    return RAK3172_SendCommand(p_Device, "AT+TXP=" + std::to_string(TxPwrIndex));
+    return RAK3172_SendCommand(p_Device, "AT+TXP=" + std::to_string(RAK3172_LoRaWAN_GetTxPwrIndex(Band, TxPwr)));
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetJoin1Delay(const RAK3172_t& p_Device, uint32_t Delay)
@@ -814,7 +1421,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetJoin2Delay(const RAK3172_t& p_Device, uint32_
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetRX1Delay(const RAK3172_t& p_Device, uint32_t Delay)
+RAK3172_Error_t RAK3172_LoRaWAN_SetRX1Delay(RAK3172_t& p_Device, uint32_t Delay)
 {
     uint32_t Delay_Temp;
 
@@ -835,7 +1442,12 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetRX1Delay(const RAK3172_t& p_Device, uint32_t
         Delay_Temp *= 1000;
     #endif
 
-    return RAK3172_SendCommand(p_Device, "AT+RX1DL=" + std::to_string(Delay_Temp));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RX1DL=" + std::to_string(Delay_Temp)));
+
+    // The module moves the RX2 window together with the RX1 window.
+    p_Device.Cache.Valid &= ~RAK3172_CACHE_RX2_DELAY;
+
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetRX1Delay(const RAK3172_t& p_Device, uint32_t* const p_Delay)
@@ -858,7 +1470,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX1Delay(const RAK3172_t& p_Device, uint32_t*
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Delay(const RAK3172_t& p_Device, uint32_t Delay)
+RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Delay(RAK3172_t& p_Device, uint32_t Delay)
 {
     uint32_t Delay_Temp;
 
@@ -879,7 +1491,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Delay(const RAK3172_t& p_Device, uint32_t
         Delay_Temp *= 1000;
     #endif
 
-    return RAK3172_SendCommand(p_Device, "AT+RX2DL=" + std::to_string(Delay_Temp));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RX2DL=" + std::to_string(Delay_Temp)));
+
+    p_Device.Cache.RX2Delay = Delay_Temp;
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        p_Device.Cache.RX2Delay *= 1000;
+    #endif
+    p_Device.Cache.Valid |= RAK3172_CACHE_RX2_DELAY;
+
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetRX2Delay(const RAK3172_t& p_Device, uint32_t* const p_Delay)
@@ -932,7 +1552,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX2Freq(const RAK3172_t& p_Device, uint32_t*
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetRX2DataRate(const RAK3172_t& p_Device, uint8_t DataRate)
+RAK3172_Error_t RAK3172_LoRaWAN_SetRX2DataRate(RAK3172_t& p_Device, uint8_t DataRate)
 {
     #ifdef CONFIG_RAK3172_USE_RUI3
         RAK3172_Band_t Band;
@@ -975,7 +1595,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetRX2DataRate(const RAK3172_t& p_Device, uint8_
         }
     #endif
 
-    return RAK3172_SendCommand(p_Device, "AT+RX2DL=" + std::to_string(DataRate));
+    return RAK3172_SendCommand(p_Device, "AT+RX2DR=" + std::to_string(DataRate));
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetRX2DataRate(const RAK3172_t& p_Device, uint32_t* const p_DataRate)
@@ -1038,7 +1658,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRSSI(const RAK3172_t& p_Device, int8_t* const
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* const p_Duty)
+RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(RAK3172_t& p_Device, uint8_t* const p_Duty)
 {
     std::string Response;
     RAK3172_Band_t Band;
@@ -1061,7 +1681,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* cons
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t DR)
+RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t DR)
 {
     if(DR > RAK_DR_7)
     {
@@ -1072,10 +1692,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_D
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+DR=" + std::to_string(DR));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DR=" + std::to_string(DR)));
+
+    p_Device.Cache.DataRate = DR;
+    p_Device.Cache.Valid |= RAK3172_CACHE_DATARATE;
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR)
+RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR, bool Refresh)
 {
     std::string Response;
 
@@ -1088,24 +1713,41 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_D
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DR=?", &Response));
+    // The network server can change the data rate when ADR is enabled. So the cached value is only used when ADR is known to be disabled.
+    if(((p_Device.Cache.Valid & RAK3172_CACHE_ADR) == 0) || p_Device.Cache.ADR)
+    {
+        Refresh = true;
+    }
+
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_DATARATE, Refresh) == false)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DR=?", &Response));
+
+        p_Device.Cache.DataRate = static_cast<RAK3172_DataRate_t>(std::stoi(Response));
+        p_Device.Cache.Valid |= RAK3172_CACHE_DATARATE;
+    }
 
-    *p_DR = static_cast<RAK3172_DataRate_t>(std::stoi(Response));
+    *p_DR = p_Device.Cache.DataRate;
 
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetADR(const RAK3172_t& p_Device, bool Enable)
+RAK3172_Error_t RAK3172_LoRaWAN_SetADR(RAK3172_t& p_Device, bool Enable)
 {
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+ADR=" + std::to_string(Enable));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+ADR=" + std::to_string(Enable)));
+
+    p_Device.Cache.ADR = Enable;
+    p_Device.Cache.Valid |= RAK3172_CACHE_ADR;
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_Enable)
+RAK3172_Error_t RAK3172_LoRaWAN_GetADR(RAK3172_t& p_Device, bool* const p_Enable, bool Refresh)
 {
     std::string Response;
 
@@ -1118,24 +1760,58 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+ADR=?", &Response));
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_ADR, Refresh) == false)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+ADR=?", &Response));
+
+        p_Device.Cache.ADR = static_cast<bool>(std::stoi(Response));
+        p_Device.Cache.Valid |= RAK3172_CACHE_ADR;
+    }
 
-    *p_Enable = static_cast<bool>(std::stoi(Response));
+    *p_Enable = p_Device.Cache.ADR;
 
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(const RAK3172_t& p_Device, RAK3172_JoinMode_t Mode)
+RAK3172_Error_t RAK3172_LoRaWAN_GetUplinkDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR)
+{
+    bool isADR;
+
+    if(p_DR == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetADR(p_Device, &isADR));
+
+    // The ADR can lower the data rate before a queued uplink is transmitted. Use the most robust data rate of the band then,
+    // because the module rejects an uplink which doesn´t fit into the data rate during the transmission.
+    if(isADR)
+    {
+        *p_DR = RAK_DR_0;
+
+        return RAK3172_ERR_OK;
+    }
+
+    return RAK3172_LoRaWAN_GetDataRate(p_Device, p_DR);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(RAK3172_t& p_Device, RAK3172_JoinMode_t Mode)
 {
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+NJM=" + std::to_string(Mode));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NJM=" + std::to_string(Mode)));
+
+    p_Device.Cache.JoinMode = Mode;
+    p_Device.Cache.Valid |= RAK3172_CACHE_JOIN_MODE;
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_GetJoinMode(const RAK3172_t& p_Device, RAK3172_JoinMode_t* const p_Mode)
+RAK3172_Error_t RAK3172_LoRaWAN_GetJoinMode(RAK3172_t& p_Device, RAK3172_JoinMode_t* const p_Mode, bool Refresh)
 {
     std::string Response;
 
@@ -1148,9 +1824,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetJoinMode(const RAK3172_t& p_Device, RAK3172_J
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NJM=?", &Response));
+    if(RAK3172_LoRaWAN_CacheLookup(p_Device, RAK3172_CACHE_JOIN_MODE, Refresh) == false)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NJM=?", &Response));
+
+        p_Device.Cache.JoinMode = static_cast<RAK3172_JoinMode_t>(std::stoi(Response));
+        p_Device.Cache.Valid |= RAK3172_CACHE_JOIN_MODE;
+    }
 
-    *p_Mode = static_cast<RAK3172_JoinMode_t>(std::stoi(Response));
+    *p_Mode = p_Device.Cache.JoinMode;
 
     return RAK3172_ERR_OK;
 }
@@ -0,0 +1,170 @@
+ /*
+ * rak3172_lorawan_airtime.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+
+#include <esp_random.h>
+
+#include "rak3172.h"
+
+/** @brief Modulation of a LoRaWAN data rate.
+ */
+typedef struct
+{
+    uint8_t SF;                                 /**< Spreading factor. 0 when the data rate uses FSK. */
+    uint16_t Bandwidth;                         /**< Bandwidth in kHz. 0 when the data rate isn´t defined for the band. */
+    uint8_t MaxPayload;                         /**< Maximum application payload size in bytes without MAC commands. */
+} RAK3172_LoRaWAN_Modulation_t;
+
+/** @brief Uplink data rates for each frequency band (LoRaWAN Regional Parameters RP002-1.0.3, no dwell time limit).
+ */
+static const RAK3172_LoRaWAN_Modulation_t _RAK3172_LoRaWAN_Modulation[][8] = {
+    // EU433
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 222}, {7, 125, 222}, {7, 250, 222}, {0, 50, 222}},
+    // CN470
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 242}, {7, 125, 242}, {7, 500, 242}, {0, 50, 242}},
+    // RU864
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 222}, {7, 125, 222}, {7, 250, 222}, {0, 50, 222}},
+    // IN865
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 242}, {7, 125, 242}, {0, 0, 0}, {0, 50, 242}},
+    // EU868
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 222}, {7, 125, 222}, {7, 250, 222}, {0, 50, 222}},
+    // US915
+    {{10, 125, 11}, {9, 125, 53}, {8, 125, 125}, {7, 125, 242}, {8, 500, 242}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+    // AU915
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 242}, {7, 125, 242}, {8, 500, 242}, {0, 0, 0}},
+    // KR920
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 242}, {7, 125, 242}, {0, 0, 0}, {0, 0, 0}},
+    // AS923
+    {{12, 125, 51}, {11, 125, 51}, {10, 125, 51}, {9, 125, 115}, {8, 125, 242}, {7, 125, 242}, {7, 250, 242}, {0, 50, 242}},
+};
+
+uint32_t RAK3172_GetTimeOnAir(uint8_t SF, uint16_t Bandwidth, RAK3172_CR_t CodingRate, uint16_t Preamble, uint16_t Length, bool ImplicitHeader, bool CRC)
+{
+    uint32_t Symbol;
+    int32_t Numerator;
+    int32_t Denominator;
+    uint32_t Symbols;
+
+    if((SF < 5) || (SF > 12) || (Bandwidth == 0))
+    {
+        return 0;
+    }
+
+    // Symbol time in microseconds.
+    Symbol = ((1UL << SF) * 1000UL) / Bandwidth;
+
+    // Number of payload symbols. The low data rate optimization is used for symbol times of 16 ms and more.
+    Numerator = (8 * Length) - (4 * SF) + 28 + (CRC ? 16 : 0) - (ImplicitHeader ? 20 : 0);
+    Denominator = 4 * (SF - ((Symbol >= 16000UL) ? 2 : 0));
+    Symbols = 8;
+    if(Numerator > 0)
+    {
+        Symbols += ((Numerator + Denominator - 1) / Denominator) * (CodingRate + 5);
+    }
+
+    // Preamble + 4.25 symbols for the sync word.
+    return (((((4UL * Preamble) + 17UL) * Symbol) / 4) + (Symbols * Symbol) + 999UL) / 1000UL;
+}
+
+uint32_t RAK3172_LoRaWAN_GetTimeOnAir(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint16_t Length)
+{
+    if((Band > RAK_BAND_AS923) || (DR > RAK_DR_7) || (_RAK3172_LoRaWAN_Modulation[Band][DR].Bandwidth == 0))
+    {
+        return 0;
+    }
+
+    // FSK with 50 kbps: 5 bytes preamble, 3 bytes sync word, 1 byte length and 2 bytes CRC. One byte needs 160 us.
+    if(_RAK3172_LoRaWAN_Modulation[Band][DR].SF == 0)
+    {
+        return (((Length + 11UL) * 160UL) + 999UL) / 1000UL;
+    }
+
+    // LoRaWAN uplinks use an explicit header, CRC, coding rate 4/5 and 8 preamble symbols.
+    return RAK3172_GetTimeOnAir(_RAK3172_LoRaWAN_Modulation[Band][DR].SF, _RAK3172_LoRaWAN_Modulation[Band][DR].Bandwidth, RAK_CR_45, 8, Length);
+}
+
+uint32_t RAK3172_LoRaWAN_GetPayloadTimeOnAir(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint16_t Length)
+{
+    uint16_t Size;
+    uint32_t Airtime;
+    uint32_t Frame;
+
+    // The module splits long payload into multiple frames. Each frame has its own frame overhead.
+    Airtime = 0;
+    do
+    {
+        Size = (Length > RAK3172_LORAWAN_FRAME_PAYLOAD_MAX) ? RAK3172_LORAWAN_FRAME_PAYLOAD_MAX : Length;
+
+        Frame = RAK3172_LoRaWAN_GetTimeOnAir(Band, DR, Size + RAK3172_LORAWAN_FRAME_OVERHEAD);
+        if(Frame == 0)
+        {
+            return 0;
+        }
+
+        Airtime += Frame;
+        Length -= Size;
+    } while(Length > 0);
+
+    return Airtime;
+}
+
+uint8_t RAK3172_LoRaWAN_GetMaxPayload(RAK3172_Band_t Band, RAK3172_DataRate_t DR)
+{
+    if((Band > RAK_BAND_AS923) || (DR > RAK_DR_7))
+    {
+        return 0;
+    }
+
+    return _RAK3172_LoRaWAN_Modulation[Band][DR].MaxPayload;
+}
+
+uint32_t RAK3172_LoRaWAN_GetJoinDelay(uint32_t Airtime, unsigned long Elapsed, unsigned long Duration, uint32_t Jitter)
+{
+    uint32_t OffTime;
+
+    // Aggregated duty cycle for join requests since the start of the join process.
+    if(Elapsed < 3600000UL)
+    {
+        OffTime = Airtime * 99;
+    }
+    else if(Elapsed < 39600000UL)
+    {
+        OffTime = Airtime * 999;
+    }
+    else
+    {
+        OffTime = Airtime * 9999;
+    }
+
+    // The time spent in the receive windows is part of the off time.
+    OffTime = (OffTime > Duration) ? (OffTime - Duration) : 0;
+
+    // Desynchronize devices which start to join at the same time (i. e. after a gateway outage).
+    if(Jitter > 0)
+    {
+        OffTime += esp_random() % Jitter;
+    }
+
+    return OffTime;
+}
+
+#endif
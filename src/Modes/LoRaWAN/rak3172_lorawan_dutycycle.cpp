@@ -0,0 +1,203 @@
+ /*
+ * rak3172_lorawan_dutycycle.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#if(defined CONFIG_RAK3172_MODE_WITH_LORAWAN) && (defined CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE)
+
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "../../Arch/Logging/rak3172_logging.h"
+#include "../../Arch/Timer/rak3172_timer.h"
+
+/** @brief Duty cycle sub band definition.
+ */
+typedef struct
+{
+    RAK3172_Band_t Band;                        /**< Frequency band. */
+    uint32_t Start;                             /**< First frequency of the sub band in Hz. */
+    uint32_t End;                               /**< Last frequency of the sub band in Hz. */
+    uint16_t Factor;                            /**< Inverse duty cycle (100 for 1 %). */
+} RAK3172_DutyCycle_SubBand_t;
+
+static const char* TAG = "RAK3172_DutyCycle";
+
+/** @brief Duty cycle sub bands (ETSI EN 300 220). Frequency bands without an entry don´t use a duty cycle.
+ *         NOTE: The entries of a frequency band must be consecutive.
+ */
+static const RAK3172_DutyCycle_SubBand_t _RAK3172_DutyCycle_SubBands[] = {
+    {RAK_BAND_EU433, 433050000, 434790000, 100},
+    {RAK_BAND_RU864, 864000000, 870000000, 100},
+    {RAK_BAND_EU868, 863000000, 865000000, 1000},
+    {RAK_BAND_EU868, 865000000, 868000000, 100},
+    {RAK_BAND_EU868, 868000000, 868600000, 100},
+    {RAK_BAND_EU868, 868700000, 869200000, 1000},
+    {RAK_BAND_EU868, 869400000, 869650000, 10},
+    {RAK_BAND_EU868, 869700000, 870000000, 100},
+};
+
+/** @brief              Get the duty cycle sub band of a transmission.
+ *  @param Band         Frequency band
+ *  @param Frequency    Frequency of the transmission in Hz or 0 for the default uplink channels
+ *  @param p_Index      Pointer to ledger index of the sub band
+ *  @return             Pointer to sub band definition
+ *                      NULL when the frequency isn´t part of a duty cycle sub band
+ */
+static const RAK3172_DutyCycle_SubBand_t* RAK3172_DutyCycle_GetSubBand(RAK3172_Band_t Band, uint32_t Frequency, uint8_t* const p_Index)
+{
+    uint8_t Index;
+
+    // The module doesn´t report the uplink channel. Use the first default channel, because the default channels share one sub band.
+    if(Frequency == 0)
+    {
+        switch(Band)
+        {
+            case RAK_BAND_EU433:
+            {
+                Frequency = 433175000;
+
+                break;
+            }
+            case RAK_BAND_RU864:
+            {
+                Frequency = 868900000;
+
+                break;
+            }
+            case RAK_BAND_EU868:
+            {
+                Frequency = 868100000;
+
+                break;
+            }
+            default:
+            {
+                return NULL;
+            }
+        }
+    }
+
+    Index = 0;
+    for(size_t i = 0; i < (sizeof(_RAK3172_DutyCycle_SubBands) / sizeof(_RAK3172_DutyCycle_SubBands[0])); i++)
+    {
+        if(_RAK3172_DutyCycle_SubBands[i].Band != Band)
+        {
+            continue;
+        }
+
+        if((Frequency >= _RAK3172_DutyCycle_SubBands[i].Start) && (Frequency < _RAK3172_DutyCycle_SubBands[i].End))
+        {
+            *p_Index = Index;
+
+            return &_RAK3172_DutyCycle_SubBands[i];
+        }
+
+        Index++;
+    }
+
+    return NULL;
+}
+
+uint16_t RAK3172_LoRaWAN_DutyCycle_GetFactor(RAK3172_Band_t Band, uint32_t Frequency)
+{
+    uint8_t Index;
+    const RAK3172_DutyCycle_SubBand_t* SubBand;
+
+    SubBand = RAK3172_DutyCycle_GetSubBand(Band, Frequency, &Index);
+    if(SubBand == NULL)
+    {
+        return 1;
+    }
+
+    return SubBand->Factor;
+}
+
+uint32_t RAK3172_LoRaWAN_DutyCycle_GetWait(RAK3172_t& p_Device, uint32_t Frequency)
+{
+    uint8_t Index;
+    long Remaining;
+    RAK3172_Band_t Band;
+
+    if(RAK3172_LoRaWAN_GetBand(p_Device, &Band) != RAK3172_ERR_OK)
+    {
+        return 0;
+    }
+
+    if((RAK3172_DutyCycle_GetSubBand(Band, Frequency, &Index) == NULL) || (p_Device.LoRaWAN.DutyCycle[Index] == 0))
+    {
+        return 0;
+    }
+
+    Remaining = static_cast<long>(p_Device.LoRaWAN.DutyCycle[Index] - RAK3172_Timer_GetMilliseconds());
+    if(Remaining <= 0)
+    {
+        p_Device.LoRaWAN.DutyCycle[Index] = 0;
+
+        return 0;
+    }
+
+    return static_cast<uint32_t>(Remaining);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_DutyCycle_Add(RAK3172_t& p_Device, uint16_t Length, uint32_t Frequency)
+{
+    uint8_t Index;
+    uint32_t Airtime;
+    RAK3172_Band_t Band;
+    RAK3172_DataRate_t DR;
+    const RAK3172_DutyCycle_SubBand_t* SubBand;
+
+    if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
+
+    SubBand = RAK3172_DutyCycle_GetSubBand(Band, Frequency, &Index);
+    if(SubBand == NULL)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetDataRate(p_Device, &DR));
+
+    // The sub band is blocked for the time on air and the following off time, which is the time on air multiplied with the inverse duty cycle.
+    Airtime = RAK3172_LoRaWAN_GetPayloadTimeOnAir(Band, DR, Length);
+    p_Device.LoRaWAN.DutyCycle[Index] = RAK3172_Timer_GetMilliseconds() + (Airtime * SubBand->Factor);
+
+    // Zero marks a free sub band.
+    if(p_Device.LoRaWAN.DutyCycle[Index] == 0)
+    {
+        p_Device.LoRaWAN.DutyCycle[Index] = 1;
+    }
+
+    RAK3172_LOGD(TAG, "Airtime: %lu ms. Sub band %u blocked for %lu ms", static_cast<unsigned long>(Airtime), Index, static_cast<unsigned long>(Airtime * SubBand->Factor));
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_LoRaWAN_DutyCycle_Clear(RAK3172_t& p_Device)
+{
+    memset(p_Device.LoRaWAN.DutyCycle, 0, sizeof(p_Device.LoRaWAN.DutyCycle));
+}
+
+#endif
@@ -0,0 +1,268 @@
+ /*
+ * rak3172_lorawan_fragment.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#if(defined CONFIG_RAK3172_MODE_WITH_LORAWAN) && (defined CONFIG_RAK3172_MODE_WITH_LORAWAN_FRAGMENTATION)
+
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "../../Arch/Logging/rak3172_logging.h"
+
+static const char* TAG = "RAK3172_Fragment";
+
+RAK3172_Error_t RAK3172_LoRaWAN_TransmitFragmented(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, size_t Length, bool Confirmed, uint8_t Retries,
+                                                   RAK3172_Uplink_Callback_t on_Done, void* p_Arg, RAK3172_Ticket_t* const p_Ticket, uint32_t Timeout)
+{
+    uint8_t ID;
+    size_t Count;
+    size_t FragmentSize;
+    size_t Size;
+    uint32_t Airtime;
+    RAK3172_Band_t Band;
+    RAK3172_DataRate_t DR;
+    uint8_t Fragment[CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE];
+    const uint8_t* Data = static_cast<const uint8_t*>(p_Buffer);
+
+    if((p_Buffer == NULL) || (Length == 0))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetUplinkDataRate(p_Device, &DR));
+
+    // Use the largest fragment which fits into the data rate and into the uplink queue.
+    FragmentSize = RAK3172_LoRaWAN_GetMaxPayload(Band, DR);
+    if(FragmentSize > CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE)
+    {
+        FragmentSize = CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE;
+    }
+
+    // Leave space for the codec header.
+    #ifdef CONFIG_RAK3172_COMPRESSION
+        if((p_Device.Internal.Codec != NULL) && (FragmentSize > RAK3172_CODEC_HEADER_SIZE))
+        {
+            FragmentSize -= RAK3172_CODEC_HEADER_SIZE;
+        }
+    #endif
+
+    if(FragmentSize <= RAK3172_FRAGMENT_HEADER_SIZE)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    FragmentSize -= RAK3172_FRAGMENT_HEADER_SIZE;
+    Count = (Length + FragmentSize - 1) / FragmentSize;
+    if(Count > RAK3172_FRAGMENT_MAX_COUNT)
+    {
+        RAK3172_LOGE(TAG, "Message needs %u fragments with DR%u!", static_cast<unsigned int>(Count), DR);
+
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    ID = ++p_Device.LoRaWAN.MessageID;
+    Airtime = 0;
+    for(size_t i = 0; i < Count; i++)
+    {
+        Size = ((Length - (i * FragmentSize)) > FragmentSize) ? FragmentSize : (Length - (i * FragmentSize));
+
+        Fragment[0] = ID;
+        Fragment[1] = static_cast<uint8_t>(i);
+        Fragment[2] = static_cast<uint8_t>(Count);
+        memcpy(&Fragment[RAK3172_FRAGMENT_HEADER_SIZE], &Data[i * FragmentSize], Size);
+
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_Submit(p_Device, Port, Fragment, Size + RAK3172_FRAGMENT_HEADER_SIZE, Confirmed, Retries, on_Done, p_Arg, p_Ticket, Timeout));
+
+        Airtime += RAK3172_LoRaWAN_GetTimeOnAir(Band, DR, Size + RAK3172_FRAGMENT_HEADER_SIZE + RAK3172_LORAWAN_FRAME_OVERHEAD);
+    }
+
+    RAK3172_LOGI(TAG, "Message %u: %u bytes in %u fragments with DR%u. Airtime: %lu ms, Goodput: %lu bit/s", ID, static_cast<unsigned int>(Length), static_cast<unsigned int>(Count), DR,
+                                                                                                               static_cast<unsigned long>(Airtime),
+                                                                                                               (Airtime > 0) ? static_cast<unsigned long>((Length * 8000UL) / Airtime) : 0UL);
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_LoRaWAN_Reassembly_Init(RAK3172_Reassembly_t* const p_Context, uint8_t* const p_Buffer, size_t Size)
+{
+    if(p_Context == NULL)
+    {
+        return;
+    }
+
+    memset(p_Context, 0, sizeof(RAK3172_Reassembly_t));
+    p_Context->p_Buffer = p_Buffer;
+    p_Context->Size = Size;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Reassemble(RAK3172_Reassembly_t* const p_Context, const uint8_t* const p_Fragment, size_t Length, bool* const p_Complete)
+{
+    uint8_t ID;
+    uint8_t Index;
+    uint8_t Count;
+    size_t Size;
+    size_t Offset;
+    const uint8_t* Data;
+
+    if((p_Context == NULL) || (p_Context->p_Buffer == NULL) || (p_Fragment == NULL) || (p_Complete == NULL) || (Length <= RAK3172_FRAGMENT_HEADER_SIZE))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    *p_Complete = false;
+
+    ID = p_Fragment[0];
+    Index = p_Fragment[1];
+    Count = p_Fragment[2];
+    Data = &p_Fragment[RAK3172_FRAGMENT_HEADER_SIZE];
+    Size = Length - RAK3172_FRAGMENT_HEADER_SIZE;
+
+    if((Count == 0) || (Index >= Count))
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    // A new message replaces an incomplete message.
+    if((p_Context->Count != 0) && ((p_Context->ID != ID) || (p_Context->Count != Count)))
+    {
+        RAK3172_LOGW(TAG, "Message %u incomplete. %u of %u fragments received", p_Context->ID, p_Context->Received, p_Context->Count);
+
+        p_Context->Dropped++;
+        p_Context->Count = 0;
+        p_Context->Received = 0;
+    }
+
+    // Ignore repeated fragments of the last complete message.
+    if((p_Context->Count == 0) && (p_Context->Received != 0) && (p_Context->ID == ID))
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    if(p_Context->Count == 0)
+    {
+        p_Context->ID = ID;
+        p_Context->Count = Count;
+        p_Context->Received = 0;
+        p_Context->FragmentSize = 0;
+        p_Context->LastSize = 0;
+        memset(p_Context->Bitmap, 0, sizeof(p_Context->Bitmap));
+    }
+
+    // Ignore repeated fragments.
+    if(p_Context->Bitmap[Index / 32] & (0x01UL << (Index % 32)))
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    if(Index == (Count - 1))
+    {
+        if((p_Context->FragmentSize != 0) && (Size > p_Context->FragmentSize))
+        {
+            return RAK3172_ERR_INVALID_RESPONSE;
+        }
+
+        // The position of the last fragment depends on the size of the other fragments.
+        // Park it at the end of the buffer until the fragment size is known.
+        if(Count == 1)
+        {
+            Offset = 0;
+        }
+        else if(p_Context->FragmentSize != 0)
+        {
+            Offset = (Count - 1) * p_Context->FragmentSize;
+        }
+        else if(Size <= p_Context->Size)
+        {
+            Offset = p_Context->Size - Size;
+        }
+        else
+        {
+            goto RAK3172_LoRaWAN_Reassemble_NoMem;
+        }
+
+        p_Context->LastSize = Size;
+    }
+    else
+    {
+        if(p_Context->FragmentSize == 0)
+        {
+            if((((Count - 1) * Size) + p_Context->LastSize) > p_Context->Size)
+            {
+                goto RAK3172_LoRaWAN_Reassemble_NoMem;
+            }
+
+            if((p_Context->LastSize != 0) && (p_Context->LastSize > Size))
+            {
+                return RAK3172_ERR_INVALID_RESPONSE;
+            }
+
+            p_Context->FragmentSize = Size;
+
+            // Move the parked last fragment to the final position.
+            if(p_Context->LastSize != 0)
+            {
+                memmove(&p_Context->p_Buffer[(Count - 1) * Size], &p_Context->p_Buffer[p_Context->Size - p_Context->LastSize], p_Context->LastSize);
+            }
+        }
+        else if(Size != p_Context->FragmentSize)
+        {
+            return RAK3172_ERR_INVALID_RESPONSE;
+        }
+
+        Offset = Index * p_Context->FragmentSize;
+    }
+
+    if((Offset + Size) > p_Context->Size)
+    {
+        goto RAK3172_LoRaWAN_Reassemble_NoMem;
+    }
+
+    memcpy(&p_Context->p_Buffer[Offset], Data, Size);
+    p_Context->Bitmap[Index / 32] |= (0x01UL << (Index % 32));
+    p_Context->Received++;
+
+    if(p_Context->Received == p_Context->Count)
+    {
+        p_Context->Length = ((Count - 1) * p_Context->FragmentSize) + p_Context->LastSize;
+        p_Context->Count = 0;
+        *p_Complete = true;
+
+        RAK3172_LOGD(TAG, "Message %u complete. Length: %u bytes", ID, static_cast<unsigned int>(p_Context->Length));
+    }
+
+    return RAK3172_ERR_OK;
+
+RAK3172_LoRaWAN_Reassemble_NoMem:
+    RAK3172_LOGE(TAG, "Message %u doesn´t fit into the buffer!", ID);
+
+    p_Context->Dropped++;
+    p_Context->Count = 0;
+    p_Context->Received = 0;
+
+    return RAK3172_ERR_NO_MEM;
+}
+
+#endif
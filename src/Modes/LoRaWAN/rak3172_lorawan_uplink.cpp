@@ -0,0 +1,476 @@
+ /*
+ * rak3172_lorawan_uplink.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#if(defined CONFIG_RAK3172_MODE_WITH_LORAWAN) && (defined CONFIG_RAK3172_UPLINK_ENABLE)
+
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "../../Arch/Logging/rak3172_logging.h"
+#include "../../Arch/Timer/rak3172_timer.h"
+
+/** @brief Uplink object for the sender task.
+ */
+typedef struct
+{
+    RAK3172_Ticket_t Ticket;
+    unsigned long Submitted;
+    uint8_t Port;
+    bool Confirmed;
+    uint8_t Retries;
+    uint16_t Length;
+    uint8_t Payload[CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE];
+    RAK3172_Uplink_Callback_t on_Done;
+    void* p_Arg;
+    bool isStop;
+} RAK3172_Uplink_Item_t;
+
+static const char* TAG = "RAK3172_Uplink";
+
+#ifdef CONFIG_RAK3172_UPLINK_COALESCE
+    /** @brief          Queue the coalesced records.
+     *                  NOTE: Must be called with the device lock taken.
+     *  @param p_Device RAK3172 device object
+     *  @return         RAK3172_ERR_OK when successful
+     *                  RAK3172_ERR_BUSY when the uplink queue is full
+     */
+    static RAK3172_Error_t RAK3172_Uplink_Flush(RAK3172_t& p_Device)
+    {
+        if(p_Device.Internal.CoalesceLength == 0)
+        {
+            return RAK3172_ERR_OK;
+        }
+
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_Submit(p_Device, p_Device.Internal.CoalescePort, p_Device.Internal.CoalesceBuffer, p_Device.Internal.CoalesceLength));
+
+        RAK3172_LOGD(TAG, "%u records coalesced into %u bytes", p_Device.Internal.CoalesceRecords, p_Device.Internal.CoalesceLength);
+
+        p_Device.Statistics.CoalescedFrames++;
+        p_Device.Statistics.CoalescedRecords += p_Device.Internal.CoalesceRecords;
+        p_Device.Internal.CoalesceLength = 0;
+        p_Device.Internal.CoalesceRecords = 0;
+
+        return RAK3172_ERR_OK;
+    }
+
+    /** @brief          Queue the coalesced records when the deadline has expired.
+     *  @param p_Device RAK3172 device object
+     */
+    static void RAK3172_Uplink_FlushExpired(RAK3172_t& p_Device)
+    {
+        xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+
+        if((p_Device.Internal.CoalesceLength > 0) && (static_cast<long>(RAK3172_Timer_GetMilliseconds() - p_Device.Internal.CoalesceDeadline) >= 0))
+        {
+            // Try again later when the uplink queue is full.
+            if(RAK3172_Uplink_Flush(p_Device) != RAK3172_ERR_OK)
+            {
+                p_Device.Internal.CoalesceDeadline = RAK3172_Timer_GetMilliseconds() + CONFIG_RAK3172_UPLINK_RETRY_DELAY;
+            }
+        }
+
+        xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+    }
+#endif
+
+/** @brief          Sender task. Transmits the queued uplinks one after another until a stop request is received.
+ *  @param p_Arg    Pointer to RAK3172 device object
+ */
+static void RAK3172_Uplink_SenderTask(void* p_Arg)
+{
+    uint8_t Attempt;
+    uint32_t Latency;
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        uint32_t Wait;
+    #endif
+    TickType_t Timeout;
+    #ifdef CONFIG_RAK3172_UPLINK_COALESCE
+        long Remaining;
+    #endif
+    RAK3172_Uplink_Item_t Item;
+    RAK3172_Error_t Error;
+    RAK3172_t* Device = static_cast<RAK3172_t*>(p_Arg);
+
+    while(true)
+    {
+        Timeout = portMAX_DELAY;
+
+        // Wake up at the deadline of the coalesced records.
+        #ifdef CONFIG_RAK3172_UPLINK_COALESCE
+            if(Device->Internal.CoalesceLength > 0)
+            {
+                Remaining = static_cast<long>(Device->Internal.CoalesceDeadline - RAK3172_Timer_GetMilliseconds());
+                Timeout = (Remaining > 0) ? (Remaining / portTICK_PERIOD_MS) : 0;
+            }
+        #endif
+
+        if(xQueueReceive(Device->Internal.UplinkQueue, &Item, Timeout) != pdPASS)
+        {
+            #ifdef CONFIG_RAK3172_UPLINK_COALESCE
+                RAK3172_Uplink_FlushExpired(*Device);
+            #endif
+
+            continue;
+        }
+
+        if(Item.isStop)
+        {
+            break;
+        }
+
+        // Empty items only wake up the task.
+        if(Item.Length == 0)
+        {
+            continue;
+        }
+
+        Attempt = 0;
+        do
+        {
+            // Wait until the duty cycle allows the transmission instead of spending a retry.
+            #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+                Wait = RAK3172_LoRaWAN_DutyCycle_GetWait(*Device);
+                if(Wait > 0)
+                {
+                    RAK3172_LOGD(TAG, "Uplink %lu waits %lu ms for the duty cycle", static_cast<unsigned long>(Item.Ticket), static_cast<unsigned long>(Wait));
+
+                    vTaskDelay(Wait / portTICK_PERIOD_MS);
+                }
+            #endif
+
+            Error = RAK3172_LoRaWAN_Transmit(*Device, Item.Port, Item.Payload, Item.Length, Item.Retries, Item.Confirmed);
+
+            // The module is busy with a previous transmission or the duty cycle doesn´t allow a new transmission yet.
+            // Keep the uplink at the head of the queue and try again later to preserve the order.
+            if((Error != RAK3172_ERR_BUSY) && (Error != RAK3172_ERR_RESTRICTED))
+            {
+                break;
+            }
+
+            RAK3172_LOGW(TAG, "Uplink %lu deferred with 0x%X. Retry in %u ms...", static_cast<unsigned long>(Item.Ticket), static_cast<int>(Error), CONFIG_RAK3172_UPLINK_RETRY_DELAY);
+
+            vTaskDelay(CONFIG_RAK3172_UPLINK_RETRY_DELAY / portTICK_PERIOD_MS);
+        } while(Attempt++ < CONFIG_RAK3172_UPLINK_RETRY_COUNT);
+
+        Latency = RAK3172_Timer_GetMilliseconds() - Item.Submitted;
+
+        if(Error == RAK3172_ERR_OK)
+        {
+            Device->Statistics.UplinkCompleted++;
+            Device->Statistics.UplinkLatency = Latency;
+        }
+        else
+        {
+            Device->Statistics.UplinkDropped++;
+        }
+
+        RAK3172_LOGD(TAG, "Uplink %lu finished with 0x%X after %lu ms. Pending: %u", static_cast<unsigned long>(Item.Ticket), static_cast<int>(Error), static_cast<unsigned long>(Latency),
+                                                                                      static_cast<unsigned int>(uxQueueMessagesWaiting(Device->Internal.UplinkQueue)));
+
+        if(Item.on_Done != NULL)
+        {
+            Item.on_Done(Item.Ticket, Error, Latency, Item.p_Arg);
+        }
+    }
+
+    // Drop the pending uplinks without a transmission.
+    while(xQueueReceive(Device->Internal.UplinkQueue, &Item, 0) == pdPASS)
+    {
+        if(Item.Length == 0)
+        {
+            continue;
+        }
+
+        Device->Statistics.UplinkDropped++;
+
+        if(Item.on_Done != NULL)
+        {
+            Item.on_Done(Item.Ticket, RAK3172_ERR_INVALID_STATE, RAK3172_Timer_GetMilliseconds() - Item.Submitted, Item.p_Arg);
+        }
+    }
+
+    RAK3172_LOGD(TAG, "Sender task stopped.");
+
+    xEventGroupSetBits(Device->Internal.Events, RAK3172_EVENT_UPLINK_STOPPED);
+
+    vTaskDelete(NULL);
+}
+
+/** @brief          Create the uplink queue and the sender task.
+ *                  NOTE: Must be called with the device lock taken.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the sender task Cannot be created
+ */
+static RAK3172_Error_t RAK3172_Uplink_Start(RAK3172_t& p_Device)
+{
+    p_Device.Internal.UplinkQueue = xQueueCreate(CONFIG_RAK3172_UPLINK_QUEUE_LENGTH, sizeof(RAK3172_Uplink_Item_t));
+    if(p_Device.Internal.UplinkQueue == NULL)
+    {
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    #ifdef CONFIG_RAK3172_TASK_CORE_USE_AFFINITY
+        xTaskCreatePinnedToCore(RAK3172_Uplink_SenderTask, "RAK3172-Uplink", CONFIG_RAK3172_UPLINK_STACK_SIZE, &p_Device, CONFIG_RAK3172_UPLINK_PRIO, &p_Device.Internal.UplinkHandle, CONFIG_RAK3172_TASK_CORE);
+    #else
+        xTaskCreate(RAK3172_Uplink_SenderTask, "RAK3172-Uplink", CONFIG_RAK3172_UPLINK_STACK_SIZE, &p_Device, CONFIG_RAK3172_UPLINK_PRIO, &p_Device.Internal.UplinkHandle);
+    #endif
+
+    if(p_Device.Internal.UplinkHandle == NULL)
+    {
+        vQueueDelete(p_Device.Internal.UplinkQueue);
+        p_Device.Internal.UplinkQueue = NULL;
+
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    RAK3172_LOGD(TAG, "Sender task started.");
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Submit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, bool Confirmed, uint8_t Retries,
+                                       RAK3172_Uplink_Callback_t on_Done, void* p_Arg, RAK3172_Ticket_t* const p_Ticket, uint32_t Timeout)
+{
+    RAK3172_Uplink_Item_t Item;
+    RAK3172_Error_t Error = RAK3172_ERR_OK;
+
+    if((p_Buffer == NULL) || (Length == 0) || (Length > CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE) || (Port == 0) || (Port > 233) || (Retries > 7))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+
+    if(p_Device.Internal.UplinkQueue == NULL)
+    {
+        Error = RAK3172_Uplink_Start(p_Device);
+    }
+
+    // Tickets are issued under the lock to keep them unique when multiple tasks submit uplinks.
+    Item.Ticket = ++p_Device.Internal.UplinkTicket;
+
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+    if(Error != RAK3172_ERR_OK)
+    {
+        return Error;
+    }
+
+    Item.Submitted = RAK3172_Timer_GetMilliseconds();
+    Item.Port = Port;
+    Item.Confirmed = Confirmed;
+    Item.Retries = Retries;
+    Item.Length = Length;
+    memcpy(Item.Payload, p_Buffer, Length);
+    Item.on_Done = on_Done;
+    Item.p_Arg = p_Arg;
+    Item.isStop = false;
+
+    if(xQueueSend(p_Device.Internal.UplinkQueue, &Item, Timeout / portTICK_PERIOD_MS) != pdPASS)
+    {
+        RAK3172_LOGW(TAG, "Uplink queue full!");
+
+        p_Device.Statistics.UplinkDropped++;
+
+        return RAK3172_ERR_BUSY;
+    }
+
+    if(p_Ticket != NULL)
+    {
+        *p_Ticket = Item.Ticket;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+#ifdef CONFIG_RAK3172_UPLINK_COALESCE
+    RAK3172_Error_t RAK3172_LoRaWAN_Coalesce(RAK3172_t& p_Device, uint8_t Port, const void* const p_Record, uint8_t Length)
+    {
+        bool isFirst;
+        RAK3172_Band_t Band;
+        RAK3172_DataRate_t DR;
+        RAK3172_Uplink_Item_t Wakeup;
+        RAK3172_Error_t Error = RAK3172_ERR_OK;
+
+        if((p_Record == NULL) || (Length == 0) || (Length >= CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE) || (Port == 0) || (Port > 233))
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
+        else if(p_Device.Internal.isInitialized == false)
+        {
+            return RAK3172_ERR_INVALID_STATE;
+        }
+        else if(p_Device.Mode != RAK_MODE_LORAWAN)
+        {
+            return RAK3172_ERR_INVALID_MODE;
+        }
+
+        xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+
+        // The sender task handles the age deadline.
+        if(p_Device.Internal.UplinkQueue == NULL)
+        {
+            Error = RAK3172_Uplink_Start(p_Device);
+            if(Error != RAK3172_ERR_OK)
+            {
+                goto RAK3172_LoRaWAN_Coalesce_Exit;
+            }
+        }
+
+        // Records for another port or records which don´t fit into the current uplink start a new uplink.
+        if((p_Device.Internal.CoalesceLength > 0) && ((p_Device.Internal.CoalescePort != Port) ||
+           ((p_Device.Internal.CoalesceLength + Length + 1) > p_Device.Internal.CoalesceLimit)))
+        {
+            Error = RAK3172_Uplink_Flush(p_Device);
+            if(Error != RAK3172_ERR_OK)
+            {
+                goto RAK3172_LoRaWAN_Coalesce_Exit;
+            }
+        }
+
+        isFirst = (p_Device.Internal.CoalesceLength == 0);
+        if(isFirst)
+        {
+            // Get the payload limit only once for each uplink to save the module requests when ADR is enabled.
+            // The limit must fit into the data rate at the time of the transmission.
+            Error = RAK3172_LoRaWAN_GetBand(p_Device, &Band);
+            if(Error == RAK3172_ERR_OK)
+            {
+                Error = RAK3172_LoRaWAN_GetUplinkDataRate(p_Device, &DR);
+            }
+
+            if(Error != RAK3172_ERR_OK)
+            {
+                goto RAK3172_LoRaWAN_Coalesce_Exit;
+            }
+
+            p_Device.Internal.CoalesceLimit = RAK3172_LoRaWAN_GetMaxPayload(Band, DR);
+            if(p_Device.Internal.CoalesceLimit > CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE)
+            {
+                p_Device.Internal.CoalesceLimit = CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE;
+            }
+
+            // Leave space for the codec header.
+            #ifdef CONFIG_RAK3172_COMPRESSION
+                if((p_Device.Internal.Codec != NULL) && (p_Device.Internal.CoalesceLimit > RAK3172_CODEC_HEADER_SIZE))
+                {
+                    p_Device.Internal.CoalesceLimit -= RAK3172_CODEC_HEADER_SIZE;
+                }
+            #endif
+
+            if((Length + 1) > p_Device.Internal.CoalesceLimit)
+            {
+                Error = RAK3172_ERR_INVALID_ARG;
+                goto RAK3172_LoRaWAN_Coalesce_Exit;
+            }
+
+            p_Device.Internal.CoalescePort = Port;
+            p_Device.Internal.CoalesceDeadline = RAK3172_Timer_GetMilliseconds() + CONFIG_RAK3172_UPLINK_COALESCE_AGE;
+        }
+
+        p_Device.Internal.CoalesceBuffer[p_Device.Internal.CoalesceLength++] = Length;
+        memcpy(&p_Device.Internal.CoalesceBuffer[p_Device.Internal.CoalesceLength], p_Record, Length);
+        p_Device.Internal.CoalesceLength += Length;
+        p_Device.Internal.CoalesceRecords++;
+
+        // Transmit the uplink when no further record fits into it.
+        if((p_Device.Internal.CoalesceLimit - p_Device.Internal.CoalesceLength) < 2)
+        {
+            Error = RAK3172_Uplink_Flush(p_Device);
+
+            // The record is part of the buffer and is transmitted with the next flush.
+            if(Error == RAK3172_ERR_BUSY)
+            {
+                Error = RAK3172_ERR_OK;
+            }
+        }
+        else if(isFirst)
+        {
+            // Wake up the sender task to start the deadline. The task is busy when the queue is full.
+            Wakeup.Length = 0;
+            Wakeup.isStop = false;
+            xQueueSend(p_Device.Internal.UplinkQueue, &Wakeup, 0);
+        }
+
+    RAK3172_LoRaWAN_Coalesce_Exit:
+        xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+        return Error;
+    }
+
+    RAK3172_Error_t RAK3172_LoRaWAN_Flush(RAK3172_t& p_Device)
+    {
+        RAK3172_Error_t Error;
+
+        xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+        Error = RAK3172_Uplink_Flush(p_Device);
+        xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+        return Error;
+    }
+#endif
+
+uint32_t RAK3172_LoRaWAN_GetUplinkQueueDepth(const RAK3172_t& p_Device)
+{
+    if(p_Device.Internal.UplinkQueue == NULL)
+    {
+        return 0;
+    }
+
+    return uxQueueMessagesWaiting(p_Device.Internal.UplinkQueue);
+}
+
+void RAK3172_LoRaWAN_Uplink_Deinit(RAK3172_t& p_Device)
+{
+    RAK3172_Uplink_Item_t Stop;
+
+    if(p_Device.Internal.UplinkQueue == NULL)
+    {
+        return;
+    }
+
+    memset(&Stop, 0, sizeof(RAK3172_Uplink_Item_t));
+    Stop.isStop = true;
+
+    RAK3172_LOGD(TAG, "Stopping sender task with %u pending uplinks...", static_cast<unsigned int>(uxQueueMessagesWaiting(p_Device.Internal.UplinkQueue)));
+
+    // Let the sender task finish the current uplink and stop itself. The lock must not be taken here, because the sender task
+    // needs it for the transmission.
+    xEventGroupClearBits(p_Device.Internal.Events, RAK3172_EVENT_UPLINK_STOPPED);
+    xQueueSendToFront(p_Device.Internal.UplinkQueue, &Stop, portMAX_DELAY);
+    xEventGroupWaitBits(p_Device.Internal.Events, RAK3172_EVENT_UPLINK_STOPPED, pdTRUE, pdTRUE, portMAX_DELAY);
+
+    p_Device.Internal.UplinkHandle = NULL;
+    vQueueDelete(p_Device.Internal.UplinkQueue);
+    p_Device.Internal.UplinkQueue = NULL;
+}
+
+#endif
@@ -32,6 +32,39 @@
 
 static const char* TAG = "RAK3172_P2P";
 
+/** @brief          Check a P2P configuration.
+ *  @param Config   P2P configuration
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when the configuration is invalid
+ */
+static RAK3172_Error_t RAK3172_P2P_CheckConfig(const RAK3172_P2P_Config_t& Config)
+{
+    if((Config.Frequency < 150000000) || (Config.Frequency > 960000000) || (Config.CodeRate > RAK_CR_48) || (Config.Power < 5) || (Config.Power > 22))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        if((Config.SF > RAK_PSF_12) || (Config.SF < RAK_PSF_5))
+    #else
+        if((Config.SF > RAK_PSF_12) || (Config.SF < RAK_PSF_6))
+    #endif
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        if(Config.Preamble < 5)
+    #else
+        if(Config.Preamble < 2)
+    #endif
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
 /** @brief          LoRa P2P receive task.
  *  @param p_Arg    Pointer to task arguments
  */
@@ -43,7 +76,7 @@ static void RAK3172_P2P_ReceiveTask(void* p_Arg)
 
     while(Device->P2P.Active)
     {
-        RAK3172_Rx_t* FromQueue = NULL;
+        RAK3172_Rx_t FromQueue;
 
         if(xQueueReceive(Device->Internal.ReceiveQueue, &FromQueue, 20 / portTICK_PERIOD_MS) == pdPASS)
         {
@@ -64,65 +97,102 @@ static void RAK3172_P2P_ReceiveTask(void* p_Arg)
 
 RAK3172_Error_t RAK3172_P2P_Init(RAK3172_t& p_Device, uint32_t Frequency, RAK3172_PSF_t SF, RAK3172_BW_t Bandwidth, RAK3172_CR_t CodeRate, uint16_t Preamble, uint8_t Power, uint32_t Timeout)
 {
-    std::string Value;
+    RAK3172_P2P_Config_t Config;
 
-    if((Frequency < 150000000) || (Frequency > 960000000) || (CodeRate > RAK_CR_48) || (Power < 5) || (Power > 22))
+    if(p_Device.Internal.isInitialized == false)
     {
-        return RAK3172_ERR_INVALID_ARG;
+        return RAK3172_ERR_INVALID_STATE;
     }
-    else if(p_Device.Internal.isInitialized == false)
+
+    Config.Frequency = Frequency;
+    Config.SF = SF;
+    Config.Bandwidth = Bandwidth;
+    Config.CodeRate = CodeRate;
+    Config.Preamble = Preamble;
+    Config.Power = Power;
+
+    RAK3172_ERROR_CHECK(RAK3172_P2P_CheckConfig(Config));
+
+    RAK3172_LOGI(TAG, "Initialize module in P2P mode...");
+    RAK3172_ERROR_CHECK(RAK3172_SetMode(p_Device, RAK_MODE_P2P));
+
+    p_Device.Internal.isBusy = false;
+
+    return RAK3172_P2P_Apply(p_Device, Config);
+}
+
+RAK3172_Error_t RAK3172_P2P_Apply(RAK3172_t& p_Device, const RAK3172_P2P_Config_t& Config, std::vector<std::string>* const p_Changes)
+{
+    std::string Value;
+    std::string Current;
+    RAK3172_Error_t Error;
+
+    RAK3172_ERROR_CHECK(RAK3172_P2P_CheckConfig(Config));
+
+    if((p_Device.Mode != RAK_MODE_P2P) && (p_Device.Mode != RAK_MODE_P2P_FSK))
     {
-        return RAK3172_ERR_INVALID_STATE;
+        return RAK3172_ERR_INVALID_MODE;
     }
 
+    Value = std::to_string(Config.Frequency) + ":" +
+            std::to_string(Config.SF) + ":" +
+            std::to_string(Config.Bandwidth) + ":" +
+            std::to_string(Config.CodeRate) + ":" +
+            std::to_string(Config.Preamble) + ":" +
+            std::to_string(Config.Power);
+
+    RAK3172_LOGD(TAG, "     Use configuration: %s", Value.c_str());
+
+    // Read the current configuration with a single batch.
     #ifdef CONFIG_RAK3172_USE_RUI3
-        if((SF > RAK_PSF_12) || (SF < RAK_PSF_5))
+        std::string Encryption;
+        RAK3172_BatchItem_t Queries[] = {
+            {"AT+P2P=?", &Current, RAK3172_ERR_OK},
+            {"AT+ENCRY=?", &Encryption, RAK3172_ERR_OK},
+        };
     #else
-        if((SF > RAK_PSF_12) || (SF < RAK_PSF_6))
+        RAK3172_BatchItem_t Queries[] = {
+            {"AT+P2P=?", &Current, RAK3172_ERR_OK},
+        };
     #endif
+
+    Error = RAK3172_SendBatch(p_Device, Queries, sizeof(Queries) / sizeof(Queries[0]));
+    if((Error == RAK3172_ERR_BUSY) || (Error == RAK3172_ERR_INVALID_STATE))
     {
-        return RAK3172_ERR_INVALID_ARG;
+        return Error;
     }
 
     #ifdef CONFIG_RAK3172_USE_RUI3
-        if(Preamble < 5)
-    #else
-        if(Preamble < 2)
+        p_Device.P2P.isEncryptionEnabled = (Encryption == "1");
     #endif
+
+    if(p_Changes != NULL)
     {
-        return RAK3172_ERR_INVALID_ARG;
+        p_Changes->clear();
     }
 
-    Value = std::to_string(Frequency) + ":" +
-            std::to_string(SF) + ":" +
-            std::to_string(Bandwidth) + ":" +
-            std::to_string(CodeRate) + ":" +
-            std::to_string(Preamble) + ":" +
-            std::to_string(Power);
-
-    RAK3172_LOGI(TAG, "Initialize module in P2P mode...");
-    RAK3172_ERROR_CHECK(RAK3172_SetMode(p_Device, RAK_MODE_P2P));
-    // asdf
-RAK3172_LOGD(TAG, "p_Device.Mode = %d", p_Device.Mode);
-
-    p_Device.Internal.isBusy = false;
+    if((Queries[0].Error == RAK3172_ERR_OK) && (Current == Value))
+    {
+        RAK3172_LOGD(TAG, "     Configuration unchanged");
 
-    RAK3172_LOGD(TAG, "     Use configuration: %s", Value.c_str());
+        return RAK3172_ERR_OK;
+    }
 
-    #ifdef CONFIG_RAK3172_USE_RUI3
-//FIXME        RAK3172_ERROR_CHECK(RAK3172_P2P_isEncryptionEnabled(p_Device, &p_Device.P2P.isEncryptionEnabled));
-    #endif
+    if(p_Changes != NULL)
+    {
+        p_Changes->push_back("AT+P2P=" + Value);
+    }
 
-    //return RAK3172_SendCommand(p_Device, "AT+P2P=" + Value);
-    auto r = RAK3172_SendCommand(p_Device, "AT+P2P=" + Value);
-    RAK3172_LOGD(TAG, "r = 0x%X", static_cast<int>(r));
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-    
+    // The first configuration attempt after a mode change can fail. Repeat it once.
+    if(RAK3172_SendCommand(p_Device, "AT+P2P=" + Value) != RAK3172_ERR_OK)
+    {
+        RAK3172_LOGW(TAG, "Configuration failed. Retry...");
 
-    auto r2 = RAK3172_SendCommand(p_Device, "AT+P2P=" + Value);
-    RAK3172_LOGD(TAG, "r2 = 0x%X", static_cast<int>(r2));
+        vTaskDelay(RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS);
+        RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+P2P=" + Value));
+    }
 
-    return r2;
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_P2P_GetConfig(const RAK3172_t& p_Device, std::string* const p_Config)
@@ -369,40 +439,72 @@ RAK3172_Error_t RAK3172_P2P_GetPower(const RAK3172_t& p_Device, uint8_t* const p
 
 RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const uint8_t* const p_Buffer, uint8_t Length)
 {
-    std::string Payload;
-
-//asdf
-RAK3172_LOGD(TAG, "p_Device.Mode = %d", p_Device.Mode);
+    RAK3172_Segment_t Segment = {
+        .p_Data = p_Buffer,
+        .Length = Length,
+    };
 
     if((p_Buffer == NULL) && (Length > 0))
     {
         return RAK3172_ERR_INVALID_ARG;
     }
+
+    return RAK3172_P2P_Transmit(p_Device, &Segment, 1);
+}
+
+RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const RAK3172_Segment_t* const p_Segments, size_t Count)
+{
+    size_t Length = 0;
+
+    if((p_Segments == NULL) && (Count > 0))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
     else if((p_Device.Mode != RAK_MODE_P2P) && (p_Device.Mode != RAK_MODE_P2P_FSK))
     {
         return RAK3172_ERR_INVALID_MODE;
     }
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        if((p_Segments[i].p_Data == NULL) && (p_Segments[i].Length > 0))
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
+
+        Length += p_Segments[i].Length;
+    }
+
+    if(Length > 255)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
     else if(Length == 0)
     {
         return RAK3172_ERR_OK;
     }
 
-    // Encode the payload into an ASCII string.
-    for(uint8_t i = 0; i < Length; i++)
-    {
-        char Buffer[3];
+    #ifdef CONFIG_RAK3172_COMPRESSION
+        if(p_Device.Internal.Codec != NULL)
+        {
+            uint8_t Compressed[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+            size_t Size;
 
-        sprintf(Buffer, "%02x", ((uint8_t*)p_Buffer)[i]);
-        Payload += std::string(Buffer);
-    }
+            Size = RAK3172_Codec_Encode(p_Device.Internal.Codec, p_Segments, Count, Compressed, sizeof(Compressed));
+            if((Size == 0) || (Size > 255))
+            {
+                return RAK3172_ERR_INVALID_ARG;
+            }
+
+            return RAK3172_SendCommandHex(p_Device, "AT+PSEND=", Compressed, Size);
+        }
+    #endif
 
-    return RAK3172_SendCommand(p_Device, "AT+PSEND=" + Payload);
+    return RAK3172_SendCommandHex(p_Device, "AT+PSEND=", p_Segments, Count);
 }
 
 RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_Message, uint16_t Timeout)
 {
-    RAK3172_Rx_t* FromQueue = NULL;
-
     if((p_Message == NULL) || (Timeout > 65534))
     {
         return RAK3172_ERR_INVALID_ARG;
@@ -417,14 +519,8 @@ RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_M
     p_Device.P2P.isRxTimeout = false;
     do
     {
-        if(xQueueReceive(p_Device.Internal.ReceiveQueue, &FromQueue, 20 / portTICK_PERIOD_MS) == pdPASS)
+        if(xQueueReceive(p_Device.Internal.ReceiveQueue, p_Message, 20 / portTICK_PERIOD_MS) == pdPASS)
         {
-            p_Message->RSSI = FromQueue->RSSI;
-            p_Message->SNR = FromQueue->SNR;
-            p_Message->Payload = FromQueue->Payload;
-
-            delete FromQueue;
-
             return RAK3172_ERR_OK;
         }
     } while(p_Device.P2P.isRxTimeout == false);
@@ -447,7 +543,7 @@ RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout, uint8_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=" + std::to_string(p_Device.P2P.Timeout)));
 
-    p_Device.P2P.ListenQueue = xQueueCreate(QueueSize, sizeof(RAK3172_Rx_t*));
+    p_Device.P2P.ListenQueue = xQueueCreate(QueueSize, sizeof(RAK3172_Rx_t));
     if(p_Device.P2P.ListenQueue == NULL)
     {
         RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=0"));
@@ -478,7 +574,6 @@ RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout, uint8_
 RAK3172_Error_t RAK3172_P2P_PopItem(const RAK3172_t& p_Device, RAK3172_Rx_t* p_Message)
 {
     uint8_t Items;
-    RAK3172_Rx_t* FromQueue;
 
     if(p_Message == NULL)
     {
@@ -501,15 +596,11 @@ RAK3172_Error_t RAK3172_P2P_PopItem(const RAK3172_t& p_Device, RAK3172_Rx_t* p_M
         return RAK3172_ERR_FAIL;
     }
 
-    if(xQueueReceive(p_Device.P2P.ListenQueue, &FromQueue, 0) != pdPASS)
+    if(xQueueReceive(p_Device.P2P.ListenQueue, p_Message, 0) != pdPASS)
     {
         return RAK3172_ERR_FAIL;
     }
 
-    *p_Message = *FromQueue;
-
-    delete FromQueue;
-
     return RAK3172_ERR_OK;
 }
 
@@ -23,10 +23,11 @@
 
 #include "rak3172.h"
 
+#include "../../Codec/rak3172_hex.h"
+
 RAK3172_Error_t RAK3172_P2P_EnableEncryption(RAK3172_t& p_Device, const RAK3172_EncryptKey_t p_Key)
 {
-    std::string Key;
-    char Buffer[3];
+    char Key[16];
 
     if(p_Key == NULL)
     {
@@ -42,13 +43,9 @@ RAK3172_Error_t RAK3172_P2P_EnableEncryption(RAK3172_t& p_Device, const RAK3172_
     p_Device.P2P.isEncryptionEnabled = true;
 
     // Encode the key into an ASCII string.
-    for(uint8_t i = 0; i < 8; i++)
-    {
-        sprintf(Buffer, "%02x", ((uint8_t*)p_Key)[i]);
-        Key += std::string(Buffer);
-    }
+    RAK3172_Hex_Encode(reinterpret_cast<const uint8_t*>(p_Key), sizeof(Key) / 2, Key);
 
-    return RAK3172_SendCommand(p_Device, "AT+ENCKEY=" + Key, NULL, NULL);
+    return RAK3172_SendCommand(p_Device, "AT+ENCKEY=" + std::string(Key, sizeof(Key)), NULL, NULL);
 }
 
 RAK3172_Error_t RAK3172_P2P_DisableEncryption(RAK3172_t& p_Device)
@@ -0,0 +1,335 @@
+ /*
+ * rak3172_event_parser.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Event parser for the RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <string.h>
+
+#include "rak3172_event_parser.h"
+
+/** @brief          Check if a token matches a keyword. Spaces and underscores are treated as equal, because module firmware
+ *                  1.0.4 and below uses spaces instead of underscores.
+ *  @param p_Token  Pointer to token
+ *  @param Length   Length of the token
+ *  @param p_Key    Keyword
+ *  @param isPrefix #true when the keyword only has to match the beginning of the token
+ *  @return         #true when the token matches
+ */
+static bool RAK3172_EventParser_Match(const uint8_t* p_Token, size_t Length, const char* p_Key, bool isPrefix = false)
+{
+    size_t i;
+
+    for(i = 0; p_Key[i] != '\0'; i++)
+    {
+        uint8_t Character;
+
+        if(i >= Length)
+        {
+            return false;
+        }
+
+        Character = (p_Token[i] == ' ') ? '_' : p_Token[i];
+        if(Character != static_cast<uint8_t>(p_Key[i]))
+        {
+            return false;
+        }
+    }
+
+    return isPrefix || (i == Length);
+}
+
+/** @brief          Skip a field separator and read the next decimal number. A leading keyword (i. e. "RSSI" or "SNR") is skipped.
+ *  @param p_Pos    Pointer to current position. The position is moved behind the number.
+ *  @param p_End    Pointer to the end of the line
+ *  @param p_Value  Pointer to number
+ *  @return         #true when successful
+ */
+static bool RAK3172_EventParser_Number(const uint8_t** p_Pos, const uint8_t* p_End, int32_t* p_Value)
+{
+    bool isNegative = false;
+    bool hasDigits = false;
+    int32_t Value = 0;
+    const uint8_t* Pos = *p_Pos;
+
+    if((Pos < p_End) && ((*Pos == ':') || (*Pos == ',')))
+    {
+        Pos++;
+    }
+
+    while((Pos < p_End) && ((*Pos == ' ') || ((*Pos >= 'A') && (*Pos <= 'Z'))))
+    {
+        Pos++;
+    }
+
+    if((Pos < p_End) && ((*Pos == '-') || (*Pos == '+')))
+    {
+        isNegative = (*Pos == '-');
+        Pos++;
+    }
+
+    while((Pos < p_End) && (*Pos >= '0') && (*Pos <= '9'))
+    {
+        Value = (Value * 10) + (*Pos - '0');
+        hasDigits = true;
+        Pos++;
+    }
+
+    *p_Pos = Pos;
+    *p_Value = isNegative ? -Value : Value;
+
+    return hasDigits;
+}
+
+/** @brief          Read the RSSI and the SNR field of a receive event.
+ *  @param p_Pos    Pointer to current position. The position is moved behind the SNR value.
+ *  @param p_End    Pointer to the end of the line
+ *  @param p_Event  Pointer to event object
+ *  @return         #true when successful
+ */
+static bool RAK3172_EventParser_Quality(const uint8_t** p_Pos, const uint8_t* p_End, RAK3172_Event_t* p_Event)
+{
+    int32_t RSSI;
+    int32_t SNR;
+
+    if((RAK3172_EventParser_Number(p_Pos, p_End, &RSSI) == false) || (RAK3172_EventParser_Number(p_Pos, p_End, &SNR) == false))
+    {
+        return false;
+    }
+
+    p_Event->RSSI = static_cast<int16_t>(RSSI);
+    p_Event->SNR = static_cast<int8_t>(SNR);
+
+    return true;
+}
+
+/** @brief          Store the remaining part of the line as payload.
+ *  @param Pos      Pointer to current position
+ *  @param p_End    Pointer to the end of the line
+ *  @param p_Event  Pointer to event object
+ */
+static void RAK3172_EventParser_Payload(const uint8_t* Pos, const uint8_t* p_End, RAK3172_Event_t* p_Event)
+{
+    while((Pos < p_End) && ((*Pos == ':') || (*Pos == ',') || (*Pos == ' ')))
+    {
+        Pos++;
+    }
+
+    p_Event->p_Payload = reinterpret_cast<const char*>(Pos);
+    p_Event->PayloadLength = static_cast<uint16_t>(p_End - Pos);
+}
+
+void RAK3172_EventParser_Reset(RAK3172_EventParser_t* p_Parser)
+{
+    memset(&p_Parser->Pending, 0, sizeof(RAK3172_Event_t));
+    p_Parser->Pending.Type = RAK_EVENT_NONE;
+}
+
+RAK3172_Event_Type_t RAK3172_EventParser_Parse(RAK3172_EventParser_t* p_Parser, const uint8_t* p_Buffer, size_t Length, RAK3172_Event_t* p_Event)
+{
+    size_t TokenLength;
+    const uint8_t* Token;
+    const uint8_t* Pos = p_Buffer;
+    const uint8_t* End = p_Buffer + Length;
+
+    if((p_Parser == NULL) || (p_Buffer == NULL) || (p_Event == NULL))
+    {
+        return RAK_EVENT_NONE;
+    }
+
+    // Ignore the line endings.
+    while((Pos < End) && ((*Pos == '\r') || (*Pos == '\n')))
+    {
+        Pos++;
+    }
+
+    while((End > Pos) && ((*(End - 1) == '\r') || (*(End - 1) == '\n')))
+    {
+        End--;
+    }
+
+    if(((End - Pos) < 5) || (memcmp(Pos, "+EVT:", 5) != 0))
+    {
+        // Any other message terminates a pending multi line event.
+        p_Parser->Pending.Type = RAK_EVENT_NONE;
+
+        return RAK_EVENT_NONE;
+    }
+
+    Pos += 5;
+    Token = Pos;
+    while((Pos < End) && (*Pos != ':') && (*Pos != ','))
+    {
+        Pos++;
+    }
+    TokenLength = Pos - Token;
+
+    // Continue a multi line event from a module with firmware 1.0.4 and below.
+    //  LoRaWAN:    +EVT:RX_1, RSSI -89, SNR 4
+    //              +EVT:UNICAST
+    //              +EVT:2:1234
+    //  P2P:        +EVT:RXP2P, RSSI -45, SNR 10
+    //              +EVT:1234
+    if(p_Parser->Pending.Type == RAK_EVENT_RX)
+    {
+        int32_t Port;
+        const uint8_t* Field = Token;
+
+        if(RAK3172_EventParser_Match(Token, TokenLength, "UNICAST") || RAK3172_EventParser_Match(Token, TokenLength, "MULCAST"))
+        {
+            return RAK_EVENT_PENDING;
+        }
+        else if(RAK3172_EventParser_Number(&Field, End, &Port) && (Field == Pos))
+        {
+            *p_Event = p_Parser->Pending;
+            p_Event->Port = static_cast<uint8_t>(Port);
+            RAK3172_EventParser_Payload(Pos, End, p_Event);
+            p_Parser->Pending.Type = RAK_EVENT_NONE;
+
+            return RAK_EVENT_RX;
+        }
+    }
+    else if((p_Parser->Pending.Type == RAK_EVENT_RX_P2P) && (Pos == End))
+    {
+        *p_Event = p_Parser->Pending;
+        RAK3172_EventParser_Payload(Token, End, p_Event);
+        p_Parser->Pending.Type = RAK_EVENT_NONE;
+
+        return RAK_EVENT_RX_P2P;
+    }
+
+    p_Parser->Pending.Type = RAK_EVENT_NONE;
+
+    memset(p_Event, 0, sizeof(RAK3172_Event_t));
+    p_Event->Type = RAK_EVENT_UNKNOWN;
+
+    if(RAK3172_EventParser_Match(Token, TokenLength, "JOINED"))
+    {
+        p_Event->Type = RAK_EVENT_JOINED;
+    }
+    else if(RAK3172_EventParser_Match(Token, TokenLength, "JOIN_FAILED", true))
+    {
+        p_Event->Type = RAK_EVENT_JOIN_FAILED;
+    }
+    else if(RAK3172_EventParser_Match(Token, TokenLength, "SEND_CONFIRMED_OK", true))
+    {
+        p_Event->Type = RAK_EVENT_CONFIRMED_OK;
+    }
+    else if(RAK3172_EventParser_Match(Token, TokenLength, "SEND_CONFIRMED_FAILED", true))
+    {
+        p_Event->Type = RAK_EVENT_CONFIRMED_FAILED;
+    }
+    else if(RAK3172_EventParser_Match(Token, TokenLength, "RXP2P_RECEIVE_TIMEOUT", true))
+    {
+        p_Event->Type = RAK_EVENT_RX_P2P_TIMEOUT;
+    }
+    else if(RAK3172_EventParser_Match(Token, TokenLength, "RXP2P"))
+    {
+        //  RUI3:       +EVT:RXP2P:-45:10:4142
+        if(RAK3172_EventParser_Quality(&Pos, End, p_Event) == false)
+        {
+            return RAK_EVENT_UNKNOWN;
+        }
+
+        p_Event->Type = RAK_EVENT_RX_P2P;
+
+        // The payload is transmitted with the next line.
+        if(Pos == End)
+        {
+            p_Parser->Pending = *p_Event;
+
+            return RAK_EVENT_PENDING;
+        }
+
+        RAK3172_EventParser_Payload(Pos, End, p_Event);
+    }
+    else if((TokenLength == 4) && RAK3172_EventParser_Match(Token, TokenLength, "RX_", true))
+    {
+        bool isLegacy;
+
+        //  RUI3:       +EVT:RX_1:-70:8:UNICAST:1:4865
+        switch(Token[3])
+        {
+            case '1':
+            {
+                p_Event->Group = RAK_RX_GROUP_1;
+
+                break;
+            }
+            case '2':
+            {
+                p_Event->Group = RAK_RX_GROUP_2;
+
+                break;
+            }
+            case 'B':
+            {
+                p_Event->Group = RAK_RX_GROUP_B;
+
+                break;
+            }
+            case 'C':
+            {
+                p_Event->Group = RAK_RX_GROUP_C;
+
+                break;
+            }
+            default:
+            {
+                return RAK_EVENT_UNKNOWN;
+            }
+        }
+
+        isLegacy = (Pos < End) && (*Pos == ',');
+
+        if(RAK3172_EventParser_Quality(&Pos, End, p_Event) == false)
+        {
+            return RAK_EVENT_UNKNOWN;
+        }
+
+        p_Event->Type = RAK_EVENT_RX;
+
+        // Port and payload are transmitted with the next lines.
+        if(isLegacy)
+        {
+            p_Parser->Pending = *p_Event;
+
+            return RAK_EVENT_PENDING;
+        }
+
+        // Skip the "UNICAST" or the "MULCAST" field.
+        if(Pos < End)
+        {
+            Pos++;
+        }
+
+        while((Pos < End) && (*Pos != ':'))
+        {
+            Pos++;
+        }
+
+        int32_t Port;
+        if(RAK3172_EventParser_Number(&Pos, End, &Port) == false)
+        {
+            return RAK_EVENT_UNKNOWN;
+        }
+
+        p_Event->Port = static_cast<uint8_t>(Port);
+        RAK3172_EventParser_Payload(Pos, End, p_Event);
+    }
+
+    return p_Event->Type;
+}
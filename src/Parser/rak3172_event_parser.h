@@ -0,0 +1,82 @@
+ /*
+ * rak3172_event_parser.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Event parser for the RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_EVENT_PARSER_H_
+#define RAK3172_EVENT_PARSER_H_
+
+#include <stddef.h>
+
+#include "rak3172_defs.h"
+
+/** @brief Event types reported by the module.
+ */
+typedef enum
+{
+    RAK_EVENT_NONE              = 0,    /**< The line is not an event. */
+    RAK_EVENT_PENDING,                  /**< The line is part of a multi line event and the event isn´t complete yet. */
+    RAK_EVENT_UNKNOWN,                  /**< Unknown or unsupported event. */
+    RAK_EVENT_JOINED,                   /**< LoRaWAN join was successful. */
+    RAK_EVENT_JOIN_FAILED,              /**< LoRaWAN join failed. */
+    RAK_EVENT_CONFIRMED_OK,             /**< LoRaWAN confirmed uplink was acknowledged. */
+    RAK_EVENT_CONFIRMED_FAILED,         /**< LoRaWAN confirmed uplink was not acknowledged. */
+    RAK_EVENT_RX,                       /**< LoRaWAN downlink received. */
+    RAK_EVENT_RX_P2P,                   /**< LoRa P2P message received. */
+    RAK_EVENT_RX_P2P_TIMEOUT,           /**< LoRa P2P receive timeout. */
+} RAK3172_Event_Type_t;
+
+/** @brief Decoded module event.
+ */
+typedef struct
+{
+    RAK3172_Event_Type_t Type;          /**< Event type. */
+    RAK3172_Rx_Group_t Group;           /**< Receive group.
+                                             NOTE: Only used by "RAK_EVENT_RX". */
+    int16_t RSSI;                       /**< Receiving RSSI value. */
+    int8_t SNR;                         /**< Receiving SNR value. */
+    uint8_t Port;                       /**< Port number.
+                                             NOTE: Only used by "RAK_EVENT_RX". */
+    const char* p_Payload;              /**< Pointer to the hex encoded payload inside of the parsed buffer. */
+    uint16_t PayloadLength;             /**< Length of the hex encoded payload. */
+} RAK3172_Event_t;
+
+/** @brief Event parser object.
+ *         NOTE: Module firmware 1.0.4 and below reports a downlink with multiple lines. The parser keeps the state between those lines.
+ */
+typedef struct
+{
+    RAK3172_Event_t Pending;            /**< Partially decoded multi line event. */
+} RAK3172_EventParser_t;
+
+/** @brief          Reset the state of an event parser.
+ *  @param p_Parser Pointer to event parser object
+ */
+void RAK3172_EventParser_Reset(RAK3172_EventParser_t* p_Parser);
+
+/** @brief          Parse a single line received from the module. Both, the RUI3 and the legacy event grammar are supported.
+ *                  The line is decoded in one forward scan without any memory allocation.
+ *                  NOTE: Leading and trailing line endings are ignored. The payload pointer of the event points into the parsed buffer.
+ *  @param p_Parser Pointer to event parser object
+ *  @param p_Buffer Pointer to received line
+ *  @param Length   Length of the received line
+ *  @param p_Event  Pointer to decoded event
+ *  @return         Event type
+ */
+RAK3172_Event_Type_t RAK3172_EventParser_Parse(RAK3172_EventParser_t* p_Parser, const uint8_t* p_Buffer, size_t Length, RAK3172_Event_t* p_Event);
+
+#endif /* RAK3172_EVENT_PARSER_H_ */
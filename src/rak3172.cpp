@@ -18,16 +18,30 @@
  */
 
 #include <algorithm>
+#include <string.h>
 
 #include <sdkconfig.h>
+#include <esp_rom_sys.h>
 
 #include "rak3172.h"
 
+#include "Buffer/rak3172_line_pool.h"
+#include "Codec/rak3172_hex.h"
+#include "Parser/rak3172_event_parser.h"
 #include "Arch/Logging/rak3172_logging.h"
+#include "Arch/Storage/rak3172_storage.h"
+#include "Arch/Timer/rak3172_timer.h"
 
 #define STRINGIFY(s)                            STR(s)
 #define STR(s)                                  #s
 
+#define RAK3172_SNAPSHOT_MAGIC                  (0x52414B00 ^ sizeof(RAK3172_Snapshot_t))
+
+/** @brief Width of the hardware reset pulse in microseconds.
+ *         NOTE: The STM32WL inside the module needs a NRST pulse of at least 350 ns. The remaining time is margin for the line capacitance.
+ */
+#define RAK3172_RESET_PULSE_US                  100
+
 #ifdef CONFIG_RAK3172_RESET_USE_HW
     static gpio_config_t _RAK3172_Reset_Config = {
         .pin_bit_mask       = 0,
@@ -59,49 +73,287 @@ static uart_config_t _RAK3172_UART_Config = {
 
 static const char* TAG      = "RAK3172";
 
-/** @brief          Receive the splash screen after a reset.
- *  @param p_Device RAK3172 device object
- *  @param Timeout  (Optional) Timeout for the splash screen in milliseconds
- *  @return         RAK3172_ERR_OK when successful
- */
-static RAK3172_Error_t RAK3172_ReceiveSplashScreen(RAK3172_t& p_Device, uint16_t Timeout = 1000)
-{
-    std::string* Response = NULL;
+#ifdef CONFIG_RAK3172_UART_BAUD_DISCOVERY
+    /** @brief Baud rates for the discovery. The first entry is used for the negotiation.
+     */
+    static const RAK3172_Baud_t _RAK3172_Baudrates[] = {
+        RAK_BAUD_115200,
+        RAK_BAUD_57600,
+        RAK_BAUD_38400,
+        RAK_BAUD_19200,
+        RAK_BAUD_9600,
+        RAK_BAUD_4800,
+    };
 
-    do
+    /** @brief          Check if the module answers with a given baud rate.
+     *  @param p_Device RAK3172 device object
+     *  @param Baudrate Baud rate
+     *  @return         true when the module answers
+     */
+    static bool RAK3172_ProbeBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate)
     {
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, Timeout / portTICK_PERIOD_MS) != pdPASS)
+        bool isFound;
+        RAK3172_Line_t* Response;
+
+        if(uart_set_baudrate(p_Device.UART.Interface, Baudrate) != ESP_OK)
         {
-            RAK3172_LOGE(TAG, "     Timeout!");
+            return false;
+        }
 
-            p_Device.Internal.isBusy = false;
+        uart_flush_input(p_Device.UART.Interface);
+        RAK3172_LinePool_Flush(p_Device);
 
-            return RAK3172_ERR_TIMEOUT;
-        }
+        // Use a second probe, because the first command may only wake up a sleeping module.
+        isFound = false;
+        for(uint8_t i = 0; (i < 2) && (isFound == false); i++)
+        {
+            uart_write_bytes(p_Device.UART.Interface, "AT\r\n", 4);
 
-        RAK3172_LOGD(TAG, "Response: %s", Response->c_str());
+            // Only accept the echo or the status. Lines received with a wrong baud rate contain garbage.
+            while((isFound == false) && ((Response = RAK3172_LinePool_Receive(p_Device, 2 * RAK3172_READY_PROBE_INTERVAL)) != NULL))
+            {
+                isFound = (strstr(Response->Data, "OK") != NULL) || (strcmp(Response->Data, "AT") == 0);
+                RAK3172_LinePool_Release(p_Device, Response);
+            }
+        }
 
-        // The driver was compiled for RUI3, but an older splash screen was received (version 1.4.0 and below).
-        #ifdef CONFIG_RAK3172_USE_RUI3
-            if(Response->find("Version.") != std::string::npos)
+        // Drop the remaining answers of the probes.
+        if(isFound)
+        {
+            while((Response = RAK3172_LinePool_Receive(p_Device, RAK3172_READY_PROBE_INTERVAL)) != NULL)
             {
-                RAK3172_LOGE(TAG, "Firmware compiled for RUI3, but module firmware does not support RUI3!");
+                RAK3172_LinePool_Release(p_Device, Response);
+            }
+        }
 
-                p_Device.Internal.isBusy = false;
+        return isFound;
+    }
+
+    /** @brief          Find the baud rate of the module. The stored baud rate is tested first.
+     *  @param p_Device RAK3172 device object
+     *  @return         RAK3172_ERR_OK when successful
+     *                  RAK3172_ERR_TIMEOUT when the module does not answer with any baud rate
+     */
+    static RAK3172_Error_t RAK3172_DiscoverBaudrate(RAK3172_t& p_Device)
+    {
+        bool isFound;
+        RAK3172_Baud_t Baudrate;
 
-                return RAK3172_ERR_INVALID_RESPONSE;
+        Baudrate = p_Device.UART.Baudrate;
+
+        #ifdef CONFIG_RAK3172_UART_BAUD_PERSIST
+            uint32_t Stored;
+
+            if(RAK3172_Storage_Read(RAK3172_STORAGE_KEY_BAUDRATE, &Stored) == RAK3172_ERR_OK)
+            {
+                Baudrate = static_cast<RAK3172_Baud_t>(Stored);
             }
         #endif
 
-        if((Response->find("LoRaWAN.") != std::string::npos) || (Response->find("LoRa P2P.") != std::string::npos))
+        isFound = RAK3172_ProbeBaudrate(p_Device, Baudrate);
+        if(isFound == false)
+        {
+            RAK3172_LOGW(TAG, "No response with %u baud. Start baud rate discovery...", static_cast<uint32_t>(Baudrate));
+
+            for(uint8_t i = 0; (i < (sizeof(_RAK3172_Baudrates) / sizeof(_RAK3172_Baudrates[0]))) && (isFound == false); i++)
+            {
+                if(_RAK3172_Baudrates[i] == Baudrate)
+                {
+                    continue;
+                }
+
+                isFound = RAK3172_ProbeBaudrate(p_Device, _RAK3172_Baudrates[i]);
+                if(isFound)
+                {
+                    Baudrate = _RAK3172_Baudrates[i];
+                }
+            }
+        }
+
+        if(isFound == false)
         {
-            p_Device.Internal.isBusy = false;
+            RAK3172_LOGE(TAG, "Module not found!");
+
+            uart_set_baudrate(p_Device.UART.Interface, p_Device.UART.Baudrate);
+
+            return RAK3172_ERR_TIMEOUT;
         }
 
-        delete Response;
-    } while(p_Device.Internal.isBusy);
+        RAK3172_LOGI(TAG, "     Module found with %u baud", static_cast<uint32_t>(Baudrate));
 
-    return RAK3172_ERR_OK;
+        p_Device.UART.Baudrate = Baudrate;
+        _RAK3172_UART_Config.baud_rate = Baudrate;
+
+        return RAK3172_ERR_OK;
+    }
+#endif
+
+/** @brief          Process an event reported by the module.
+ *  @param p_Device Pointer to RAK3172 device object
+ *  @param p_Event  Pointer to decoded event
+ */
+static void RAK3172_HandleEvent(RAK3172_t* p_Device, const RAK3172_Event_t* p_Event)
+{
+    switch(p_Event->Type)
+    {
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+            // Join was successful.
+            case RAK_EVENT_JOINED:
+            {
+                if(p_Device->Mode != RAK_MODE_LORAWAN)
+                {
+                    break;
+                }
+
+                RAK3172_LOGD(TAG, " Joined...");
+
+                #ifndef CONFIG_RAK3172_USE_RUI3
+                    p_Device->Internal.isJoinEvent = true;
+                #endif
+
+                p_Device->Internal.isBusy = false;
+                p_Device->LoRaWAN.isJoined = true;
+
+                // The join accept can change the receive delays.
+                p_Device->Cache.Valid &= ~RAK3172_CACHE_RX2_DELAY;
+
+                xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_JOINED);
+
+                break;
+            }
+            // Join failed.
+            case RAK_EVENT_JOIN_FAILED:
+            {
+                if(p_Device->Mode != RAK_MODE_LORAWAN)
+                {
+                    break;
+                }
+
+                RAK3172_LOGD(TAG, " Not joined...");
+
+                if(p_Device->LoRaWAN.AttemptCounter > 0)
+                {
+                    p_Device->LoRaWAN.AttemptCounter--;
+                }
+
+                p_Device->LoRaWAN.isJoined = false;
+
+                // Firmware without RUI3 needs a new join request from the driver for each attempt. So each failed attempt is reported.
+                #ifndef CONFIG_RAK3172_USE_RUI3
+                    p_Device->Internal.isBusy = false;
+                    p_Device->Internal.isJoinEvent = true;
+                    xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_JOIN_FAILED);
+                #else
+                    if(p_Device->LoRaWAN.AttemptCounter == 0)
+                    {
+                        p_Device->Internal.isBusy = false;
+                        xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_JOIN_FAILED);
+                    }
+                #endif
+
+                break;
+            }
+            // Transmission failed.
+            case RAK_EVENT_CONFIRMED_FAILED:
+            {
+                if(p_Device->Mode != RAK_MODE_LORAWAN)
+                {
+                    break;
+                }
+
+                p_Device->Internal.isBusy = false;
+                p_Device->LoRaWAN.ConfirmError = true;
+                xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_CONFIRMED_FAILED);
+
+                break;
+            }
+            // Transmission was successful.
+            case RAK_EVENT_CONFIRMED_OK:
+            {
+                if(p_Device->Mode != RAK_MODE_LORAWAN)
+                {
+                    break;
+                }
+
+                p_Device->Internal.isBusy = false;
+                p_Device->LoRaWAN.ConfirmError = false;
+                xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_CONFIRMED_OK);
+
+                break;
+            }
+            case RAK_EVENT_RX:
+            {
+                RAK3172_Rx_t Received;
+
+                if(p_Device->Mode != RAK_MODE_LORAWAN)
+                {
+                    break;
+                }
+
+                Received.Group = p_Event->Group;
+                Received.RSSI = p_Event->RSSI;
+                Received.SNR = p_Event->SNR;
+                Received.Port = p_Event->Port;
+                Received.Length = RAK3172_Hex_Decode(p_Event->p_Payload, p_Event->PayloadLength, Received.Payload, sizeof(Received.Payload));
+
+                RAK3172_LOGI(TAG, "RSSI: %i", Received.RSSI);
+                RAK3172_LOGI(TAG, "SNR: %i", Received.SNR);
+                RAK3172_LOGI(TAG, "Port: %u", Received.Port);
+                RAK3172_LOGI(TAG, "Channel: %u", Received.Group);
+                RAK3172_LOGI(TAG, "Payload: %.*s", p_Event->PayloadLength, p_Event->p_Payload);
+
+                if(xQueueSend(p_Device->Internal.ReceiveQueue, &Received, 0) != pdPASS)
+                {
+                    RAK3172_LOGW(TAG, "Receive queue full. Drop message!");
+                }
+
+                break;
+            }
+        #endif
+        #ifdef CONFIG_RAK3172_MODE_WITH_P2P
+            case RAK_EVENT_RX_P2P_TIMEOUT:
+            {
+                if(p_Device->Mode != RAK_MODE_P2P)
+                {
+                    break;
+                }
+
+                p_Device->P2P.isRxTimeout = true;
+
+                break;
+            }
+            case RAK_EVENT_RX_P2P:
+            {
+                RAK3172_Rx_t Received;
+
+                if(p_Device->Mode != RAK_MODE_P2P)
+                {
+                    break;
+                }
+
+                Received.Group = RAK_RX_GROUP_1;
+                Received.RSSI = p_Event->RSSI;
+                Received.SNR = p_Event->SNR;
+                Received.Port = 0;
+                Received.Length = RAK3172_Hex_Decode(p_Event->p_Payload, p_Event->PayloadLength, Received.Payload, sizeof(Received.Payload));
+
+                RAK3172_LOGD(TAG, "RSSI: %i", Received.RSSI);
+                RAK3172_LOGD(TAG, "SNR: %i", Received.SNR);
+                RAK3172_LOGD(TAG, "Payload: %.*s", p_Event->PayloadLength, p_Event->p_Payload);
+
+                if(xQueueSend(p_Device->Internal.ReceiveQueue, &Received, 0) != pdPASS)
+                {
+                    RAK3172_LOGW(TAG, "Receive queue full. Drop message!");
+                }
+
+                break;
+            }
+        #endif
+        default:
+        {
+            break;
+        }
+    }
 }
 
 /** @brief          UART receive task.
@@ -110,8 +362,11 @@ static RAK3172_Error_t RAK3172_ReceiveSplashScreen(RAK3172_t& p_Device, uint16_t
 static void RAK3172_UART_EventTask(void* p_Arg)
 {
     uart_event_t Event;
+    RAK3172_EventParser_t Parser;
     RAK3172_t* Device = (RAK3172_t*)p_Arg;
 
+    RAK3172_EventParser_Reset(&Parser);
+
     RAK3172_LOGD(TAG, "Start RAK3172 event task");
 
     while(true)
@@ -128,7 +383,7 @@ static void RAK3172_UART_EventTask(void* p_Arg)
                     ESP_LOGW(TAG, "HW FIFO Overflow");
 
                     uart_flush(Device->UART.Interface);
-                    xQueueReset(Device->Internal.MessageQueue);
+                    RAK3172_LinePool_Flush(*Device);
 
                     break;
                 }
@@ -137,7 +392,7 @@ static void RAK3172_UART_EventTask(void* p_Arg)
                     ESP_LOGW(TAG, "Ring Buffer Full");
 
                     uart_flush(Device->UART.Interface);
-                    xQueueReset(Device->Internal.MessageQueue);
+                    RAK3172_LinePool_Flush(*Device);
 
                     break;
                 }
@@ -150,12 +405,13 @@ static void RAK3172_UART_EventTask(void* p_Arg)
                     if(PatternPos == -1)
                     {
                         uart_flush_input(Device->UART.Interface);
-                        xQueueReset(Device->Internal.MessageQueue);
+                        RAK3172_LinePool_Flush(*Device);
                     }
                     else
                     {
                         int BytesRead;
-                        std::string* Response = new std::string();
+                        RAK3172_Line_t* Line;
+                        RAK3172_Event_t ModuleEvent;
 
                         RAK3172_LOGD(TAG, "     Pattern detected at position %u. Use buffered size: %u", static_cast<unsigned int>(PatternPos), static_cast<unsigned int>(BufferedSize));
 
@@ -163,13 +419,32 @@ static void RAK3172_UART_EventTask(void* p_Arg)
                         if(BytesRead == -1)
                         {
                             uart_flush(Device->UART.Interface);
-                            xQueueReset(Device->Internal.MessageQueue);
+                            RAK3172_LinePool_Flush(*Device);
 
                             break;
                         }
 
-                        // Copy the data from the buffer into the string.
-                        for(uint32_t i = 0; i < BytesRead; i++)
+                        // Decode events directly from the receive buffer. All other messages are passed to the application.
+                        if(RAK3172_EventParser_Parse(&Parser, Device->Internal.RxBuffer, BytesRead, &ModuleEvent) != RAK_EVENT_NONE)
+                        {
+                            RAK3172_LOGD(TAG, "Event: %.*s", BytesRead, Device->Internal.RxBuffer);
+
+                            RAK3172_HandleEvent(Device, &ModuleEvent);
+
+                            break;
+                        }
+
+                        Line = RAK3172_LinePool_Take(*Device);
+                        if(Line == NULL)
+                        {
+                            RAK3172_LOGW(TAG, "No free line buffer available. Drop line!");
+
+                            break;
+                        }
+
+                        // Copy the data from the buffer into the line buffer.
+                        Line->Length = 0;
+                        for(int i = 0; (i < BytesRead) && (Line->Length < CONFIG_RAK3172_UART_LINE_LENGTH); i++)
                         {
                             char Character;
 
@@ -177,225 +452,14 @@ static void RAK3172_UART_EventTask(void* p_Arg)
 
                             if((Character != '\n') && (Character != '\r'))
                             {
-                                *Response += Character;
+                                Line->Data[Line->Length++] = Character;
                             }
                         }
+                        Line->Data[Line->Length] = '\0';
 
-                        RAK3172_LOGD(TAG, "     Response: %s", Response->c_str());
+                        RAK3172_LOGD(TAG, "     Response: %s", Line->Data);
 
-                        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
-                            if((Device->Mode == RAK_MODE_LORAWAN) && (Response->find("+EVT") != std::string::npos))
-                            {
-                                RAK3172_LOGD(TAG, "Event: %s", Response->c_str());
-
-                                // Join was successful.
-                                if(Response->find("JOINED") != std::string::npos)
-                                {
-                                    RAK3172_LOGD(TAG, " Joined...");
-
-                                    #ifndef CONFIG_RAK3172_USE_RUI3
-                                        Device->Internal.isJoinEvent = true;
-                                    #endif
-
-                                    Device->Internal.isBusy = false;
-                                    Device->LoRaWAN.isJoined = true;
-                                }
-                                // Join failed.
-                                #ifdef CONFIG_RAK3172_USE_RUI3
-                                    else if(Response->find("JOIN_FAILED_RX_TIMEOUT") != std::string::npos)
-                                #else
-                                    else if(Response->find("JOIN FAILED") != std::string::npos)
-                                #endif
-                                {
-                                    RAK3172_LOGD(TAG, " Not joined...");
-
-                                    if(Device->LoRaWAN.AttemptCounter > 0)
-                                    {
-                                        Device->LoRaWAN.AttemptCounter--;
-                                    }
-                                    else
-                                    {
-                                        Device->Internal.isBusy = false;
-                                    }
-
-                                    #ifndef CONFIG_RAK3172_USE_RUI3
-                                        Device->Internal.isBusy = false;
-                                        Device->Internal.isJoinEvent = true;
-                                    #endif
-
-                                    Device->LoRaWAN.isJoined = false;
-                                }
-                                // Transmission failed.
-                                #ifdef CONFIG_RAK3172_USE_RUI3
-                                    else if(Response->find("SEND_CONFIRMED_FAILED") != std::string::npos)
-                                #else
-                                    else if(Response->find("SEND CONFIRMED FAILED") != std::string::npos)
-                                #endif
-                                {
-                                    Device->Internal.isBusy = false;
-                                    Device->LoRaWAN.ConfirmError = true;
-                                }
-                                // Transmission was successful.
-                                #ifdef CONFIG_RAK3172_USE_RUI3
-                                    else if(Response->find("SEND_CONFIRMED_OK") != std::string::npos)
-                                #else
-                                    else if(Response->find("SEND CONFIRMED OK") != std::string::npos)
-                                #endif
-                                {
-                                    Device->Internal.isBusy = false;
-                                    Device->LoRaWAN.ConfirmError = false;
-                                }
-                                else if(Response->find("RX") != std::string::npos)
-                                {
-                                    size_t Index;
-                                    std::string Dummy;
-                                    RAK3172_Rx_t* Received = new RAK3172_Rx_t();
-
-                                    // Formats documentation:
-                                    //  FW 1.03     +EVT:RX_1, RSSI -89, SNR 4
-
-                                    // Remove "+EVT:" from the response.
-                                    Response->erase(Response->find("+EVT:"), std::string("+EVT:").length());
-
-                                    // Get the channel number from the "RX_x" part of the response.
-                                    Index = Response->find("RX");
-
-                                    if(Response->at(Index + 1) == '1')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_1;
-                                    }
-                                    else if(Response->at(Index + 1) == '2')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_2;
-                                    }
-                                    else if(Response->at(Index + 1) == 'B')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_B;
-                                    }
-                                    else if(Response->at(Index + 1) == 'C')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_C;
-                                    }
-
-                                    // Remove the "RX_x" from the response.
-                                    Response->erase(0, sizeof("RX_x"));
-
-                                    // Get the RSSI value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("RSSI").length() + 1, Response->find(","));
-                                        Response->erase(0, std::string(Dummy).length() + 2);
-                                    #endif
-                                    Received->RSSI = std::stoi(Dummy);
-
-                                    // Get the SNR value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("SNR").length() + 1, Response->find(","));
-                                    #endif
-                                    Received->SNR = std::stoi(Dummy);
-
-                                    #ifndef CONFIG_RAK3172_USE_RUI3
-                                        // The payload is stored in the next line.
-                                        char Data;
-                                        int Bytes;
-
-                                        Response->clear();
-                                        do
-                                        {
-                                            Bytes = uart_read_bytes(Device->UART.Interface, &Data, 1, 10);
-                                            if((Bytes != 0) && (Data != '\r') && (Data != '\n'))
-                                            {
-                                                *Response += Data;
-                                            }
-                                        } while(Bytes != 0);
-
-                                        RAK3172_LOGD(TAG, "Next line: %s", Response->c_str());
-
-                                        // Remove all "+EVT" strings.
-                                        Response->erase(0, std::string("+EVT:").length());
-                                        Response->erase(Response->find("+EVT"), std::string("+EVT").length());
-                                    #endif
-
-                                    // Remove the "UNICAST" or the "MULCAST" from the message.
-                                    Response->erase(0, Response->find(":") + 1);
-
-                                    // Get the communication port.
-                                    Dummy = Response->substr(0, Response->find(":"));
-                                    Response->erase(Response->find(Dummy), std::string(Dummy + ":").length());
-                                    Received->Port = std::stoi(Dummy);
-
-                                    // Get the payload.
-                                    Received->Payload = *Response;
-
-                                    RAK3172_LOGI(TAG, "RSSI: %i", Received->RSSI);
-                                    RAK3172_LOGI(TAG, "SNR: %i", Received->SNR);
-                                    RAK3172_LOGI(TAG, "Port: %u", Received->Port);
-                                    RAK3172_LOGI(TAG, "Channel: %u", Received->Group);
-                                    RAK3172_LOGI(TAG, "Payload: %s", Received->Payload.c_str());
-
-                                    xQueueSend(Device->Internal.ReceiveQueue, &Received, 0);
-                                }
-
-                                delete Response;
-                            }
-                        #endif
-                        #ifdef CONFIG_RAK3172_MODE_WITH_P2P
-                            if((Device->Mode == RAK_MODE_P2P) && (Response->find("+EVT") != std::string::npos))
-                            {
-                                RAK3172_LOGD(TAG, "Event: %s", Response->c_str());
-
-                                if(Response->find("+EVT:RXP2P RECEIVE TIMEOUT") != std::string::npos)
-                                {
-                                    Device->P2P.isRxTimeout = true;
-                                }
-                                else if(Response->find("RX") != std::string::npos)
-                                {
-                                    std::string Dummy;
-                                    RAK3172_Rx_t* Received = new RAK3172_Rx_t();
-
-                                    // Remove "+EVT:RXP2P:" from the response.
-                                    Response->erase(Response->find("+EVT:"), std::string("+EVT:").length() + 6);
-
-                                    // Get the RSSI value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("RSSI").length() + 1, Response->find(","));
-                                        Response->erase(0, std::string(Dummy + ":").length() + 1);
-                                    #endif
-                                    Received->RSSI = std::stoi(Dummy);
-
-                                    // Get the SNR value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("SNR").length() + 1, Response->find(","));
-                                    #endif
-                                    Received->SNR = std::stoi(Dummy);
-
-                                    // Get the payload.
-                                    Received->Payload = *Response;
-
-                                    RAK3172_LOGD(TAG, "RSSI: %i", Received->RSSI);
-                                    RAK3172_LOGD(TAG, "SNR: %i", Received->SNR);
-                                    RAK3172_LOGD(TAG, "Payload: %s", Received->Payload.c_str());
-
-                                    xQueueSend(Device->Internal.ReceiveQueue, &Received, 0);
-                                }
-                            }
-                            // Any other messages from the module.
-                            else
-                        #endif
-                        {
-                            xQueueSend(Device->Internal.MessageQueue, &Response, 0);
-                        }
+                        RAK3172_LinePool_Push(*Device, Line);
                     }
 
                     break;
@@ -437,6 +501,7 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
     RAK3172_LOGI(TAG, "     Buffer size: %u", CONFIG_RAK3172_UART_BUFFER_SIZE);
     RAK3172_LOGI(TAG, "     Stack size: %u", CONFIG_RAK3172_TASK_STACK_SIZE);
     RAK3172_LOGI(TAG, "     Queue length: %u", CONFIG_RAK3172_UART_QUEUE_LENGTH);
+    RAK3172_LOGI(TAG, "     Line pool: %u x %u", CONFIG_RAK3172_UART_LINE_POOL_SIZE, CONFIG_RAK3172_UART_LINE_LENGTH);
     RAK3172_LOGI(TAG, "     Rx: %u", p_Device.UART.Rx);
     RAK3172_LOGI(TAG, "     Tx: %u", p_Device.UART.Tx);
     RAK3172_LOGI(TAG, "     Baudrate: %u", p_Device.UART.Baudrate);
@@ -459,15 +524,13 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    p_Device.Internal.MessageQueue = xQueueCreate(CONFIG_RAK3172_UART_QUEUE_LENGTH, sizeof(std::string*));
-    if(p_Device.Internal.MessageQueue == NULL)
+    Error = RAK3172_LinePool_Init(p_Device);
+    if(Error != RAK3172_ERR_OK)
     {
-        Error = RAK3172_ERR_NO_MEM;
-
         goto RAK3172_BasicInit_Error_1;
     }
 
-    p_Device.Internal.ReceiveQueue = xQueueCreate(8, sizeof(RAK3172_Rx_t*));
+    p_Device.Internal.ReceiveQueue = xQueueCreate(8, sizeof(RAK3172_Rx_t));
     if(p_Device.Internal.ReceiveQueue == NULL)
     { 
         Error = RAK3172_ERR_NO_MEM;
@@ -483,8 +546,24 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
         goto RAK3172_BasicInit_Error_3;
     }
 
-    #ifdef CONFIG_RAK3172_TASK_CORE_AFFINITY
-        xTaskCreatePinnedToCore(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle, CONFIG_RAK3172_TASK_CORE);
+    p_Device.Internal.Lock = xSemaphoreCreateRecursiveMutex();
+    if(p_Device.Internal.Lock == NULL)
+    {
+        Error = RAK3172_ERR_NO_MEM;
+
+        goto RAK3172_BasicInit_Error_4;
+    }
+
+    p_Device.Internal.Events = xEventGroupCreate();
+    if(p_Device.Internal.Events == NULL)
+    {
+        Error = RAK3172_ERR_NO_MEM;
+
+        goto RAK3172_BasicInit_Error_5;
+    }
+
+    #ifdef CONFIG_RAK3172_TASK_CORE_USE_AFFINITY
+        xTaskCreatePinnedToCore(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, &p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle, CONFIG_RAK3172_TASK_CORE);
     #else
         xTaskCreate(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, &p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle);
     #endif
@@ -493,34 +572,45 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
     {
         Error = RAK3172_ERR_NO_MEM;
 
-        goto RAK3172_BasicInit_Error_4;
+        goto RAK3172_BasicInit_Error_6;
     }
 
     if(uart_flush(p_Device.UART.Interface))
     {
         Error = RAK3172_ERR_INVALID_STATE;
 
-        goto RAK3172_BasicInit_Error_4;
+        goto RAK3172_BasicInit_Error_7;
     }
 
-    xQueueReset(p_Device.Internal.MessageQueue);
+    RAK3172_LinePool_Flush(p_Device);
     p_Device.Internal.isInitialized = true;
 
     return RAK3172_ERR_OK;
 
-RAK3172_BasicInit_Error_4:
+RAK3172_BasicInit_Error_7:
     vTaskSuspend(p_Device.Internal.Handle);
     vTaskDelete(p_Device.Internal.Handle);
 
-RAK3172_BasicInit_Error_3:
+RAK3172_BasicInit_Error_6:
+    vEventGroupDelete(p_Device.Internal.Events);
+    p_Device.Internal.Events = NULL;
+
+RAK3172_BasicInit_Error_5:
+    vSemaphoreDelete(p_Device.Internal.Lock);
+    p_Device.Internal.Lock = NULL;
+
+RAK3172_BasicInit_Error_4:
     free(p_Device.Internal.RxBuffer);
+    p_Device.Internal.RxBuffer = NULL;
 
-RAK3172_BasicInit_Error_2:
+RAK3172_BasicInit_Error_3:
     vQueueDelete(p_Device.Internal.ReceiveQueue);
+    p_Device.Internal.ReceiveQueue = NULL;
 
-RAK3172_BasicInit_Error_1:
-    vQueueDelete(p_Device.Internal.MessageQueue);
+RAK3172_BasicInit_Error_2:
+    RAK3172_LinePool_Deinit(p_Device);
 
+RAK3172_BasicInit_Error_1:
     uart_driver_delete(p_Device.UART.Interface);
 
 	p_Device.Internal.isInitialized = false;
@@ -528,6 +618,16 @@ RAK3172_BasicInit_Error_1:
     return Error;
 }
 
+std::string RAK3172_Rx_GetPayload(const RAK3172_Rx_t& p_Message)
+{
+    std::string Payload;
+
+    Payload.resize(p_Message.Length * 2);
+    RAK3172_Hex_Encode(p_Message.Payload, p_Message.Length, &Payload[0]);
+
+    return Payload;
+}
+
 RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
 {
     std::string Response;
@@ -541,6 +641,7 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
 
     p_Device.Internal.isInitialized = false;
     p_Device.Internal.isBusy = false;
+    p_Device.Internal.isEchoDisabled = false;
 
     RAK3172_LOGI(TAG, "Use library version: %s", RAK3172_LibVersion().c_str());
 
@@ -599,35 +700,39 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
     #endif
 
     RAK3172_ERROR_CHECK(RAK3172_BasicInit(p_Device));
+    RAK3172_Cache_Invalidate(p_Device);
+
+    // Find the module before the reset, because the reset needs a working communication.
+    #ifdef CONFIG_RAK3172_UART_BAUD_DISCOVERY
+        RAK3172_ERROR_CHECK(RAK3172_DiscoverBaudrate(p_Device));
+    #endif
 
+    // The reset functions return as soon as the module is ready. No additional delay is needed here.
     #ifdef CONFIG_RAK3172_RESET_USE_HW
         RAK3172_ERROR_CHECK(RAK3172_HardReset(p_Device));
     #else
         RAK3172_ERROR_CHECK(RAK3172_SoftReset(p_Device));
     #endif
 
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-
     // Firmware without RUI3 will produce a MIC mismatch when using a factory reset during the initialization.
     #if((defined CONFIG_RAK3172_FACTORY_RESET) && (defined CONFIG_RAK3172_USE_RUI3))
         RAK3172_ERROR_CHECK(RAK3172_FactoryReset(p_Device));
     #endif
 
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-
     // Check if echo mode is enabled.
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT", NULL, &Response));
     RAK3172_LOGD(TAG, "Response from 'AT': %s", Response.c_str());
     if(Response.find("OK") == std::string::npos)
     {
-        std::string* Dummy;
+        RAK3172_Line_t* Dummy;
 
         // Echo mode is enabled. Need to receive one more line.
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+        Dummy = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+        if(Dummy == NULL)
         {
             return RAK3172_ERR_TIMEOUT;
         }
-        delete Dummy;
+        RAK3172_LinePool_Release(p_Device, Dummy);
 
         RAK3172_LOGD(TAG, "Echo mode enabled. Disabling echo mode...");
 
@@ -637,33 +742,55 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
         //  -> Receive the value
         //  -> Receive the status
         uart_write_bytes(p_Device.UART.Interface, "ATE\r\n", std::string("ATE\r\n").length());
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+        Dummy = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+        if(Dummy == NULL)
         {
             return RAK3172_ERR_TIMEOUT;
         }
-        delete Dummy;
+        RAK3172_LinePool_Release(p_Device, Dummy);
 
         #ifndef CONFIG_RAK3172_USE_RUI3
-            if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+            Dummy = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+            if(Dummy == NULL)
             {
                 return RAK3172_ERR_TIMEOUT;
             }
-            delete Dummy;
+            RAK3172_LinePool_Release(p_Device, Dummy);
         #endif
 
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+        Dummy = RAK3172_LinePool_Receive(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT);
+        if(Dummy == NULL)
         {
             return RAK3172_ERR_TIMEOUT;
         }
 
         // Error during initialization when everything else except 'OK' is received.
-        if(Dummy->find("OK") == std::string::npos)
+        if(strstr(Dummy->Data, "OK") == NULL)
         {
+            RAK3172_LinePool_Release(p_Device, Dummy);
+
             return RAK3172_ERR_TIMEOUT;
         }
-        delete Dummy;
+        RAK3172_LinePool_Release(p_Device, Dummy);
     }
 
+    p_Device.Internal.isEchoDisabled = true;
+
+    // Switch to the fastest baud rate and store it for the next start.
+    #ifdef CONFIG_RAK3172_UART_BAUD_DISCOVERY
+        if((p_Device.UART.Baudrate != _RAK3172_Baudrates[0]) && (RAK3172_SetBaudrate(p_Device, _RAK3172_Baudrates[0]) != RAK3172_ERR_OK))
+        {
+            RAK3172_LOGW(TAG, "Can not switch to %u baud. Use %u baud...", static_cast<uint32_t>(_RAK3172_Baudrates[0]), static_cast<uint32_t>(p_Device.UART.Baudrate));
+        }
+
+        #ifdef CONFIG_RAK3172_UART_BAUD_PERSIST
+            if(RAK3172_Storage_Write(RAK3172_STORAGE_KEY_BAUDRATE, p_Device.UART.Baudrate) != RAK3172_ERR_OK)
+            {
+                RAK3172_LOGW(TAG, "Can not store the baud rate!");
+            }
+        #endif
+    #endif
+
     if(p_Device.Info != NULL)
     {
         RAK3172_ERROR_CHECK(RAK3172_GetFWVersion(p_Device, &p_Device.Info->Firmware) | RAK3172_GetSerialNumber(p_Device, &p_Device.Info->Serial));
@@ -685,6 +812,14 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
         return;
     }
 
+    #ifdef CONFIG_RAK3172_ASYNC_ENABLE
+        RAK3172_Async_Deinit(p_Device);
+    #endif
+
+    #ifdef CONFIG_RAK3172_UPLINK_ENABLE
+        RAK3172_LoRaWAN_Uplink_Deinit(p_Device);
+    #endif
+
     vTaskSuspend(p_Device.Internal.Handle);
     vTaskDelete(p_Device.Internal.Handle);
 
@@ -694,10 +829,7 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
         uart_driver_delete(p_Device.UART.Interface);
     }
 
-    if(p_Device.Internal.MessageQueue != NULL)
-    {
-        vQueueDelete(p_Device.Internal.MessageQueue);
-    }
+    RAK3172_LinePool_Deinit(p_Device);
 
     if(p_Device.Internal.ReceiveQueue != NULL)
     {
@@ -707,6 +839,18 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
     free(p_Device.Internal.RxBuffer);
     p_Device.Internal.RxBuffer = NULL;
 
+    if(p_Device.Internal.Events != NULL)
+    {
+        vEventGroupDelete(p_Device.Internal.Events);
+        p_Device.Internal.Events = NULL;
+    }
+
+    if(p_Device.Internal.Lock != NULL)
+    {
+        vSemaphoreDelete(p_Device.Internal.Lock);
+        p_Device.Internal.Lock = NULL;
+    }
+
     gpio_reset_pin(static_cast<gpio_num_t>(p_Device.UART.Rx));
     gpio_reset_pin(static_cast<gpio_num_t>(p_Device.UART.Tx));
 
@@ -716,30 +860,91 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
 
 RAK3172_Error_t RAK3172_SetBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate)
 {
-    if(p_Device.UART.Baudrate == Baudrate)
+    TickType_t Start;
+    RAK3172_Error_t Error;
+
+    if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+    else if(p_Device.UART.Baudrate == Baudrate)
     {
         return RAK3172_ERR_OK;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAUD=" + std::to_string(Baudrate)));
+    // Hold the lock during the whole switch. Other tasks must not communicate with the module while the baud rates don´t match.
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
 
-    // Deinitialize the UART interface.
-    if(uart_driver_delete(p_Device.UART.Interface))
+    Error = RAK3172_SendCommand(p_Device, "AT+BAUD=" + std::to_string(Baudrate));
+    if(Error != RAK3172_ERR_OK)
     {
-        return RAK3172_ERR_INVALID_STATE;
+        goto RAK3172_SetBaudrate_Exit;
     }
 
-    // Initialize the interface with the new baudrate. Do a rollback if something is going wrong.
-    _RAK3172_UART_Config.baud_rate = Baudrate;
-    if(RAK3172_BasicInit(p_Device) != RAK3172_ERR_OK)
+    // The module answers with the old baud rate. Change the line rate of the running driver afterwards.
+    uart_wait_tx_done(p_Device.UART.Interface, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS);
+    if(uart_set_baudrate(p_Device.UART.Interface, Baudrate) != ESP_OK)
     {
-        _RAK3172_UART_Config.baud_rate = p_Device.UART.Baudrate;
-        RAK3172_ERROR_CHECK(RAK3172_BasicInit(p_Device));
+        Error = RAK3172_ERR_INVALID_STATE;
+
+        goto RAK3172_SetBaudrate_Exit;
     }
+    uart_flush_input(p_Device.UART.Interface);
+
+    // Verify the link with the new baud rate.
+    Start = xTaskGetTickCount();
+    Error = RAK3172_SendCommand(p_Device, "AT");
+    if(Error != RAK3172_ERR_OK)
+    {
+        RAK3172_LOGE(TAG, "No response with %u baud. Rollback to %u baud...", static_cast<uint32_t>(Baudrate), static_cast<uint32_t>(p_Device.UART.Baudrate));
 
+        // Restore the old line rate. The module is still usable when it has rejected the new baud rate.
+        uart_set_baudrate(p_Device.UART.Interface, p_Device.UART.Baudrate);
+        uart_flush_input(p_Device.UART.Interface);
+        if(RAK3172_SendCommand(p_Device, "AT") == RAK3172_ERR_OK)
+        {
+            Error = RAK3172_ERR_FAIL;
+
+            goto RAK3172_SetBaudrate_Exit;
+        }
+
+        // The module doesn´t answer with the old baud rate. Retry with the new baud rate, because the first verification can get lost
+        // while the module switches the line rate, and move the module back to the old baud rate.
+        RAK3172_LOGW(TAG, "No response with %u baud. Retry with %u baud...", static_cast<uint32_t>(p_Device.UART.Baudrate), static_cast<uint32_t>(Baudrate));
+        uart_set_baudrate(p_Device.UART.Interface, Baudrate);
+        uart_flush_input(p_Device.UART.Interface);
+        if((RAK3172_SendCommand(p_Device, "AT") == RAK3172_ERR_OK) && (RAK3172_SendCommand(p_Device, "AT+BAUD=" + std::to_string(p_Device.UART.Baudrate)) == RAK3172_ERR_OK))
+        {
+            uart_wait_tx_done(p_Device.UART.Interface, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS);
+            uart_set_baudrate(p_Device.UART.Interface, p_Device.UART.Baudrate);
+            uart_flush_input(p_Device.UART.Interface);
+            if(RAK3172_SendCommand(p_Device, "AT") == RAK3172_ERR_OK)
+            {
+                Error = RAK3172_ERR_FAIL;
+
+                goto RAK3172_SetBaudrate_Exit;
+            }
+        }
+
+        // Neither baud rate works. Leave the driver with the old baud rate, because a module reset restores it.
+        RAK3172_LOGE(TAG, "Baud rate of the module is unknown!");
+        uart_set_baudrate(p_Device.UART.Interface, p_Device.UART.Baudrate);
+        uart_flush_input(p_Device.UART.Interface);
+        Error = RAK3172_ERR_BAUDRATE_UNKNOWN;
+
+        goto RAK3172_SetBaudrate_Exit;
+    }
+
+    RAK3172_LOGI(TAG, "Baud rate changed to %u. Command round trip: %lu ms", static_cast<uint32_t>(Baudrate), static_cast<unsigned long>((xTaskGetTickCount() - Start) * portTICK_PERIOD_MS));
+
+    // Use the new baud rate when the driver is initialized again (i. e. after a wake up).
     p_Device.UART.Baudrate = Baudrate;
+    _RAK3172_UART_Config.baud_rate = Baudrate;
 
-    return RAK3172_ERR_OK;
+RAK3172_SetBaudrate_Exit:
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+    return Error;
 }
 
 RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device)
@@ -760,6 +965,193 @@ RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device)
     return RAK3172_SendCommand(p_Device, "AT");
 }
 
+RAK3172_Error_t RAK3172_Suspend(RAK3172_t& p_Device, RAK3172_Snapshot_t* const p_Snapshot)
+{
+    if(p_Snapshot == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    memset(p_Snapshot, 0, sizeof(RAK3172_Snapshot_t));
+
+    p_Snapshot->Mode = p_Device.Mode;
+    p_Snapshot->Baudrate = p_Device.UART.Baudrate;
+    p_Snapshot->isEchoDisabled = p_Device.Internal.isEchoDisabled;
+    p_Snapshot->isJoined = p_Device.LoRaWAN.isJoined;
+    p_Snapshot->Join = p_Device.LoRaWAN.Join;
+    p_Snapshot->Cache = p_Device.Cache;
+
+    // The timer starts again after the deep sleep. Store the remaining off time of each sub band instead of the end of the off time.
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        for(uint8_t i = 0; i < RAK3172_DUTY_CYCLE_SUB_BANDS; i++)
+        {
+            long Remaining;
+
+            Remaining = static_cast<long>(p_Device.LoRaWAN.DutyCycle[i] - RAK3172_Timer_GetMilliseconds());
+            if((p_Device.LoRaWAN.DutyCycle[i] != 0) && (Remaining > 0))
+            {
+                p_Snapshot->DutyCycle[i] = static_cast<uint32_t>(Remaining);
+            }
+        }
+    #endif
+
+    if(p_Device.Info != NULL)
+    {
+        strncpy(p_Snapshot->Firmware, p_Device.Info->Firmware.c_str(), RAK3172_SNAPSHOT_INFO_LENGTH);
+        strncpy(p_Snapshot->Serial, p_Device.Info->Serial.c_str(), RAK3172_SNAPSHOT_INFO_LENGTH);
+    }
+
+    p_Snapshot->Magic = RAK3172_SNAPSHOT_MAGIC;
+
+    RAK3172_LOGI(TAG, "Suspend driver...");
+
+    RAK3172_Deinit(p_Device);
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_Resume(RAK3172_t& p_Device, const RAK3172_Snapshot_t& Snapshot)
+{
+    if((Snapshot.Magic != RAK3172_SNAPSHOT_MAGIC) || (Snapshot.isEchoDisabled == false))
+    {
+        RAK3172_LOGW(TAG, "Invalid snapshot. Full initialization required!");
+
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    RAK3172_LOGI(TAG, "Resume driver from snapshot...");
+
+    // Restore the driver state. The module keeps its state while the host is sleeping, so no communication is needed.
+    p_Device.UART.Baudrate = Snapshot.Baudrate;
+    p_Device.Mode = Snapshot.Mode;
+    p_Device.LoRaWAN.isJoined = Snapshot.isJoined;
+    p_Device.LoRaWAN.Join = Snapshot.Join;
+    p_Device.Cache = Snapshot.Cache;
+    p_Device.Internal.isBusy = false;
+
+    // The sleep time isn´t known. The off time continues after the wake up, which is longer than required but never violates the duty cycle.
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE
+        for(uint8_t i = 0; i < RAK3172_DUTY_CYCLE_SUB_BANDS; i++)
+        {
+            p_Device.LoRaWAN.DutyCycle[i] = 0;
+            if(Snapshot.DutyCycle[i] > 0)
+            {
+                p_Device.LoRaWAN.DutyCycle[i] = RAK3172_Timer_GetMilliseconds() + Snapshot.DutyCycle[i];
+
+                // Zero marks a free sub band.
+                if(p_Device.LoRaWAN.DutyCycle[i] == 0)
+                {
+                    p_Device.LoRaWAN.DutyCycle[i] = 1;
+                }
+            }
+        }
+    #endif
+    p_Device.Internal.isEchoDisabled = Snapshot.isEchoDisabled;
+
+    if(p_Device.Info != NULL)
+    {
+        p_Device.Info->Firmware.assign(Snapshot.Firmware, strnlen(Snapshot.Firmware, RAK3172_SNAPSHOT_INFO_LENGTH));
+        p_Device.Info->Serial.assign(Snapshot.Serial, strnlen(Snapshot.Serial, RAK3172_SNAPSHOT_INFO_LENGTH));
+    }
+
+    _RAK3172_UART_Config.baud_rate = p_Device.UART.Baudrate;
+
+    return RAK3172_BasicInit(p_Device);
+}
+
+RAK3172_Error_t RAK3172_WaitReady(RAK3172_t& p_Device, uint32_t Timeout)
+{
+    TickType_t Start;
+    uint32_t Probes;
+    bool isReady;
+    RAK3172_Line_t* Response;
+    RAK3172_Error_t Error;
+
+    if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    Probes = 0;
+    isReady = false;
+    Error = RAK3172_ERR_TIMEOUT;
+
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
+    p_Device.Internal.isBusy = true;
+
+    Start = xTaskGetTickCount();
+    while((isReady == false) && (((xTaskGetTickCount() - Start) * portTICK_PERIOD_MS) < Timeout))
+    {
+        Response = RAK3172_LinePool_Receive(p_Device, RAK3172_READY_PROBE_INTERVAL);
+
+        // The module is quiet. Probe it to find out if it is already able to process commands.
+        if(Response == NULL)
+        {
+            uart_write_bytes(p_Device.UART.Interface, "AT\r\n", 4);
+            Probes++;
+
+            continue;
+        }
+
+        RAK3172_LOGD(TAG, "Response: %s", Response->Data);
+
+        // The driver was compiled for RUI3, but an older splash screen was received (version 1.4.0 and below).
+        #ifdef CONFIG_RAK3172_USE_RUI3
+            if(strstr(Response->Data, "Version.") != NULL)
+            {
+                RAK3172_LOGE(TAG, "Firmware compiled for RUI3, but module firmware does not support RUI3!");
+
+                RAK3172_LinePool_Release(p_Device, Response);
+                Error = RAK3172_ERR_INVALID_RESPONSE;
+
+                goto RAK3172_WaitReady_Exit;
+            }
+        #endif
+
+        if((strstr(Response->Data, "LoRaWAN.") != NULL) || (strstr(Response->Data, "LoRa P2P.") != NULL) || (strcmp(Response->Data, "OK") == 0))
+        {
+            isReady = true;
+        }
+
+        RAK3172_LinePool_Release(p_Device, Response);
+    }
+
+    if(isReady == false)
+    {
+        RAK3172_LOGE(TAG, "     Timeout!");
+
+        goto RAK3172_WaitReady_Exit;
+    }
+
+    // Drop the answers for the remaining probes, otherwise they get mixed up with the response for the next command.
+    if(Probes > 0)
+    {
+        while((Response = RAK3172_LinePool_Receive(p_Device, RAK3172_READY_PROBE_INTERVAL)) != NULL)
+        {
+            RAK3172_LinePool_Release(p_Device, Response);
+        }
+    }
+
+    p_Device.Statistics.ReadyLatency = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
+    RAK3172_LOGI(TAG, "     Module ready after %lu ms (%lu probes)", static_cast<unsigned long>(p_Device.Statistics.ReadyLatency), static_cast<unsigned long>(Probes));
+
+    Error = RAK3172_ERR_OK;
+
+RAK3172_WaitReady_Exit:
+    p_Device.Internal.isBusy = false;
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+
+    return Error;
+}
+
 RAK3172_Error_t RAK3172_FactoryReset(RAK3172_t& p_Device)
 {
     if(p_Device.Internal.isInitialized == false)
@@ -769,17 +1161,19 @@ RAK3172_Error_t RAK3172_FactoryReset(RAK3172_t& p_Device)
 
     RAK3172_LOGI(TAG, "Perform factory reset...");
 
+    RAK3172_Cache_Invalidate(p_Device);
+
     #ifndef CONFIG_RAK3172_USE_RUI3
         std::string Command;
 
-        p_Device.Internal.isBusy = true;
         Command = "ATR\r\n";
         uart_write_bytes(p_Device.UART.Interface, Command.c_str(), Command.length());
-        RAK3172_ERROR_CHECK(RAK3172_ReceiveSplashScreen(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT));
     #else
         RAK3172_SendCommand(p_Device, "ATR");
     #endif
 
+    RAK3172_ERROR_CHECK(RAK3172_WaitReady(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT * 10));
+
     RAK3172_LOGI(TAG, "     Successful!");
 
     return RAK3172_ERR_OK;
@@ -788,6 +1182,7 @@ RAK3172_Error_t RAK3172_FactoryReset(RAK3172_t& p_Device)
 RAK3172_Error_t RAK3172_SoftReset(RAK3172_t& p_Device, uint32_t Timeout)
 {
     std::string Command;
+    RAK3172_Error_t Error;
 
 	if(p_Device.Internal.isInitialized == false)
 	{
@@ -796,13 +1191,20 @@ RAK3172_Error_t RAK3172_SoftReset(RAK3172_t& p_Device, uint32_t Timeout)
 
     RAK3172_LOGI(TAG, "Perform software reset...");
 
-    p_Device.Internal.isBusy = true;
+    RAK3172_Cache_Invalidate(p_Device);
+
+    xSemaphoreTakeRecursive(p_Device.Internal.Lock, portMAX_DELAY);
 
-    // Reset the module and read back the slash screen because the current state is unclear.
+    // Reset the module and wait until it is ready because the current state is unclear.
     Command = "ATZ\r\n";
     uart_write_bytes(p_Device.UART.Interface, Command.c_str(), Command.length());
 
-    RAK3172_ERROR_CHECK(RAK3172_ReceiveSplashScreen(p_Device, Timeout * 1000UL));
+    Error = RAK3172_WaitReady(p_Device, Timeout * 1000UL);
+    xSemaphoreGiveRecursive(p_Device.Internal.Lock);
+    if(Error != RAK3172_ERR_OK)
+    {
+        return Error;
+    }
 
     RAK3172_LOGI(TAG, "     Successful!");
 
@@ -819,13 +1221,15 @@ RAK3172_Error_t RAK3172_SoftReset(RAK3172_t& p_Device, uint32_t Timeout)
 
         RAK3172_LOGI(TAG, "Perform hardware reset...");
 
+        RAK3172_Cache_Invalidate(p_Device);
+
         #ifdef CONFIG_RAK3172_RESET_INVERT
             gpio_set_level(p_Device.Reset, true);
         #else
             gpio_set_level(p_Device.Reset, false);
         #endif
 
-        vTaskDelay(500 / portTICK_PERIOD_MS);
+        esp_rom_delay_us(RAK3172_RESET_PULSE_US);
 
         #ifdef CONFIG_RAK3172_RESET_INVERT
             gpio_set_level(p_Device.Reset, false);
@@ -833,13 +1237,7 @@ RAK3172_Error_t RAK3172_SoftReset(RAK3172_t& p_Device, uint32_t Timeout)
             gpio_set_level(p_Device.Reset, true);
         #endif
 
-        vTaskDelay(500 / portTICK_PERIOD_MS);
-
-        p_Device.Internal.isBusy = false;
-
-        #ifdef CONFIG_RAK3172_USE_RUI3
-            RAK3172_ERROR_CHECK(RAK3172_ReceiveSplashScreen(p_Device, Timeout * 1000UL));
-        #endif
+        RAK3172_ERROR_CHECK(RAK3172_WaitReady(p_Device, Timeout * 1000UL));
 
         RAK3172_LOGI(TAG, "     Successful!");
 
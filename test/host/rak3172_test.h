@@ -0,0 +1,55 @@
+#ifndef RAK3172_TEST_H_
+#define RAK3172_TEST_H_
+
+#include <stdio.h>
+
+/** @brief Number of failed checks of the test program.
+ */
+static int _RAK3172_Test_Failed;
+
+/** @brief Number of checks of the test program.
+ */
+static int _RAK3172_Test_Checks;
+
+/** @brief          Check a condition and report the position of a failed check.
+ *  @param Condition Condition
+ */
+#define RAK3172_TEST_ASSERT(Condition)                                                                  \
+    do                                                                                                  \
+    {                                                                                                   \
+        _RAK3172_Test_Checks++;                                                                         \
+        if(!(Condition))                                                                                \
+        {                                                                                               \
+            _RAK3172_Test_Failed++;                                                                     \
+            printf("%s:%d: Check failed: %s\n", __FILE__, __LINE__, #Condition);                        \
+        }                                                                                               \
+    } while(0)
+
+/** @brief          Compare two integer values and report both values for a failed check.
+ *  @param Expected Expected value
+ *  @param Actual   Actual value
+ */
+#define RAK3172_TEST_EQUAL(Expected, Actual)                                                            \
+    do                                                                                                  \
+    {                                                                                                   \
+        long long _Expected = static_cast<long long>(Expected);                                         \
+        long long _Actual = static_cast<long long>(Actual);                                             \
+        _RAK3172_Test_Checks++;                                                                         \
+        if(_Expected != _Actual)                                                                        \
+        {                                                                                               \
+            _RAK3172_Test_Failed++;                                                                     \
+            printf("%s:%d: %s: expected %lld, got %lld\n", __FILE__, __LINE__, #Actual, _Expected, _Actual);  \
+        }                                                                                               \
+    } while(0)
+
+/** @brief  Print the test summary.
+ *  @return Exit code of the test program
+ */
+static inline int RAK3172_Test_Result(void)
+{
+    printf("%d checks, %d failed\n", _RAK3172_Test_Checks, _RAK3172_Test_Failed);
+
+    return (_RAK3172_Test_Failed == 0) ? 0 : 1;
+}
+
+#endif /* RAK3172_TEST_H_ */
@@ -0,0 +1,85 @@
+#ifndef UART_H_
+#define UART_H_
+
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+typedef int uart_port_t;
+
+#define UART_NUM_1                              1
+#define UART_PIN_NO_CHANGE                      -1
+#define ESP_INTR_FLAG_IRAM                      1
+
+typedef enum
+{
+    UART_DATA_8_BITS,
+} uart_word_length_t;
+
+typedef enum
+{
+    UART_PARITY_DISABLE,
+} uart_parity_t;
+
+typedef enum
+{
+    UART_STOP_BITS_1,
+} uart_stop_bits_t;
+
+typedef enum
+{
+    UART_HW_FLOWCTRL_DISABLE,
+} uart_hw_flowcontrol_t;
+
+typedef enum
+{
+    UART_SCLK_DEFAULT,
+} uart_sclk_t;
+
+typedef struct
+{
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+    uart_sclk_t source_clk;
+} uart_config_t;
+
+typedef enum
+{
+    UART_DATA,
+    UART_FIFO_OVF,
+    UART_BUFFER_FULL,
+    UART_PATTERN_DET,
+} uart_event_type_t;
+
+typedef struct
+{
+    uart_event_type_t type;
+    size_t size;
+} uart_event_t;
+
+esp_err_t uart_driver_install(uart_port_t Port, int RxSize, int TxSize, int QueueSize, QueueHandle_t* p_Queue, int Flags);
+esp_err_t uart_driver_delete(uart_port_t Port);
+bool uart_is_driver_installed(uart_port_t Port);
+esp_err_t uart_param_config(uart_port_t Port, const uart_config_t* p_Config);
+esp_err_t uart_set_pin(uart_port_t Port, int Tx, int Rx, int RTS, int CTS);
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t Port, char Character, uint8_t Count, int Timeout, int Post, int Pre);
+esp_err_t uart_disable_pattern_det_intr(uart_port_t Port);
+esp_err_t uart_pattern_queue_reset(uart_port_t Port, int Length);
+int uart_pattern_pop_pos(uart_port_t Port);
+esp_err_t uart_get_buffered_data_len(uart_port_t Port, size_t* p_Size);
+int uart_read_bytes(uart_port_t Port, void* p_Buffer, uint32_t Length, TickType_t Ticks);
+int uart_write_bytes(uart_port_t Port, const void* p_Data, size_t Length);
+esp_err_t uart_flush(uart_port_t Port);
+esp_err_t uart_flush_input(uart_port_t Port);
+esp_err_t uart_set_baudrate(uart_port_t Port, uint32_t Baudrate);
+esp_err_t uart_get_baudrate(uart_port_t Port, uint32_t* p_Baudrate);
+esp_err_t uart_wait_tx_done(uart_port_t Port, TickType_t Ticks);
+
+#endif /* UART_H_ */
@@ -0,0 +1,12 @@
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                                  0
+#define ESP_FAIL                                -1
+#define ESP_ERR_NVS_NOT_FOUND                   0x1102
+
+#endif /* ESP_ERR_H_ */
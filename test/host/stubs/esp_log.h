@@ -0,0 +1,22 @@
+#ifndef ESP_LOG_H_
+#define ESP_LOG_H_
+
+#include <stdio.h>
+
+typedef enum
+{
+    ESP_LOG_NONE,
+} esp_log_level_t;
+
+/** @brief Driver messages are compiled, but not printed by the host tests.
+ */
+#define ESP_LOG_HOST(tag, format, ...)          do { if(0) { printf("%s: " format, tag, ##__VA_ARGS__); } } while(0)
+
+#define ESP_LOGI(tag, format, ...)              ESP_LOG_HOST(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)              ESP_LOG_HOST(tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)              ESP_LOG_HOST(tag, format, ##__VA_ARGS__)
+#define ESP_LOGE(tag, format, ...)              ESP_LOG_HOST(tag, format, ##__VA_ARGS__)
+
+void esp_log_level_set(const char* p_Tag, esp_log_level_t Level);
+
+#endif /* ESP_LOG_H_ */
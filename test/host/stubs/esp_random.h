@@ -0,0 +1,8 @@
+#ifndef ESP_RANDOM_H_
+#define ESP_RANDOM_H_
+
+#include <stdint.h>
+
+uint32_t esp_random(void);
+
+#endif /* ESP_RANDOM_H_ */
@@ -0,0 +1,16 @@
+#ifndef ESP_SLEEP_H_
+#define ESP_SLEEP_H_
+
+#include <stdint.h>
+
+typedef enum
+{
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_TIMER,
+} esp_sleep_wakeup_cause_t;
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+int esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+void esp_deep_sleep_start(void);
+
+#endif /* ESP_SLEEP_H_ */
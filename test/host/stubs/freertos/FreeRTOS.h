@@ -0,0 +1,23 @@
+#ifndef FREERTOS_H_
+#define FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdPASS                                  1
+#define pdFAIL                                  0
+#define pdTRUE                                  1
+#define pdFALSE                                 0
+
+/** @brief The host tests use a virtual clock with a tick period of 1 ms.
+ */
+#define portTICK_PERIOD_MS                      1
+#define portMAX_DELAY                           0xFFFFFFFFUL
+#define pdMS_TO_TICKS(x)                        (x)
+
+#endif /* FREERTOS_H_ */
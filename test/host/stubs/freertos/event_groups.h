@@ -0,0 +1,16 @@
+#ifndef EVENT_GROUPS_H_
+#define EVENT_GROUPS_H_
+
+#include "FreeRTOS.h"
+
+typedef void* EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate(void);
+void vEventGroupDelete(EventGroupHandle_t Group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t Group, EventBits_t Bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t Group, EventBits_t Bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t Group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t Group, EventBits_t Bits, BaseType_t Clear, BaseType_t WaitForAll, TickType_t Ticks);
+
+#endif /* EVENT_GROUPS_H_ */
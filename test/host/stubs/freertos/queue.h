@@ -0,0 +1,19 @@
+#ifndef QUEUE_H_
+#define QUEUE_H_
+
+#include "FreeRTOS.h"
+
+typedef void* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t Length, UBaseType_t ItemSize);
+BaseType_t xQueueSend(QueueHandle_t Queue, const void* p_Item, TickType_t Ticks);
+BaseType_t xQueueSendToBack(QueueHandle_t Queue, const void* p_Item, TickType_t Ticks);
+BaseType_t xQueueSendToFront(QueueHandle_t Queue, const void* p_Item, TickType_t Ticks);
+BaseType_t xQueueReceive(QueueHandle_t Queue, void* p_Item, TickType_t Ticks);
+BaseType_t xQueuePeek(QueueHandle_t Queue, void* p_Item, TickType_t Ticks);
+BaseType_t xQueueReset(QueueHandle_t Queue);
+void vQueueDelete(QueueHandle_t Queue);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t Queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t Queue);
+
+#endif /* QUEUE_H_ */
@@ -0,0 +1,17 @@
+#ifndef SEMPHR_H_
+#define SEMPHR_H_
+
+#include "queue.h"
+
+typedef void* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t Semaphore, TickType_t Ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t Semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t Semaphore, TickType_t Ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t Semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t Semaphore);
+
+#endif /* SEMPHR_H_ */
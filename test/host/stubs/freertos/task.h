@@ -0,0 +1,30 @@
+#ifndef TASK_H_
+#define TASK_H_
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+typedef enum
+{
+    eNoAction,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+BaseType_t xTaskCreate(TaskFunction_t Function, const char* p_Name, uint32_t Stack, void* p_Arg, UBaseType_t Priority, TaskHandle_t* p_Handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t Function, const char* p_Name, uint32_t Stack, void* p_Arg, UBaseType_t Priority, TaskHandle_t* p_Handle, BaseType_t Core);
+void vTaskDelete(TaskHandle_t Handle);
+void vTaskSuspend(TaskHandle_t Handle);
+void vTaskDelay(TickType_t Ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotify(TaskHandle_t Handle, uint32_t Value, eNotifyAction Action);
+BaseType_t xTaskNotifyGive(TaskHandle_t Handle);
+uint32_t ulTaskNotifyTake(BaseType_t Clear, TickType_t Ticks);
+BaseType_t xTaskNotifyWait(uint32_t ClearOnEntry, uint32_t ClearOnExit, uint32_t* p_Value, TickType_t Ticks);
+
+#endif /* TASK_H_ */
@@ -0,0 +1,23 @@
+#ifndef NVS_H_
+#define NVS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum
+{
+    NVS_READONLY,
+    NVS_READWRITE,
+} nvs_open_mode_t;
+
+esp_err_t nvs_open(const char* p_Namespace, nvs_open_mode_t Mode, nvs_handle_t* p_Handle);
+esp_err_t nvs_get_u32(nvs_handle_t Handle, const char* p_Key, uint32_t* p_Value);
+esp_err_t nvs_set_u32(nvs_handle_t Handle, const char* p_Key, uint32_t Value);
+esp_err_t nvs_commit(nvs_handle_t Handle);
+void nvs_close(nvs_handle_t Handle);
+
+#endif /* NVS_H_ */
@@ -0,0 +1,600 @@
+/*
+ * Single threaded host implementation of the ESP-IDF and FreeRTOS functions used by the driver.
+ * Tasks are never started. Queues, event groups and notifications keep their state, and every blocking call
+ * without a result moves the virtual system time by its timeout.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <string.h>
+
+#include <esp_log.h>
+#include <esp_random.h>
+#include <esp_rom_sys.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <nvs.h>
+
+#include <driver/gpio.h>
+#include <driver/uart.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+
+#include "rak3172_host.h"
+
+typedef struct
+{
+    std::vector<uint8_t> Storage;
+    UBaseType_t Length;
+    UBaseType_t ItemSize;
+    UBaseType_t Head;
+    UBaseType_t Count;
+} Host_Queue_t;
+
+static uint32_t _Host_Now;
+static uint32_t _Host_Random = 1;
+static uint32_t _Host_Notification;
+static uint32_t _Host_Baudrate = 9600;
+static RAK3172_Host_UART_t _Host_UART;
+static std::map<std::string, uint32_t> _Host_NVS;
+
+/** @brief          Move the virtual time when a blocking call has no result.
+ *  @param Ticks    Timeout of the call
+ */
+static void Host_Block(TickType_t Ticks)
+{
+    if(Ticks != portMAX_DELAY)
+    {
+        _Host_Now += Ticks;
+    }
+}
+
+void RAK3172_Host_SetUART(RAK3172_Host_UART_t Hook)
+{
+    _Host_UART = Hook;
+}
+
+uint32_t RAK3172_Host_Now(void)
+{
+    return _Host_Now;
+}
+
+void RAK3172_Host_Advance(uint32_t Milliseconds)
+{
+    _Host_Now += Milliseconds;
+}
+
+void RAK3172_Host_Reset(uint32_t Seed)
+{
+    _Host_Now = 0;
+    _Host_Random = (Seed == 0) ? 1 : Seed;
+}
+
+void esp_log_level_set(const char* p_Tag, esp_log_level_t Level)
+{
+}
+
+uint32_t esp_random(void)
+{
+    // xorshift32
+    _Host_Random ^= _Host_Random << 13;
+    _Host_Random ^= _Host_Random >> 17;
+    _Host_Random ^= _Host_Random << 5;
+
+    return _Host_Random;
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+int esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return static_cast<int64_t>(_Host_Now) * 1000;
+}
+
+esp_err_t nvs_open(const char* p_Namespace, nvs_open_mode_t Mode, nvs_handle_t* p_Handle)
+{
+    *p_Handle = 1;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t Handle, const char* p_Key, uint32_t* p_Value)
+{
+    std::map<std::string, uint32_t>::iterator Entry = _Host_NVS.find(p_Key);
+
+    if(Entry == _Host_NVS.end())
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    *p_Value = Entry->second;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t Handle, const char* p_Key, uint32_t Value)
+{
+    _Host_NVS[p_Key] = Value;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t Handle)
+{
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t Handle)
+{
+}
+
+esp_err_t gpio_config(const gpio_config_t* p_Config)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t Pin, uint32_t Level)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t Pin)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_install(uart_port_t Port, int RxSize, int TxSize, int QueueSize, QueueHandle_t* p_Queue, int Flags)
+{
+    if(p_Queue != NULL)
+    {
+        *p_Queue = xQueueCreate(QueueSize, sizeof(uart_event_t));
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t Port)
+{
+    return ESP_OK;
+}
+
+bool uart_is_driver_installed(uart_port_t Port)
+{
+    return true;
+}
+
+esp_err_t uart_param_config(uart_port_t Port, const uart_config_t* p_Config)
+{
+    _Host_Baudrate = p_Config->baud_rate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t Port, int Tx, int Rx, int RTS, int CTS)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t Port, char Character, uint8_t Count, int Timeout, int Post, int Pre)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_disable_pattern_det_intr(uart_port_t Port)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_pattern_queue_reset(uart_port_t Port, int Length)
+{
+    return ESP_OK;
+}
+
+int uart_pattern_pop_pos(uart_port_t Port)
+{
+    return -1;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t Port, size_t* p_Size)
+{
+    *p_Size = 0;
+
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t Port, void* p_Buffer, uint32_t Length, TickType_t Ticks)
+{
+    Host_Block(Ticks);
+
+    return 0;
+}
+
+int uart_write_bytes(uart_port_t Port, const void* p_Data, size_t Length)
+{
+    if(_Host_UART != NULL)
+    {
+        _Host_UART(static_cast<const char*>(p_Data), Length);
+    }
+
+    return static_cast<int>(Length);
+}
+
+esp_err_t uart_flush(uart_port_t Port)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t Port)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t Port, uint32_t Baudrate)
+{
+    _Host_Baudrate = Baudrate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t Port, uint32_t* p_Baudrate)
+{
+    *p_Baudrate = _Host_Baudrate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t Port, TickType_t Ticks)
+{
+    return ESP_OK;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t Function, const char* p_Name, uint32_t Stack, void* p_Arg, UBaseType_t Priority, TaskHandle_t* p_Handle)
+{
+    static int Task;
+
+    if(p_Handle != NULL)
+    {
+        *p_Handle = &Task;
+    }
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t Function, const char* p_Name, uint32_t Stack, void* p_Arg, UBaseType_t Priority, TaskHandle_t* p_Handle, BaseType_t Core)
+{
+    return xTaskCreate(Function, p_Name, Stack, p_Arg, Priority, p_Handle);
+}
+
+void vTaskDelete(TaskHandle_t Handle)
+{
+}
+
+void vTaskSuspend(TaskHandle_t Handle)
+{
+}
+
+void vTaskDelay(TickType_t Ticks)
+{
+    _Host_Now += Ticks;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return _Host_Now;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    static int Task;
+
+    return &Task;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t Handle, uint32_t Value, eNotifyAction Action)
+{
+    switch(Action)
+    {
+        case eSetBits:
+        {
+            _Host_Notification |= Value;
+
+            break;
+        }
+        case eIncrement:
+        {
+            _Host_Notification++;
+
+            break;
+        }
+        case eSetValueWithOverwrite:
+        case eSetValueWithoutOverwrite:
+        {
+            _Host_Notification = Value;
+
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t Handle)
+{
+    return xTaskNotify(Handle, 0, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t Clear, TickType_t Ticks)
+{
+    uint32_t Value = _Host_Notification;
+
+    if(Value == 0)
+    {
+        Host_Block(Ticks);
+
+        return 0;
+    }
+
+    _Host_Notification = (Clear == pdTRUE) ? 0 : (Value - 1);
+
+    return Value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t ClearOnEntry, uint32_t ClearOnExit, uint32_t* p_Value, TickType_t Ticks)
+{
+    _Host_Notification &= ~ClearOnEntry;
+
+    if(_Host_Notification == 0)
+    {
+        Host_Block(Ticks);
+
+        return pdFAIL;
+    }
+
+    if(p_Value != NULL)
+    {
+        *p_Value = _Host_Notification;
+    }
+
+    _Host_Notification &= ~ClearOnExit;
+
+    return pdPASS;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t Length, UBaseType_t ItemSize)
+{
+    Host_Queue_t* Queue = new Host_Queue_t;
+
+    Queue->Storage.resize(Length * ItemSize);
+    Queue->Length = Length;
+    Queue->ItemSize = ItemSize;
+    Queue->Head = 0;
+    Queue->Count = 0;
+
+    return Queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t Queue, const void* p_Item, TickType_t Ticks)
+{
+    return xQueueSendToBack(Queue, p_Item, Ticks);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t Queue, const void* p_Item, TickType_t Ticks)
+{
+    Host_Queue_t* Host = static_cast<Host_Queue_t*>(Queue);
+
+    if(Host->Count == Host->Length)
+    {
+        Host_Block(Ticks);
+
+        return pdFAIL;
+    }
+
+    memcpy(&Host->Storage[((Host->Head + Host->Count) % Host->Length) * Host->ItemSize], p_Item, Host->ItemSize);
+    Host->Count++;
+
+    return pdPASS;
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t Queue, const void* p_Item, TickType_t Ticks)
+{
+    Host_Queue_t* Host = static_cast<Host_Queue_t*>(Queue);
+
+    if(Host->Count == Host->Length)
+    {
+        Host_Block(Ticks);
+
+        return pdFAIL;
+    }
+
+    Host->Head = (Host->Head + Host->Length - 1) % Host->Length;
+    memcpy(&Host->Storage[Host->Head * Host->ItemSize], p_Item, Host->ItemSize);
+    Host->Count++;
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t Queue, void* p_Item, TickType_t Ticks)
+{
+    Host_Queue_t* Host = static_cast<Host_Queue_t*>(Queue);
+
+    if(xQueuePeek(Queue, p_Item, Ticks) != pdPASS)
+    {
+        return pdFAIL;
+    }
+
+    Host->Head = (Host->Head + 1) % Host->Length;
+    Host->Count--;
+
+    return pdPASS;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t Queue, void* p_Item, TickType_t Ticks)
+{
+    Host_Queue_t* Host = static_cast<Host_Queue_t*>(Queue);
+
+    if(Host->Count == 0)
+    {
+        Host_Block(Ticks);
+
+        return pdFAIL;
+    }
+
+    memcpy(p_Item, &Host->Storage[Host->Head * Host->ItemSize], Host->ItemSize);
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReset(QueueHandle_t Queue)
+{
+    Host_Queue_t* Host = static_cast<Host_Queue_t*>(Queue);
+
+    Host->Head = 0;
+    Host->Count = 0;
+
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t Queue)
+{
+    delete static_cast<Host_Queue_t*>(Queue);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t Queue)
+{
+    return static_cast<Host_Queue_t*>(Queue)->Count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t Queue)
+{
+    return static_cast<Host_Queue_t*>(Queue)->Length - static_cast<Host_Queue_t*>(Queue)->Count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return new int(1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return new int(1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return new int(0);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t Semaphore, TickType_t Ticks)
+{
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t Semaphore)
+{
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t Semaphore, TickType_t Ticks)
+{
+    int* Count = static_cast<int*>(Semaphore);
+
+    if(*Count == 0)
+    {
+        Host_Block(Ticks);
+
+        return pdFAIL;
+    }
+
+    (*Count)--;
+
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t Semaphore)
+{
+    *static_cast<int*>(Semaphore) = 1;
+
+    return pdPASS;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t Semaphore)
+{
+    delete static_cast<int*>(Semaphore);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return new EventBits_t(0);
+}
+
+void vEventGroupDelete(EventGroupHandle_t Group)
+{
+    delete static_cast<EventBits_t*>(Group);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t Group, EventBits_t Bits)
+{
+    *static_cast<EventBits_t*>(Group) |= Bits;
+
+    return *static_cast<EventBits_t*>(Group);
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t Group, EventBits_t Bits)
+{
+    EventBits_t Old = *static_cast<EventBits_t*>(Group);
+
+    *static_cast<EventBits_t*>(Group) &= ~Bits;
+
+    return Old;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t Group)
+{
+    return *static_cast<EventBits_t*>(Group);
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t Group, EventBits_t Bits, BaseType_t Clear, BaseType_t WaitForAll, TickType_t Ticks)
+{
+    EventBits_t Current = *static_cast<EventBits_t*>(Group);
+    bool isSet;
+
+    isSet = (WaitForAll == pdTRUE) ? ((Current & Bits) == Bits) : ((Current & Bits) != 0);
+    if(isSet == false)
+    {
+        Host_Block(Ticks);
+
+        return Current;
+    }
+
+    if(Clear == pdTRUE)
+    {
+        *static_cast<EventBits_t*>(Group) &= ~Bits;
+    }
+
+    return Current;
+}
@@ -0,0 +1,33 @@
+#ifndef RAK3172_HOST_H_
+#define RAK3172_HOST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief              Hook which is called for every UART write of the driver.
+ *  @param p_Data       Pointer to written data
+ *  @param Length       Length of the written data
+ */
+typedef void (*RAK3172_Host_UART_t)(const char* p_Data, size_t Length);
+
+/** @brief              Install a hook for the UART writes of the driver. Use NULL to discard the data.
+ *  @param Hook         UART hook
+ */
+void RAK3172_Host_SetUART(RAK3172_Host_UART_t Hook);
+
+/** @brief              Get the virtual system time. The time only moves with blocking FreeRTOS calls or "RAK3172_Host_Advance".
+ *  @return             Time in milliseconds
+ */
+uint32_t RAK3172_Host_Now(void);
+
+/** @brief              Move the virtual system time forward.
+ *  @param Milliseconds Time in milliseconds
+ */
+void RAK3172_Host_Advance(uint32_t Milliseconds);
+
+/** @brief              Reset the virtual system time and seed the random number generator of "esp_random".
+ *  @param Seed         Seed for the random number generator
+ */
+void RAK3172_Host_Reset(uint32_t Seed);
+
+#endif /* RAK3172_HOST_H_ */
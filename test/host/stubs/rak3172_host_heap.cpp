@@ -0,0 +1,93 @@
+/*
+ * Heap allocation counter for the host tests. Only linked into the tests which check the heap usage of the driver.
+ * NOTE: Requires the GNU C library.
+ */
+
+#include <new>
+#include <stdlib.h>
+
+#include "rak3172_host_heap.h"
+
+extern "C" void* __libc_malloc(size_t Size);
+extern "C" void* __libc_calloc(size_t Count, size_t Size);
+extern "C" void* __libc_realloc(void* p_Memory, size_t Size);
+extern "C" void __libc_free(void* p_Memory);
+
+static size_t _Host_Allocations;
+static size_t _Host_Bytes;
+
+extern "C" void* malloc(size_t Size)
+{
+    _Host_Allocations++;
+    _Host_Bytes += Size;
+
+    return __libc_malloc(Size);
+}
+
+extern "C" void* calloc(size_t Count, size_t Size)
+{
+    _Host_Allocations++;
+    _Host_Bytes += Count * Size;
+
+    return __libc_calloc(Count, Size);
+}
+
+extern "C" void* realloc(void* p_Memory, size_t Size)
+{
+    _Host_Allocations++;
+    _Host_Bytes += Size;
+
+    return __libc_realloc(p_Memory, Size);
+}
+
+extern "C" void free(void* p_Memory)
+{
+    __libc_free(p_Memory);
+}
+
+void* operator new(size_t Size)
+{
+    void* p_Memory = malloc(Size);
+
+    if(p_Memory == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p_Memory;
+}
+
+void* operator new[](size_t Size)
+{
+    return operator new(Size);
+}
+
+void operator delete(void* p_Memory) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete[](void* p_Memory) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete(void* p_Memory, size_t Size) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete[](void* p_Memory, size_t Size) noexcept
+{
+    free(p_Memory);
+}
+
+size_t RAK3172_Host_GetAllocations(void)
+{
+    return _Host_Allocations;
+}
+
+size_t RAK3172_Host_GetAllocatedBytes(void)
+{
+    return _Host_Bytes;
+}
@@ -0,0 +1,16 @@
+#ifndef RAK3172_HOST_HEAP_H_
+#define RAK3172_HOST_HEAP_H_
+
+#include <stddef.h>
+
+/** @brief  Get the number of heap allocations (malloc, calloc, realloc and new) since the start of the program.
+ *  @return Number of allocations
+ */
+size_t RAK3172_Host_GetAllocations(void);
+
+/** @brief  Get the number of allocated bytes since the start of the program.
+ *  @return Number of bytes
+ */
+size_t RAK3172_Host_GetAllocatedBytes(void);
+
+#endif /* RAK3172_HOST_HEAP_H_ */
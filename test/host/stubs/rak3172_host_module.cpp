@@ -0,0 +1,174 @@
+/*
+ * Simulated RAK3172 module for the host tests. Only linked into the tests which transmit commands through the driver.
+ */
+
+#include <algorithm>
+#include <string.h>
+
+#include <driver/uart.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include "Buffer/rak3172_line_pool.h"
+
+#include "rak3172_host.h"
+#include "rak3172_host_module.h"
+
+typedef struct
+{
+    RAK3172_t* p_Device;
+    RAK3172_Host_Module_Handler_t Handler;
+    double Processing;
+    std::string Line;
+    std::vector<std::string> Commands;
+    std::vector<double> Arrivals;
+    std::vector<size_t> Answers;
+    double Now;
+    double TxFree;
+    double RxFree;
+    double ModuleFree;
+    size_t Pushed;
+    size_t MaxPending;
+} Host_Module_t;
+
+static Host_Module_t _Host_Module;
+
+/** @brief Move the driver time to the arrival of the last line which the driver has taken from the line pool.
+ */
+static void Host_Module_Sync(void)
+{
+    size_t Consumed;
+
+    Consumed = _Host_Module.Pushed - uxQueueMessagesWaiting(_Host_Module.p_Device->Internal.MessageQueue);
+    if(Consumed > 0)
+    {
+        _Host_Module.Now = std::max(_Host_Module.Now, _Host_Module.Arrivals[Consumed - 1]);
+    }
+}
+
+/** @brief  Get the transmission time of a byte.
+ *  @return Time in microseconds
+ */
+static double Host_Module_GetByteTime(void)
+{
+    uint32_t Baudrate;
+
+    uart_get_baudrate(_Host_Module.p_Device->UART.Interface, &Baudrate);
+
+    return 10.0e6 / Baudrate;
+}
+
+/** @brief          UART hook of the simulated module.
+ *  @param p_Data   Pointer to written data
+ *  @param Length   Length of the written data
+ */
+static void Host_Module_Write(const char* p_Data, size_t Length)
+{
+    size_t Consumed;
+    size_t Answered;
+    double ByteTime;
+    double Start;
+    std::string Command;
+    std::vector<std::string> Lines;
+
+    Host_Module_Sync();
+
+    ByteTime = Host_Module_GetByteTime();
+    Start = std::max(_Host_Module.Now, _Host_Module.TxFree);
+    _Host_Module.TxFree = Start + (Length * ByteTime);
+
+    _Host_Module.Line.append(p_Data, Length);
+    if((_Host_Module.Line.length() < 2) || (_Host_Module.Line.compare(_Host_Module.Line.length() - 2, 2, "\r\n") != 0))
+    {
+        return;
+    }
+
+    Command = _Host_Module.Line.substr(0, _Host_Module.Line.length() - 2);
+    _Host_Module.Line.clear();
+    _Host_Module.Commands.push_back(Command);
+
+    _Host_Module.Handler(Command, &Lines);
+
+    // The module processes the commands one after the other and starts with the response after the processing time.
+    _Host_Module.ModuleFree = std::max(_Host_Module.TxFree, _Host_Module.ModuleFree) + _Host_Module.Processing;
+    _Host_Module.RxFree = std::max(_Host_Module.RxFree, _Host_Module.ModuleFree);
+
+    for(const std::string& Data : Lines)
+    {
+        RAK3172_Line_t* Line;
+
+        Line = RAK3172_LinePool_Take(*_Host_Module.p_Device);
+        if(Line == NULL)
+        {
+            continue;
+        }
+
+        _Host_Module.RxFree += (Data.length() + 2) * ByteTime;
+
+        strncpy(Line->Data, Data.c_str(), sizeof(Line->Data) - 1);
+        Line->Data[sizeof(Line->Data) - 1] = '\0';
+        Line->Length = strlen(Line->Data);
+        RAK3172_LinePool_Push(*_Host_Module.p_Device, Line);
+
+        _Host_Module.Arrivals.push_back(_Host_Module.RxFree);
+        _Host_Module.Pushed++;
+    }
+
+    _Host_Module.ModuleFree = _Host_Module.RxFree;
+
+    // A command is answered when the driver has taken its last response line. Ignored commands are never answered.
+    _Host_Module.Answers.push_back(Lines.empty() ? SIZE_MAX : _Host_Module.Pushed);
+
+    Consumed = _Host_Module.Pushed - uxQueueMessagesWaiting(_Host_Module.p_Device->Internal.MessageQueue);
+    Answered = std::count_if(_Host_Module.Answers.begin(), _Host_Module.Answers.end(), [Consumed](size_t Answer) { return Answer <= Consumed; });
+    _Host_Module.MaxPending = std::max(_Host_Module.MaxPending, _Host_Module.Commands.size() - Answered);
+}
+
+void RAK3172_Host_Module_Init(RAK3172_t& p_Device, RAK3172_Host_Module_Handler_t Handler, double Processing)
+{
+    _Host_Module.p_Device = &p_Device;
+    _Host_Module.Handler = Handler;
+    _Host_Module.Processing = Processing;
+
+    RAK3172_Host_Module_Reset();
+    RAK3172_Host_SetUART(Host_Module_Write);
+}
+
+void RAK3172_Host_Module_Deinit(void)
+{
+    RAK3172_Host_SetUART(NULL);
+}
+
+void RAK3172_Host_Module_Reset(void)
+{
+    RAK3172_LinePool_Flush(*_Host_Module.p_Device);
+
+    _Host_Module.Line.clear();
+    _Host_Module.Commands.clear();
+    _Host_Module.Arrivals.clear();
+    _Host_Module.Answers.clear();
+    _Host_Module.Now = 0;
+    _Host_Module.TxFree = 0;
+    _Host_Module.RxFree = 0;
+    _Host_Module.ModuleFree = 0;
+    _Host_Module.Pushed = 0;
+    _Host_Module.MaxPending = 0;
+}
+
+double RAK3172_Host_Module_GetTime(void)
+{
+    Host_Module_Sync();
+
+    return _Host_Module.Now;
+}
+
+size_t RAK3172_Host_Module_GetMaxPending(void)
+{
+    return _Host_Module.MaxPending;
+}
+
+const std::vector<std::string>& RAK3172_Host_Module_GetCommands(void)
+{
+    return _Host_Module.Commands;
+}
@@ -0,0 +1,51 @@
+#ifndef RAK3172_HOST_MODULE_H_
+#define RAK3172_HOST_MODULE_H_
+
+#include <string>
+#include <vector>
+
+#include "rak3172_defs.h"
+
+/** @brief              Command handler of the simulated module.
+ *  @param Command      Received command without line ending
+ *  @param p_Lines      Pointer to response lines without line ending. Leave empty to ignore the command
+ */
+typedef void (*RAK3172_Host_Module_Handler_t)(const std::string& Command, std::vector<std::string>* p_Lines);
+
+/** @brief              Install a simulated module on the UART hook. The module receives the commands of the driver and
+ *                      adds the response lines of the handler to the line pool of the device.
+ *                      The module keeps a timeline of the serial link with 10 bits per byte at the baud rate of the UART driver:
+ *                      A command is received after all of its bytes are transmitted, the module needs the processing time for
+ *                      each command and transmits the response lines one after the other. The driver transmits a command when
+ *                      it has received all lines which it has taken from the line pool so far.
+ *                      NOTE: The line pool of the device must be initialized.
+ *  @param p_Device     RAK3172 device object
+ *  @param Handler      Command handler
+ *  @param Processing   Processing time of the module for each command in microseconds
+ */
+void RAK3172_Host_Module_Init(RAK3172_t& p_Device, RAK3172_Host_Module_Handler_t Handler, double Processing);
+
+/** @brief Remove the simulated module from the UART hook.
+ */
+void RAK3172_Host_Module_Deinit(void);
+
+/** @brief Clear the timeline and the received commands.
+ */
+void RAK3172_Host_Module_Reset(void);
+
+/** @brief  Get the time of the driver on the timeline of the serial link.
+ *  @return Time since the last reset in microseconds
+ */
+double RAK3172_Host_Module_GetTime(void);
+
+/** @brief  Get the maximum number of commands which were received by the module but not answered to the driver.
+ *  @return Number of commands since the last reset
+ */
+size_t RAK3172_Host_Module_GetMaxPending(void);
+
+/** @brief  Get the received commands.
+ *  @return Commands since the last reset
+ */
+const std::vector<std::string>& RAK3172_Host_Module_GetCommands(void);
+
+#endif /* RAK3172_HOST_MODULE_H_ */
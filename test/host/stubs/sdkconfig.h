@@ -0,0 +1,52 @@
+/*
+ * Host configuration for the RAK3172 host tests. All optional driver features are enabled.
+ */
+
+#ifndef SDKCONFIG_H_
+#define SDKCONFIG_H_
+
+#define CONFIG_RAK3172_USE_RUI3 1
+#define CONFIG_RAK3172_FACTORY_RESET 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_CLASS_B 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_MULTICAST 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY_CYCLE 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_FRAGMENTATION 1
+#define CONFIG_RAK3172_MODE_WITH_P2P 1
+#define CONFIG_RAK3172_UART_BUFFER_SIZE 512
+#define CONFIG_RAK3172_UART_QUEUE_LENGTH 8
+#define CONFIG_RAK3172_UART_LINE_POOL_SIZE 8
+#define CONFIG_RAK3172_UART_LINE_LENGTH 512
+#define CONFIG_RAK3172_UART_RX_PAYLOAD_SIZE 256
+#define CONFIG_RAK3172_UART_BATCH_WINDOW 4
+#define CONFIG_RAK3172_UART_BAUD_DISCOVERY 1
+#define CONFIG_RAK3172_UART_BAUD_PERSIST 1
+#define CONFIG_RAK3172_TASK_PRIO 12
+#define CONFIG_RAK3172_TASK_BUFFER_SIZE 1024
+#define CONFIG_RAK3172_TASK_STACK_SIZE 4096
+#define CONFIG_RAK3172_ASYNC_ENABLE 1
+#define CONFIG_RAK3172_ASYNC_PRIO 5
+#define CONFIG_RAK3172_ASYNC_STACK_SIZE 4096
+#define CONFIG_RAK3172_ASYNC_QUEUE_LENGTH 8
+#define CONFIG_RAK3172_ASYNC_COMMAND_LENGTH 128
+#define CONFIG_RAK3172_UPLINK_ENABLE 1
+#define CONFIG_RAK3172_UPLINK_PRIO 5
+#define CONFIG_RAK3172_UPLINK_STACK_SIZE 4096
+#define CONFIG_RAK3172_UPLINK_QUEUE_LENGTH 4
+#define CONFIG_RAK3172_UPLINK_PAYLOAD_SIZE 242
+#define CONFIG_RAK3172_UPLINK_RETRY_COUNT 3
+#define CONFIG_RAK3172_UPLINK_RETRY_DELAY 5000
+#define CONFIG_RAK3172_UPLINK_COALESCE 1
+#define CONFIG_RAK3172_UPLINK_COALESCE_AGE 60000
+#define CONFIG_RAK3172_COMPRESSION 1
+#define CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE 243
+#define CONFIG_RAK3172_MISC_ERROR_BASE 0xA000
+#define CONFIG_RAK3172_MISC_ENABLE_LOG 1
+
+// "rak3172.h" needs the macro for the library version. The component gets it from "rak3172.cpp" only.
+#ifndef STRINGIFY
+    #define STR(s)                  #s
+    #define STRINGIFY(s)            STR(s)
+#endif
+
+#endif /* SDKCONFIG_H_ */
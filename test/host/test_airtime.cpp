@@ -0,0 +1,77 @@
+/*
+ * Host test for the time on air calculation.
+ * The expected values are calculated with the formula of the Semtech application note AN1200.13 and rounded up to milliseconds.
+ */
+
+#include "rak3172.h"
+
+#include "rak3172_test.h"
+
+/** @brief Check the time on air of LoRa frames.
+ */
+static void Test_LoRa(void)
+{
+    // Join request (23 bytes) with coding rate 4/5 and 8 preamble symbols.
+    RAK3172_TEST_EQUAL(1483, RAK3172_GetTimeOnAir(12, 125, RAK_CR_45, 8, 23));
+    RAK3172_TEST_EQUAL(824, RAK3172_GetTimeOnAir(11, 125, RAK_CR_45, 8, 23));
+    RAK3172_TEST_EQUAL(62, RAK3172_GetTimeOnAir(7, 125, RAK_CR_45, 8, 23));
+
+    // Maximum payload of EU868 DR0 and DR5 with the frame overhead.
+    RAK3172_TEST_EQUAL(2794, RAK3172_GetTimeOnAir(12, 125, RAK_CR_45, 8, 51 + RAK3172_LORAWAN_FRAME_OVERHEAD));
+    RAK3172_TEST_EQUAL(369, RAK3172_GetTimeOnAir(7, 125, RAK_CR_45, 8, 222 + RAK3172_LORAWAN_FRAME_OVERHEAD));
+
+    // Bandwidth and coding rate.
+    RAK3172_TEST_EQUAL(31, RAK3172_GetTimeOnAir(7, 250, RAK_CR_45, 8, 23));
+    RAK3172_TEST_EQUAL(70, RAK3172_GetTimeOnAir(7, 125, RAK_CR_46, 8, 23));
+    RAK3172_TEST_EQUAL(87, RAK3172_GetTimeOnAir(7, 125, RAK_CR_48, 8, 23));
+
+    // Implicit header without CRC.
+    RAK3172_TEST_EQUAL(37, RAK3172_GetTimeOnAir(7, 125, RAK_CR_45, 8, 10, true, false));
+
+    // Invalid arguments.
+    RAK3172_TEST_EQUAL(0, RAK3172_GetTimeOnAir(4, 125, RAK_CR_45, 8, 23));
+    RAK3172_TEST_EQUAL(0, RAK3172_GetTimeOnAir(13, 125, RAK_CR_45, 8, 23));
+    RAK3172_TEST_EQUAL(0, RAK3172_GetTimeOnAir(7, 0, RAK_CR_45, 8, 23));
+}
+
+/** @brief Check the time on air of LoRaWAN uplinks with the data rate tables of the frequency bands.
+ */
+static void Test_LoRaWAN(void)
+{
+    RAK3172_TEST_EQUAL(1483, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_0, 23));
+    RAK3172_TEST_EQUAL(62, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_5, 23));
+    RAK3172_TEST_EQUAL(31, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_6, 23));
+
+    // US915 DR0 is SF10 and DR4 is SF8 with 500 kHz.
+    RAK3172_TEST_EQUAL(RAK3172_GetTimeOnAir(10, 125, RAK_CR_45, 8, 23), RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_US915, RAK_DR_0, 23));
+    RAK3172_TEST_EQUAL(RAK3172_GetTimeOnAir(8, 500, RAK_CR_45, 8, 23), RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_US915, RAK_DR_4, 23));
+
+    // FSK with 50 kbps: (23 + 11) bytes with 160 us per byte.
+    RAK3172_TEST_EQUAL(6, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_7, 23));
+    RAK3172_TEST_EQUAL(41, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_7, 242));
+
+    // PHY payload of a full frame doesn´t wrap: (242 + 13 + 11) bytes with 160 us per byte.
+    RAK3172_TEST_EQUAL(43, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_7, 242 + RAK3172_LORAWAN_FRAME_OVERHEAD));
+
+    // The module splits 300 bytes into a frame with 242 bytes and a frame with 58 bytes.
+    RAK3172_TEST_EQUAL(43 + 14, RAK3172_LoRaWAN_GetPayloadTimeOnAir(RAK_BAND_EU868, RAK_DR_7, 300));
+    RAK3172_TEST_EQUAL(RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_0, 10 + RAK3172_LORAWAN_FRAME_OVERHEAD), RAK3172_LoRaWAN_GetPayloadTimeOnAir(RAK_BAND_EU868, RAK_DR_0, 10));
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_GetPayloadTimeOnAir(RAK_BAND_US915, RAK_DR_5, 10));
+
+    // Data rates which aren´t defined for the band.
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_US915, RAK_DR_5, 23));
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_KR920, RAK_DR_7, 23));
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, static_cast<RAK3172_DataRate_t>(8), 23));
+
+    RAK3172_TEST_EQUAL(51, RAK3172_LoRaWAN_GetMaxPayload(RAK_BAND_EU868, RAK_DR_0));
+    RAK3172_TEST_EQUAL(11, RAK3172_LoRaWAN_GetMaxPayload(RAK_BAND_US915, RAK_DR_0));
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_GetMaxPayload(RAK_BAND_US915, RAK_DR_5));
+}
+
+int main(void)
+{
+    Test_LoRa();
+    Test_LoRaWAN();
+
+    return RAK3172_Test_Result();
+}
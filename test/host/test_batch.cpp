@@ -0,0 +1,268 @@
+/*
+ * Host test and measurement for the batch execution of AT commands.
+ * The test checks the matching of the responses of "RAK3172_SendBatch" with a simulated module: values with status, status
+ * without value, empty lines between value and status, a failed command in the middle of a batch and a command without
+ * response. The measurement compares the wall time of the configuration of "RAK3172_LoRaWAN_Init" (OTAA) with one
+ * "RAK3172_SendCommand" for each command and with "RAK3172_SendBatch" at the supported baud rates. The wall time is taken
+ * from the timeline of the simulated serial link.
+ * NOTE: The processing time of the module is an assumption. It isn´t measured with a real module.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+#include "rak3172.h"
+
+#include "Buffer/rak3172_line_pool.h"
+
+#include "rak3172_host_module.h"
+#include "rak3172_test.h"
+
+/** @brief Assumed processing time of the module for each command in microseconds.
+ */
+#define TEST_MODULE_PROCESSING                  1000
+
+/** @brief Settings of the simulated module.
+ */
+static std::map<std::string, std::string> _Test_Settings = {
+    {"AT+CLASS", "A"},
+    {"AT+ADR", "0"},
+    {"AT+BAND", "4"},
+    {"AT+TXP", "0"},
+    {"AT+NJM", "1"},
+    {"AT+DEVEUI", "0000000000000000"},
+    {"AT+APPEUI", "0000000000000000"},
+    {"AT+APPKEY", "00000000000000000000000000000000"},
+};
+
+/** @brief              Command handler of the simulated module. The module answers queries with the value and a status line
+ *                      and all other commands with a status line. Some commands simulate special responses.
+ *  @param Command      Received command
+ *  @param p_Lines      Pointer to response lines
+ */
+static void Test_Module_Handler(const std::string& Command, std::vector<std::string>* p_Lines)
+{
+    std::string Name;
+    size_t Index;
+
+    Index = Command.find('=');
+    Name = Command.substr(0, Index);
+
+    if(Name == "AT+MUTE")
+    {
+        return;
+    }
+    else if(Name == "AT+FAIL")
+    {
+        p_Lines->push_back("AT_PARAM_ERROR");
+    }
+    else if(Name == "AT+EMPTY")
+    {
+        p_Lines->push_back("AT+EMPTY=1");
+        p_Lines->push_back("");
+        p_Lines->push_back("OK");
+    }
+    else if(Name == "AT+MASK")
+    {
+        p_Lines->push_back((Index == (Command.length() - 2)) ? "AT+MASK=0001" : "OK");
+        if(Index == (Command.length() - 2))
+        {
+            p_Lines->push_back("OK");
+        }
+    }
+    else if(_Test_Settings.count(Name) == 0)
+    {
+        p_Lines->push_back("AT_COMMAND_NOT_FOUND");
+    }
+    else if(Command.compare(Index, 2, "=?") == 0)
+    {
+        p_Lines->push_back(Name + "=" + _Test_Settings[Name]);
+        p_Lines->push_back("OK");
+    }
+    else
+    {
+        _Test_Settings[Name] = Command.substr(Index + 1);
+        p_Lines->push_back("OK");
+    }
+}
+
+/** @brief Check the response matching.
+ */
+static void Test_Matching(RAK3172_t& p_Device)
+{
+    std::string Values[6];
+
+    // Values with status and status without value.
+    {
+        RAK3172_BatchItem_t Items[] = {
+            {"AT+BAND=?", &Values[0], RAK3172_ERR_OK},
+            {"AT+ADR=1", NULL, RAK3172_ERR_OK},
+            {"AT+ADR=?", &Values[1], RAK3172_ERR_OK},
+            {"AT+EMPTY=?", &Values[2], RAK3172_ERR_OK},
+            {"AT+NJM=0", NULL, RAK3172_ERR_OK},
+            {"AT+NJM=?", &Values[3], RAK3172_ERR_OK},
+        };
+
+        RAK3172_Host_Module_Reset();
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_SendBatch(p_Device, Items, 6));
+        RAK3172_TEST_ASSERT(Values[0] == "4");
+        RAK3172_TEST_ASSERT(Values[1] == "1");
+        RAK3172_TEST_ASSERT(Values[2] == "1");
+        RAK3172_TEST_ASSERT(Values[3] == "0");
+        for(const RAK3172_BatchItem_t& Item : Items)
+        {
+            RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Item.Error);
+        }
+
+        // The module receives the commands in order and never more than the window without a response.
+        RAK3172_TEST_EQUAL(6, RAK3172_Host_Module_GetCommands().size());
+        RAK3172_TEST_ASSERT(RAK3172_Host_Module_GetCommands()[3] == "AT+EMPTY=?");
+        RAK3172_TEST_EQUAL(CONFIG_RAK3172_UART_BATCH_WINDOW, RAK3172_Host_Module_GetMaxPending());
+    }
+
+    // A failed command in the middle of a batch doesn´t shift the responses of the following commands.
+    {
+        RAK3172_BatchItem_t Items[] = {
+            {"AT+CLASS=?", &Values[0], RAK3172_ERR_OK},
+            {"AT+FAIL=1", NULL, RAK3172_ERR_OK},
+            {"AT+UNKNOWN=?", &Values[1], RAK3172_ERR_OK},
+            {"AT+BAND=?", &Values[2], RAK3172_ERR_OK},
+            {"AT+TXP=3", NULL, RAK3172_ERR_OK},
+        };
+
+        Values[1].clear();
+        RAK3172_Host_Module_Reset();
+        RAK3172_TEST_EQUAL(RAK3172_ERR_FAIL, RAK3172_SendBatch(p_Device, Items, 5));
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Items[0].Error);
+        RAK3172_TEST_EQUAL(RAK3172_ERR_FAIL, Items[1].Error);
+        RAK3172_TEST_EQUAL(RAK3172_ERR_FAIL, Items[2].Error);
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Items[3].Error);
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Items[4].Error);
+        RAK3172_TEST_ASSERT(Values[0] == "A");
+        RAK3172_TEST_ASSERT(Values[1].empty());
+        RAK3172_TEST_ASSERT(Values[2] == "4");
+        RAK3172_TEST_ASSERT(_Test_Settings["AT+TXP"] == "3");
+    }
+
+    // The last command gets no response.
+    {
+        RAK3172_BatchItem_t Items[] = {
+            {"AT+ADR=0", NULL, RAK3172_ERR_OK},
+            {"AT+BAND=?", &Values[0], RAK3172_ERR_OK},
+            {"AT+MUTE", NULL, RAK3172_ERR_OK},
+        };
+
+        RAK3172_Host_Module_Reset();
+        RAK3172_TEST_EQUAL(RAK3172_ERR_TIMEOUT, RAK3172_SendBatch(p_Device, Items, 3));
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Items[0].Error);
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Items[1].Error);
+        RAK3172_TEST_EQUAL(RAK3172_ERR_TIMEOUT, Items[2].Error);
+    }
+
+    // Invalid arguments and a busy device.
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_SendBatch(p_Device, NULL, 1));
+    p_Device.Internal.isBusy = true;
+    {
+        RAK3172_BatchItem_t Item = {"AT+ADR=?", &Values[0], RAK3172_ERR_OK};
+
+        RAK3172_TEST_EQUAL(RAK3172_ERR_BUSY, RAK3172_SendBatch(p_Device, &Item, 1));
+    }
+    p_Device.Internal.isBusy = false;
+}
+
+/** @brief          Transmit the commands one after the other.
+ *  @param p_Device RAK3172 device object
+ *  @param Items    Commands
+ *  @return         Wall time in microseconds
+ */
+static double Test_Sequential(RAK3172_t& p_Device, std::vector<RAK3172_BatchItem_t>& Items)
+{
+    RAK3172_Host_Module_Reset();
+
+    for(RAK3172_BatchItem_t& Item : Items)
+    {
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_SendCommand(p_Device, Item.Command, Item.p_Value));
+    }
+
+    RAK3172_TEST_EQUAL(1, RAK3172_Host_Module_GetMaxPending());
+
+    return RAK3172_Host_Module_GetTime();
+}
+
+/** @brief          Transmit the commands as batch.
+ *  @param p_Device RAK3172 device object
+ *  @param Items    Commands
+ *  @return         Wall time in microseconds
+ */
+static double Test_Batched(RAK3172_t& p_Device, std::vector<RAK3172_BatchItem_t>& Items)
+{
+    RAK3172_Host_Module_Reset();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_SendBatch(p_Device, Items.data(), Items.size()));
+
+    return RAK3172_Host_Module_GetTime();
+}
+
+int main(void)
+{
+    RAK3172_t Device = {};
+    std::vector<RAK3172_BatchItem_t> Writes;
+    std::vector<RAK3172_BatchItem_t> Queries;
+    std::vector<std::string> Values;
+
+    Device.UART.Interface = UART_NUM_1;
+    Device.Internal.Lock = xSemaphoreCreateRecursiveMutex();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LinePool_Init(Device));
+    Device.Internal.isInitialized = true;
+    uart_set_baudrate(Device.UART.Interface, 115200);
+
+    RAK3172_Host_Module_Init(Device, Test_Module_Handler, TEST_MODULE_PROCESSING);
+
+    Test_Matching(Device);
+
+    // Configuration of "RAK3172_LoRaWAN_Init" with OTAA and a sub band. "RAK3172_LoRaWAN_Apply" reads all parameters and
+    // writes the parameters which differ from the module state.
+    Writes = {
+        {"AT+CLASS=A", NULL, RAK3172_ERR_OK},
+        {"AT+ADR=1", NULL, RAK3172_ERR_OK},
+        {"AT+BAND=4", NULL, RAK3172_ERR_OK},
+        {"AT+MASK=0002", NULL, RAK3172_ERR_OK},
+        {"AT+TXP=0", NULL, RAK3172_ERR_OK},
+        {"AT+NJM=1", NULL, RAK3172_ERR_OK},
+        {"AT+DEVEUI=AC1F09FFFE0A1B2C", NULL, RAK3172_ERR_OK},
+        {"AT+APPEUI=AC1F09FFF8683172", NULL, RAK3172_ERR_OK},
+        {"AT+APPKEY=2B7E151628AED2A6ABF7158809CF4F3C", NULL, RAK3172_ERR_OK},
+    };
+
+    Values.resize(Writes.size());
+    for(size_t i = 0; i < Writes.size(); i++)
+    {
+        Queries.push_back({Writes[i].Command.substr(0, Writes[i].Command.find('=') + 1) + "?", &Values[i], RAK3172_ERR_OK});
+    }
+
+    printf("Configuration of RAK3172_LoRaWAN_Init (%u commands), batch window %u, module processing time %u us (assumed):\n",
+           static_cast<unsigned int>(Writes.size()), CONFIG_RAK3172_UART_BATCH_WINDOW, TEST_MODULE_PROCESSING);
+    printf("    %-10s %-8s %-17s %-14s %s\n", "Baudrate", "Step", "Sequential [ms]", "Batched [ms]", "Saved");
+
+    for(uint32_t Baudrate : {9600U, 115200U})
+    {
+        uart_set_baudrate(Device.UART.Interface, Baudrate);
+
+        for(std::vector<RAK3172_BatchItem_t>* Items : {&Queries, &Writes})
+        {
+            double Sequential = Test_Sequential(Device, *Items);
+            double Batched = Test_Batched(Device, *Items);
+
+            printf("    %-10u %-8s %-17.2f %-14.2f %.0f %%\n", Baudrate, (Items == &Queries) ? "Read" : "Write", Sequential / 1000.0, Batched / 1000.0,
+                   100.0 * (Sequential - Batched) / Sequential);
+
+            RAK3172_TEST_ASSERT(Batched < Sequential);
+        }
+    }
+
+    RAK3172_Host_Module_Deinit();
+    RAK3172_LinePool_Deinit(Device);
+
+    return RAK3172_Test_Result();
+}
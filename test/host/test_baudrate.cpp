@@ -0,0 +1,122 @@
+/*
+ * Host measurement of the command round trip at the supported baud rates.
+ * The test transmits typical commands with "RAK3172_SendCommand" to a simulated module and takes the round trip from the
+ * timeline of the simulated serial link. The round trip contains the transmission of the command, the processing time of
+ * the module and the transmission of the response lines.
+ * NOTE: The processing time of the module is an assumption. It isn´t measured with a real module.
+ */
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+#include "rak3172.h"
+
+#include "Buffer/rak3172_line_pool.h"
+
+#include "rak3172_host_module.h"
+#include "rak3172_test.h"
+
+/** @brief Assumed processing time of the module for each command in microseconds.
+ */
+#define TEST_MODULE_PROCESSING                  1000
+
+/** @brief Number of transmissions of each command.
+ */
+#define TEST_ROUNDS                             10
+
+/** @brief              Command handler of the simulated module. The module answers queries with a value and a status line
+ *                      and all other commands with a status line.
+ *  @param Command      Received command
+ *  @param p_Lines      Pointer to response lines
+ */
+static void Test_Module_Handler(const std::string& Command, std::vector<std::string>* p_Lines)
+{
+    size_t Index;
+
+    Index = Command.find("=?");
+    if(Index != std::string::npos)
+    {
+        p_Lines->push_back(Command.substr(0, Index) + "=5");
+    }
+
+    p_Lines->push_back("OK");
+}
+
+/** @brief          Get the mean round trip of a command.
+ *  @param p_Device RAK3172 device object
+ *  @param Command  Command
+ *  @param p_Value  (Optional) Pointer to returned value
+ *  @return         Round trip in microseconds
+ */
+static double Test_RoundTrip(RAK3172_t& p_Device, const std::string& Command, std::string* p_Value)
+{
+    RAK3172_Host_Module_Reset();
+
+    for(uint8_t i = 0; i < TEST_ROUNDS; i++)
+    {
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_SendCommand(p_Device, Command, p_Value));
+    }
+
+    RAK3172_TEST_EQUAL(TEST_ROUNDS, RAK3172_Host_Module_GetCommands().size());
+
+    return RAK3172_Host_Module_GetTime() / TEST_ROUNDS;
+}
+
+int main(void)
+{
+    RAK3172_t Device = {};
+    std::string Value;
+    std::vector<std::string> Commands;
+    std::vector<double> Previous;
+
+    Device.UART.Interface = UART_NUM_1;
+    Device.Internal.Lock = xSemaphoreCreateRecursiveMutex();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LinePool_Init(Device));
+    Device.Internal.isInitialized = true;
+
+    RAK3172_Host_Module_Init(Device, Test_Module_Handler, TEST_MODULE_PROCESSING);
+
+    // Status check, setting query and a confirmed uplink with the maximum payload of DR0 in EU868.
+    Commands = {
+        "AT",
+        "AT+DR=?",
+        "AT+SEND=1:" + std::string(2 * 51, 'A'),
+    };
+
+    printf("Command round trip with RAK3172_SendCommand, module processing time %u us (assumed):\n", TEST_MODULE_PROCESSING);
+    printf("    %-10s %-12s %-10s %-10s %s\n", "Baudrate", "Byte [us]", "AT [ms]", "Query [ms]", "Uplink [ms]");
+
+    for(uint32_t Baudrate : {9600U, 19200U, 57600U, 115200U})
+    {
+        std::vector<double> RoundTrips;
+
+        uart_set_baudrate(Device.UART.Interface, Baudrate);
+
+        for(const std::string& Command : Commands)
+        {
+            RoundTrips.push_back(Test_RoundTrip(Device, Command, (Command.find("=?") != std::string::npos) ? &Value : NULL));
+        }
+
+        printf("    %-10u %-12.2f %-10.2f %-10.2f %.2f\n", Baudrate, 10.0e6 / Baudrate, RoundTrips[0] / 1000.0, RoundTrips[1] / 1000.0,
+               RoundTrips[2] / 1000.0);
+
+        // Each command round trip must be shorter with a higher baud rate.
+        if(Previous.empty() == false)
+        {
+            for(size_t i = 0; i < RoundTrips.size(); i++)
+            {
+                RAK3172_TEST_ASSERT(RoundTrips[i] < Previous[i]);
+            }
+        }
+
+        Previous = RoundTrips;
+    }
+
+    RAK3172_TEST_ASSERT(Value == "5");
+
+    RAK3172_Host_Module_Deinit();
+    RAK3172_LinePool_Deinit(Device);
+
+    return RAK3172_Test_Result();
+}
@@ -0,0 +1,330 @@
+/*
+ * Host test and benchmark for the payload compression.
+ * The test decodes the payloads of the codecs with a port of the backend decoder "examples/Compression/decoder.py" and checks
+ * the fallback to uncompressed payloads. The test writes the payloads into a vector file when a path is passed as argument.
+ * "examples/Compression/test_decoder.py" decodes the vector file with the backend decoder.
+ * The benchmark measures the compression ratio and the cycles per byte of both codecs for typical sensor payloads.
+ * NOTE: The cycles are measured with the time stamp counter of x86 hosts. Other hosts report nanoseconds instead.
+ */
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+#if(defined __x86_64__) || (defined __i386__)
+    #include <x86intrin.h>
+#endif
+
+#include "rak3172.h"
+
+#include "rak3172_test.h"
+
+/** @brief Number of compressed bytes for each payload of the benchmark.
+ */
+#define TEST_BYTES                              (1024UL * 1024UL)
+
+/** @brief Number of random payloads of the vector file.
+ */
+#define TEST_VECTORS                            500
+
+/** @brief Payload types of the test.
+ */
+typedef enum
+{
+    TEST_DATA_TEXT = 0,                         /**< JSON records. */
+    TEST_DATA_SERIES,                           /**< Series of 16 bit sensor values. */
+    TEST_DATA_RANDOM,                           /**< Random bytes. */
+} Test_Data_t;
+
+/** @brief  Get the time stamp for the benchmark.
+ *  @return CPU cycles on x86 hosts, nanoseconds otherwise
+ */
+static inline uint64_t Test_Timestamp(void)
+{
+    #if(defined __x86_64__) || (defined __i386__)
+        return __rdtsc();
+    #else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+/** @brief          Create a payload.
+ *  @param Type     Payload type
+ *  @param Length   Length of the payload. Must be even for sensor values
+ *  @param Random   Random generator
+ *  @return         Payload
+ */
+static std::vector<uint8_t> Test_Data(Test_Data_t Type, size_t Length, std::mt19937& Random)
+{
+    std::vector<uint8_t> Data;
+
+    if(Type == TEST_DATA_TEXT)
+    {
+        char Record[64];
+
+        while(Data.size() < Length)
+        {
+            snprintf(Record, sizeof(Record), "{\"t\":%d.%u,\"h\":%u,\"p\":%u}", static_cast<int>(Random() % 30), static_cast<unsigned int>(Random() % 10),
+                     static_cast<unsigned int>(30 + (Random() % 40)), static_cast<unsigned int>(990 + (Random() % 40)));
+            Data.insert(Data.end(), Record, Record + strlen(Record));
+        }
+
+        Data.resize(Length);
+    }
+    else if(Type == TEST_DATA_SERIES)
+    {
+        int16_t Value = static_cast<int16_t>(Random());
+
+        for(size_t i = 0; i < Length; i += 2)
+        {
+            Value += static_cast<int16_t>(Random() % 41) - 20;
+            Data.push_back(static_cast<uint8_t>(Value));
+            Data.push_back(static_cast<uint8_t>(Value >> 8));
+        }
+    }
+    else
+    {
+        for(size_t i = 0; i < Length; i++)
+        {
+            Data.push_back(static_cast<uint8_t>(Random()));
+        }
+    }
+
+    return Data;
+}
+
+/** @brief          Port of the backend decoder "examples/Compression/decoder.py".
+ *  @param p_Data   Pointer to payload with codec header
+ *  @param Length   Length of the payload
+ *  @return         Uncompressed data
+ */
+static std::vector<uint8_t> Test_Decode(const uint8_t* p_Data, size_t Length)
+{
+    std::vector<uint8_t> Output;
+
+    if(Length == 0)
+    {
+        return Output;
+    }
+
+    if(p_Data[0] == RAK3172_CODEC_ID_RAW)
+    {
+        Output.assign(p_Data + 1, p_Data + Length);
+    }
+    else if(p_Data[0] == RAK3172_CODEC_ID_LZ)
+    {
+        size_t i = 1;
+
+        while(i < Length)
+        {
+            uint8_t Flags = p_Data[i++];
+
+            for(uint8_t Bit = 0; (Bit < 8) && (i < Length); Bit++)
+            {
+                if(Flags & (0x01 << Bit))
+                {
+                    size_t Offset = p_Data[i] + 1;
+                    size_t Match = p_Data[i + 1] + 3;
+
+                    i += 2;
+
+                    // Matches can overlap the output. Copy byte by byte.
+                    for(size_t j = 0; j < Match; j++)
+                    {
+                        Output.push_back(Output[Output.size() - Offset]);
+                    }
+                }
+                else
+                {
+                    Output.push_back(p_Data[i++]);
+                }
+            }
+        }
+    }
+    else if(p_Data[0] == RAK3172_CODEC_ID_DELTA16)
+    {
+        int16_t Previous = 0;
+        uint32_t Value = 0;
+        uint8_t Shift = 0;
+
+        for(size_t i = 1; i < Length; i++)
+        {
+            Value |= static_cast<uint32_t>(p_Data[i] & 0x7F) << Shift;
+            Shift += 7;
+
+            if((p_Data[i] & 0x80) == 0)
+            {
+                int32_t Delta = static_cast<int32_t>(Value >> 1) ^ -static_cast<int32_t>(Value & 0x01);
+
+                Previous = static_cast<int16_t>(Previous + Delta);
+                Output.push_back(static_cast<uint8_t>(Previous));
+                Output.push_back(static_cast<uint8_t>(Previous >> 8));
+                Value = 0;
+                Shift = 0;
+            }
+        }
+    }
+
+    return Output;
+}
+
+/** @brief          Compress a payload and check that the decoder restores it.
+ *  @param p_Codec  Codec
+ *  @param Data     Payload
+ *  @return         Length of the compressed payload with header
+ */
+static size_t Test_RoundTrip(const RAK3172_Codec_t* p_Codec, const std::vector<uint8_t>& Data)
+{
+    uint8_t Output[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+    size_t Length;
+
+    Length = RAK3172_Codec_Encode(p_Codec, Data.data(), Data.size(), Output, sizeof(Output));
+    RAK3172_TEST_ASSERT(Length > 0);
+    RAK3172_TEST_ASSERT(Length <= (Data.size() + RAK3172_CODEC_HEADER_SIZE));
+    RAK3172_TEST_ASSERT(Test_Decode(Output, Length) == Data);
+
+    return Length;
+}
+
+/** @brief Check the codecs with typical payloads, the fallback to uncompressed payloads and invalid arguments.
+ */
+static void Test_Codec(void)
+{
+    std::mt19937 Random(1);
+    std::vector<uint8_t> Data;
+    uint8_t Output[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+    RAK3172_Segment_t Segments[2];
+
+    for(Test_Data_t Type : {TEST_DATA_TEXT, TEST_DATA_SERIES, TEST_DATA_RANDOM})
+    {
+        for(size_t Length : {2UL, 10UL, 51UL, 242UL})
+        {
+            Data = Test_Data(Type, Length, Random);
+
+            Test_RoundTrip(&RAK3172_Codec_LZ, Data);
+            Test_RoundTrip(&RAK3172_Codec_Delta16, Data);
+            Test_RoundTrip(NULL, Data);
+        }
+    }
+
+    // Repeated data compresses with overlapping matches.
+    Data.assign(242, 'A');
+    RAK3172_TEST_ASSERT(Test_RoundTrip(&RAK3172_Codec_LZ, Data) < 10);
+
+    // Random data and an odd length for the delta codec are transmitted uncompressed.
+    Data = Test_Data(TEST_DATA_RANDOM, 242, Random);
+    RAK3172_TEST_EQUAL(243, RAK3172_Codec_Encode(&RAK3172_Codec_LZ, Data.data(), Data.size(), Output, sizeof(Output)));
+    RAK3172_TEST_EQUAL(RAK3172_CODEC_ID_RAW, Output[0]);
+    Data = Test_Data(TEST_DATA_SERIES, 50, Random);
+    Data.push_back(0);
+    RAK3172_TEST_EQUAL(52, RAK3172_Codec_Encode(&RAK3172_Codec_Delta16, Data.data(), Data.size(), Output, sizeof(Output)));
+    RAK3172_TEST_EQUAL(RAK3172_CODEC_ID_RAW, Output[0]);
+
+    // Segments are compressed as continuous data.
+    Data = Test_Data(TEST_DATA_SERIES, 100, Random);
+    Segments[0] = {Data.data(), 40};
+    Segments[1] = {Data.data() + 40, 60};
+    RAK3172_TEST_ASSERT(Test_Decode(Output, RAK3172_Codec_Encode(&RAK3172_Codec_Delta16, Segments, 2, Output, sizeof(Output))) == Data);
+
+    // Output buffers which are too small.
+    RAK3172_TEST_EQUAL(0, RAK3172_Codec_Encode(&RAK3172_Codec_LZ, Data.data(), Data.size(), Output, 1));
+    Data = Test_Data(TEST_DATA_RANDOM, 100, Random);
+    RAK3172_TEST_EQUAL(0, RAK3172_Codec_Encode(&RAK3172_Codec_LZ, Data.data(), Data.size(), Output, 50));
+    RAK3172_TEST_EQUAL(0, RAK3172_Codec_Encode(&RAK3172_Codec_LZ, static_cast<const uint8_t*>(NULL), 10, Output, sizeof(Output)));
+}
+
+/** @brief          Write random payloads for the backend decoder into a vector file.
+ *                  Each line contains the uncompressed data and the payload with codec header as hex string.
+ *  @param p_Path   Path of the vector file
+ */
+static void Test_WriteVectors(const char* p_Path)
+{
+    std::mt19937 Random(2);
+    FILE* File;
+    uint8_t Output[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+
+    File = fopen(p_Path, "w");
+    RAK3172_TEST_ASSERT(File != NULL);
+    if(File == NULL)
+    {
+        return;
+    }
+
+    for(int i = 0; i < TEST_VECTORS; i++)
+    {
+        Test_Data_t Type = static_cast<Test_Data_t>(Random() % 3);
+        const RAK3172_Codec_t* Codec = (Random() % 2) ? &RAK3172_Codec_LZ : &RAK3172_Codec_Delta16;
+        std::vector<uint8_t> Data = Test_Data(Type, 2 * (1 + (Random() % 121)), Random);
+        size_t Length;
+
+        Length = RAK3172_Codec_Encode(Codec, Data.data(), Data.size(), Output, sizeof(Output));
+        RAK3172_TEST_ASSERT(Length > 0);
+
+        for(uint8_t Byte : Data)
+        {
+            fprintf(File, "%02X", Byte);
+        }
+        fprintf(File, " ");
+        for(size_t j = 0; j < Length; j++)
+        {
+            fprintf(File, "%02X", Output[j]);
+        }
+        fprintf(File, "\n");
+    }
+
+    fclose(File);
+}
+
+int main(int argc, char** argv)
+{
+    std::mt19937 Random(3);
+    uint8_t Output[CONFIG_RAK3172_COMPRESSION_BUFFER_SIZE];
+    size_t Checksum = 0;
+
+    Test_Codec();
+
+    if(argc > 1)
+    {
+        Test_WriteVectors(argv[1]);
+    }
+
+    #if(defined __x86_64__) || (defined __i386__)
+        printf("Payload        Length    Codec     Ratio     [cycles / byte]\n");
+    #else
+        printf("Payload        Length    Codec     Ratio     [ns / byte]\n");
+    #endif
+
+    // Maximum payload of EU868 DR0 and of the fastest data rates.
+    for(Test_Data_t Type : {TEST_DATA_TEXT, TEST_DATA_SERIES, TEST_DATA_RANDOM})
+    {
+        for(size_t Length : {51UL, 242UL})
+        {
+            std::vector<uint8_t> Data = Test_Data(Type, Length, Random);
+
+            for(const RAK3172_Codec_t* Codec : {&RAK3172_Codec_LZ, &RAK3172_Codec_Delta16})
+            {
+                size_t Rounds = TEST_BYTES / Length;
+                size_t Compressed;
+                uint64_t Start;
+
+                Compressed = Test_RoundTrip(Codec, Data);
+
+                Start = Test_Timestamp();
+                for(size_t i = 0; i < Rounds; i++)
+                {
+                    Checksum += RAK3172_Codec_Encode(Codec, Data.data(), Data.size(), Output, sizeof(Output));
+                }
+
+                printf("%-14s %-9u %-9s %-9.2f %.1f\n", (Type == TEST_DATA_TEXT) ? "JSON" : ((Type == TEST_DATA_SERIES) ? "Int16 series" : "Random"),
+                       static_cast<unsigned int>(Length), (Codec == &RAK3172_Codec_LZ) ? "LZ" : "Delta16", static_cast<double>(Compressed) / Length,
+                       static_cast<double>(Test_Timestamp() - Start) / (Rounds * Length));
+            }
+        }
+    }
+
+    printf("Checksum: %u\n", static_cast<unsigned int>(Checksum));
+
+    return RAK3172_Test_Result();
+}
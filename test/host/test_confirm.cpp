@@ -0,0 +1,275 @@
+/*
+ * Host test for confirmed uplinks and the RX2 settings.
+ * The test replaces the module with a UART hook which answers the commands of the driver. The hook reports the
+ * confirmation result of an uplink with the event group bits of the event task. The test checks that
+ * "RAK3172_LoRaWAN_Transmit" returns a rejected uplink without waiting for the confirmation deadline and without
+ * charging the duty cycle ledger, that the deadline includes the off time of the duty cycle, that the ledger charges
+ * each frame of a long payload and that the RX2 data rate setter doesn´t change the RX2 delay.
+ */
+
+#include <string>
+#include <vector>
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "Buffer/rak3172_line_pool.h"
+
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+/** @brief Confirmation result which is reported by the simulated module.
+ */
+typedef enum
+{
+    TEST_CONFIRM_NONE = 0,                      /**< No confirmation result. */
+    TEST_CONFIRM_OK,                            /**< Uplink acknowledged by the network. */
+    TEST_CONFIRM_FAILED,                        /**< Uplink not acknowledged by the network. */
+} Test_Confirm_t;
+
+/** @brief Simulated module.
+ */
+typedef struct
+{
+    RAK3172_t* p_Device;
+    std::string Line;
+    std::vector<std::string> Commands;
+    std::string SendStatus;
+    Test_Confirm_t Confirm;
+} Test_Module_t;
+
+static Test_Module_t _Test_Module;
+
+/** @brief          Add a line to the receive path of the driver.
+ *  @param Data     Line without line ending
+ */
+static void Test_Module_Answer(const std::string& Data)
+{
+    RAK3172_Line_t* Line = RAK3172_LinePool_Take(*_Test_Module.p_Device);
+
+    if(Line != NULL)
+    {
+        strcpy(Line->Data, Data.c_str());
+        Line->Length = Data.length();
+        RAK3172_LinePool_Push(*_Test_Module.p_Device, Line);
+    }
+}
+
+/** @brief          UART hook. The module answers each complete command.
+ *  @param p_Data   Pointer to written data
+ *  @param Length   Length of the written data
+ */
+static void Test_UART_Write(const char* p_Data, size_t Length)
+{
+    std::string Command;
+
+    _Test_Module.Line.append(p_Data, Length);
+    if((_Test_Module.Line.length() < 2) || (_Test_Module.Line.compare(_Test_Module.Line.length() - 2, 2, "\r\n") != 0))
+    {
+        return;
+    }
+
+    Command = _Test_Module.Line.substr(0, _Test_Module.Line.length() - 2);
+    _Test_Module.Line.clear();
+    _Test_Module.Commands.push_back(Command);
+
+    if(Command == "AT+RX2DL=?")
+    {
+        Test_Module_Answer("AT+RX2DL=2");
+        Test_Module_Answer("OK");
+    }
+    else if(Command == "AT+DR=?")
+    {
+        Test_Module_Answer("AT+DR=5");
+        Test_Module_Answer("OK");
+    }
+    else if(Command.rfind("AT+SEND=", 0) == 0)
+    {
+        Test_Module_Answer(_Test_Module.SendStatus);
+
+        // The event task reports the result of an accepted confirmed uplink.
+        if(_Test_Module.Confirm == TEST_CONFIRM_OK)
+        {
+            xEventGroupSetBits(_Test_Module.p_Device->Internal.Events, RAK3172_EVENT_CONFIRMED_OK);
+        }
+        else if(_Test_Module.Confirm == TEST_CONFIRM_FAILED)
+        {
+            xEventGroupSetBits(_Test_Module.p_Device->Internal.Events, RAK3172_EVENT_CONFIRMED_FAILED);
+        }
+    }
+    else
+    {
+        Test_Module_Answer("OK");
+    }
+}
+
+/** @brief              Prepare the simulated module for the next uplink.
+ *  @param p_Device     RAK3172 device object
+ *  @param SendStatus   Status of the module for the uplink command
+ *  @param Confirm      Confirmation result which is reported after the uplink command
+ */
+static void Test_Module_Reset(RAK3172_t& p_Device, const std::string& SendStatus, Test_Confirm_t Confirm)
+{
+    _Test_Module.Line.clear();
+    _Test_Module.Commands.clear();
+    _Test_Module.SendStatus = SendStatus;
+    _Test_Module.Confirm = Confirm;
+
+    RAK3172_LoRaWAN_DutyCycle_Clear(p_Device);
+    p_Device.Statistics.AckTimeouts = 0;
+    RAK3172_Host_Advance(1000);
+}
+
+/** @brief Check the confirmation results and the handling of rejected uplinks.
+ */
+static void Test_Confirmed(RAK3172_t& p_Device)
+{
+    uint8_t Data[10] = {0};
+    uint32_t Start;
+
+    // Acknowledged uplink.
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_OK);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 0, true, NULL));
+    RAK3172_TEST_ASSERT(RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device) > 0);
+    RAK3172_TEST_ASSERT(p_Device.Internal.isBusy == false);
+
+    // Not acknowledged uplink.
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_FAILED);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_RESPONSE, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 0, true, NULL));
+    RAK3172_TEST_ASSERT(RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device) > 0);
+
+    // No confirmation result before the deadline.
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_NONE);
+    Start = RAK3172_Host_Now();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_TIMEOUT, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 0, true, NULL));
+    RAK3172_TEST_ASSERT((RAK3172_Host_Now() - Start) > 2000);
+    RAK3172_TEST_EQUAL(1, p_Device.Statistics.AckTimeouts);
+    RAK3172_TEST_ASSERT(p_Device.Internal.isBusy == false);
+
+    // The retransmission is delayed by the off time of the duty cycle. With ADR the deadline uses DR0, because the ADR can lower the
+    // data rate during the retransmissions.
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_NONE);
+    p_Device.Cache.ADR = true;
+    Start = RAK3172_Host_Now();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_TIMEOUT, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 1, true, NULL));
+    RAK3172_TEST_ASSERT((RAK3172_Host_Now() - Start) > (RAK3172_LoRaWAN_GetPayloadTimeOnAir(RAK_BAND_EU868, RAK_DR_0, sizeof(Data)) * 100));
+    RAK3172_TEST_ASSERT(p_Device.Internal.isBusy == false);
+    p_Device.Cache.ADR = false;
+
+    // The module rejects the uplink. The function returns the error without waiting for the deadline and without an entry
+    // in the duty cycle ledger.
+    Test_Module_Reset(p_Device, "AT_NO_NETWORK_JOINED", TEST_CONFIRM_NONE);
+    Start = RAK3172_Host_Now();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_FAIL, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 0, true, NULL));
+    RAK3172_TEST_ASSERT((RAK3172_Host_Now() - Start) < 1000);
+    RAK3172_TEST_EQUAL(0, p_Device.Statistics.AckTimeouts);
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device));
+    RAK3172_TEST_ASSERT(p_Device.Internal.isBusy == false);
+
+    // Busy and restricted module.
+    Test_Module_Reset(p_Device, "AT_BUSY_ERROR", TEST_CONFIRM_NONE);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_BUSY, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 0, true, NULL));
+    Test_Module_Reset(p_Device, "Restricted", TEST_CONFIRM_NONE);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_RESTRICTED, RAK3172_LoRaWAN_Transmit(p_Device, 1, Data, sizeof(Data), 0, true, NULL));
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device));
+}
+
+/** @brief Check that the duty cycle ledger charges each frame of a payload which is split by the module.
+ */
+static void Test_DutyCycle(RAK3172_t& p_Device)
+{
+    uint32_t Airtime;
+
+    // 300 bytes are transmitted with a full frame and a frame with 58 bytes.
+    Airtime = RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_5, RAK3172_LORAWAN_FRAME_PAYLOAD_MAX + RAK3172_LORAWAN_FRAME_OVERHEAD) +
+              RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_5, 58 + RAK3172_LORAWAN_FRAME_OVERHEAD);
+
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_NONE);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_DutyCycle_Add(p_Device, 300));
+    RAK3172_TEST_EQUAL(Airtime * 100, RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device));
+
+    // A single frame is charged once.
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_NONE);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_DutyCycle_Add(p_Device, RAK3172_LORAWAN_FRAME_PAYLOAD_MAX));
+    RAK3172_TEST_EQUAL(RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_5, RAK3172_LORAWAN_FRAME_PAYLOAD_MAX + RAK3172_LORAWAN_FRAME_OVERHEAD) * 100,
+                       RAK3172_LoRaWAN_DutyCycle_GetWait(p_Device));
+    RAK3172_LoRaWAN_DutyCycle_Clear(p_Device);
+}
+
+/** @brief Check the data rate for the payload size of queued uplinks.
+ */
+static void Test_UplinkDataRate(RAK3172_t& p_Device)
+{
+    RAK3172_DataRate_t DR;
+
+    // Without ADR the current data rate is used.
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_NONE);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_GetUplinkDataRate(p_Device, &DR));
+    RAK3172_TEST_EQUAL(RAK_DR_5, DR);
+    RAK3172_TEST_EQUAL(0, _Test_Module.Commands.size());
+
+    // The ADR can lower the data rate before the transmission.
+    p_Device.Cache.ADR = true;
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_GetUplinkDataRate(p_Device, &DR));
+    RAK3172_TEST_EQUAL(RAK_DR_0, DR);
+    RAK3172_TEST_EQUAL(0, _Test_Module.Commands.size());
+    p_Device.Cache.ADR = false;
+
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_GetUplinkDataRate(p_Device, NULL));
+}
+
+/** @brief Check that the RX2 data rate setter writes the data rate and keeps the cached RX2 delay.
+ */
+static void Test_RX2(RAK3172_t& p_Device)
+{
+    Test_Module_Reset(p_Device, "OK", TEST_CONFIRM_NONE);
+    p_Device.Cache.RX2Delay = 2000;
+    p_Device.Cache.Valid |= RAK3172_CACHE_RX2_DELAY;
+
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_SetRX2DataRate(p_Device, 3));
+    RAK3172_TEST_EQUAL(1, _Test_Module.Commands.size());
+    RAK3172_TEST_ASSERT(_Test_Module.Commands.back() == "AT+RX2DR=3");
+    RAK3172_TEST_ASSERT(p_Device.Cache.Valid & RAK3172_CACHE_RX2_DELAY);
+    RAK3172_TEST_EQUAL(2000, p_Device.Cache.RX2Delay);
+
+    // The RX2 delay setter updates the cache.
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_SetRX2Delay(p_Device, 3));
+    RAK3172_TEST_ASSERT(_Test_Module.Commands.back() == "AT+RX2DL=3");
+    RAK3172_TEST_EQUAL(3000, p_Device.Cache.RX2Delay);
+
+    // Invalid data rate for the band.
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_SetRX2DataRate(p_Device, 6));
+}
+
+int main(void)
+{
+    RAK3172_t Device = {};
+
+    Device.UART.Interface = UART_NUM_1;
+    Device.Mode = RAK_MODE_LORAWAN;
+    Device.LoRaWAN.isJoined = true;
+    Device.Internal.Lock = xSemaphoreCreateRecursiveMutex();
+    Device.Internal.Events = xEventGroupCreate();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LinePool_Init(Device));
+    Device.Internal.isInitialized = true;
+
+    // EU868 with DR5 and without ADR. The settings are served from the cache.
+    Device.Cache.Band = RAK_BAND_EU868;
+    Device.Cache.DataRate = RAK_DR_5;
+    Device.Cache.ADR = false;
+    Device.Cache.Valid = RAK3172_CACHE_BAND | RAK3172_CACHE_DATARATE | RAK3172_CACHE_ADR;
+
+    _Test_Module.p_Device = &Device;
+    RAK3172_Host_SetUART(Test_UART_Write);
+
+    Test_Confirmed(Device);
+    Test_DutyCycle(Device);
+    Test_UplinkDataRate(Device);
+    Test_RX2(Device);
+
+    RAK3172_Host_SetUART(NULL);
+    RAK3172_LinePool_Deinit(Device);
+    vEventGroupDelete(Device.Internal.Events);
+
+    return RAK3172_Test_Result();
+}
@@ -0,0 +1,337 @@
+/*
+ * Host test and benchmark for the event parser.
+ * The test parses the line corpus from "corpus/events.txt" and compares each result with the expected event.
+ * The benchmark compares the parser with the string based event decoding of the driver before the parser was
+ * introduced (RUI3 grammar only, as it was compiled for RUI3 modules).
+ */
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+
+#include "rak3172_defs.h"
+
+#include "Parser/rak3172_event_parser.h"
+
+#include "rak3172_host_heap.h"
+#include "rak3172_test.h"
+
+/** @brief Number of passes through the corpus for the benchmark.
+ */
+#define TEST_PASSES                             20000
+
+/** @brief Expected result of a corpus line.
+ */
+typedef struct
+{
+    std::string Line;
+    RAK3172_Event_Type_t Type;
+    std::string Group;
+    std::string RSSI;
+    std::string SNR;
+    std::string Port;
+    std::string Payload;
+    int Number;
+} Test_Entry_t;
+
+/** @brief Event names used in the corpus.
+ */
+static const struct
+{
+    const char* p_Name;
+    RAK3172_Event_Type_t Type;
+} _Test_Types[] = {
+    {"NONE", RAK_EVENT_NONE},
+    {"PENDING", RAK_EVENT_PENDING},
+    {"UNKNOWN", RAK_EVENT_UNKNOWN},
+    {"JOINED", RAK_EVENT_JOINED},
+    {"JOIN_FAILED", RAK_EVENT_JOIN_FAILED},
+    {"CONFIRMED_OK", RAK_EVENT_CONFIRMED_OK},
+    {"CONFIRMED_FAILED", RAK_EVENT_CONFIRMED_FAILED},
+    {"RX", RAK_EVENT_RX},
+    {"RX_P2P", RAK_EVENT_RX_P2P},
+    {"RX_P2P_TIMEOUT", RAK_EVENT_RX_P2P_TIMEOUT},
+};
+
+/** @brief          Load the line corpus.
+ *  @param p_Path   Path to corpus file
+ *  @param p_Entries Pointer to list of corpus entries
+ *  @return         #true when successful
+ */
+static bool Test_LoadCorpus(const char* p_Path, std::vector<Test_Entry_t>* p_Entries)
+{
+    std::ifstream File(p_Path);
+    std::string Line;
+    int Number = 0;
+
+    if(File.is_open() == false)
+    {
+        return false;
+    }
+
+    while(std::getline(File, Line))
+    {
+        size_t Separator;
+        std::string Name;
+        std::istringstream Fields;
+        Test_Entry_t Entry;
+
+        Number++;
+
+        if(Line.empty() || (Line[0] == '#'))
+        {
+            continue;
+        }
+
+        Separator = Line.rfind(" | ");
+        if(Separator == std::string::npos)
+        {
+            printf("Corpus line %d: Missing separator\n", Number);
+
+            return false;
+        }
+
+        Entry.Line = Line.substr(0, Separator);
+        Entry.Number = Number;
+        Fields.str(Line.substr(Separator + 3));
+        Fields >> Name >> Entry.Group >> Entry.RSSI >> Entry.SNR >> Entry.Port >> Entry.Payload;
+
+        Entry.Type = static_cast<RAK3172_Event_Type_t>(-1);
+        for(size_t i = 0; i < (sizeof(_Test_Types) / sizeof(_Test_Types[0])); i++)
+        {
+            if(Name == _Test_Types[i].p_Name)
+            {
+                Entry.Type = _Test_Types[i].Type;
+            }
+        }
+
+        if(Entry.Type == static_cast<RAK3172_Event_Type_t>(-1))
+        {
+            printf("Corpus line %d: Unknown event type %s\n", Number, Name.c_str());
+
+            return false;
+        }
+
+        p_Entries->push_back(Entry);
+    }
+
+    return p_Entries->empty() == false;
+}
+
+/** @brief          Compare an optional numeric field of a decoded event with the corpus.
+ *  @param Expected Expected value from the corpus ("-" or empty when unused)
+ *  @param Actual   Decoded value
+ *  @return         #true when the values match
+ */
+static bool Test_Field(const std::string& Expected, long Actual)
+{
+    return Expected.empty() || (Expected == "-") || (strtol(Expected.c_str(), NULL, 10) == Actual);
+}
+
+/** @brief          Check the decoded event against the corpus entry.
+ *  @param Entry    Corpus entry
+ *  @param Type     Decoded event type
+ *  @param Event    Decoded event
+ */
+static void Test_Check(const Test_Entry_t& Entry, RAK3172_Event_Type_t Type, const RAK3172_Event_t& Event)
+{
+    std::string Payload;
+    static const char _Groups[] = {'1', '2', 'B', 'C'};
+
+    if(Type != Entry.Type)
+    {
+        printf("Corpus line %d: \"%s\" decoded as type %d\n", Entry.Number, Entry.Line.c_str(), Type);
+        RAK3172_TEST_EQUAL(Entry.Type, Type);
+
+        return;
+    }
+
+    if((Type != RAK_EVENT_RX) && (Type != RAK_EVENT_RX_P2P))
+    {
+        return;
+    }
+
+    Payload.assign(Event.p_Payload, Event.PayloadLength);
+
+    RAK3172_TEST_ASSERT(Test_Field(Entry.RSSI, Event.RSSI));
+    RAK3172_TEST_ASSERT(Test_Field(Entry.SNR, Event.SNR));
+    RAK3172_TEST_ASSERT(Payload == ((Entry.Payload == "-") ? "" : Entry.Payload));
+
+    if(Type == RAK_EVENT_RX)
+    {
+        RAK3172_TEST_ASSERT(Test_Field(Entry.Port, Event.Port));
+        RAK3172_TEST_ASSERT((Event.Group < sizeof(_Groups)) && (Entry.Group[0] == _Groups[Event.Group]));
+    }
+}
+
+/** @brief          String based event decoding of the driver before the event parser was introduced.
+ *                  Only the decoding steps are kept. The logic is unchanged.
+ *  @param Line     Received line without line endings
+ *  @param p_RSSI   Pointer to RSSI
+ *  @param p_Port   Pointer to port
+ *  @param p_Payload Pointer to payload
+ *  @return         Decoded event type
+ */
+static RAK3172_Event_Type_t Test_StringParse(const std::string& Line, int* p_RSSI, int* p_Port, std::string* p_Payload)
+{
+    std::string* Response = new std::string(Line);
+    RAK3172_Event_Type_t Type = RAK_EVENT_NONE;
+
+    if(Response->find("+EVT") != std::string::npos)
+    {
+        Type = RAK_EVENT_UNKNOWN;
+
+        if(Response->find("JOINED") != std::string::npos)
+        {
+            Type = RAK_EVENT_JOINED;
+        }
+        else if(Response->find("JOIN_FAILED_RX_TIMEOUT") != std::string::npos)
+        {
+            Type = RAK_EVENT_JOIN_FAILED;
+        }
+        else if(Response->find("SEND_CONFIRMED_FAILED") != std::string::npos)
+        {
+            Type = RAK_EVENT_CONFIRMED_FAILED;
+        }
+        else if(Response->find("SEND_CONFIRMED_OK") != std::string::npos)
+        {
+            Type = RAK_EVENT_CONFIRMED_OK;
+        }
+        else if(Response->find("RXP2P") != std::string::npos)
+        {
+            std::string Dummy;
+
+            Response->erase(Response->find("+EVT:"), std::string("+EVT:").length() + 6);
+
+            Dummy = Response->substr(0, Response->find(":"));
+            Response->erase(0, std::string(Dummy + ":").length());
+            *p_RSSI = std::stoi(Dummy);
+
+            Dummy = Response->substr(0, Response->find(":"));
+            Response->erase(0, std::string(Dummy + ":").length());
+
+            *p_Payload = *Response;
+            Type = RAK_EVENT_RX_P2P;
+        }
+        else if(Response->find("RX") != std::string::npos)
+        {
+            std::string Dummy;
+
+            Response->erase(Response->find("+EVT:"), std::string("+EVT:").length());
+            Response->erase(0, sizeof("RX_x"));
+
+            Dummy = Response->substr(0, Response->find(":"));
+            Response->erase(0, std::string(Dummy + ":").length());
+            *p_RSSI = std::stoi(Dummy);
+
+            Dummy = Response->substr(0, Response->find(":"));
+            Response->erase(0, std::string(Dummy + ":").length());
+
+            Response->erase(0, Response->find(":") + 1);
+
+            Dummy = Response->substr(0, Response->find(":"));
+            Response->erase(Response->find(Dummy), std::string(Dummy + ":").length());
+            *p_Port = std::stoi(Dummy);
+
+            *p_Payload = *Response;
+            Type = RAK_EVENT_RX;
+        }
+    }
+
+    delete Response;
+
+    return Type;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<Test_Entry_t> Corpus;
+    std::vector<Test_Entry_t> Benchmark;
+    RAK3172_EventParser_t Parser;
+    RAK3172_Event_t Event;
+    size_t Allocations;
+    size_t ParserAllocations;
+    size_t Checksum;
+    std::chrono::steady_clock::time_point Start;
+    double ParserTime;
+    double StringTime;
+    size_t Lines;
+
+    if((argc < 2) || (Test_LoadCorpus(argv[1], &Corpus) == false))
+    {
+        printf("Usage: %s <corpus file>\n", argv[0]);
+
+        return 1;
+    }
+
+    // Decode the corpus in order.
+    RAK3172_EventParser_Reset(&Parser);
+    for(size_t i = 0; i < Corpus.size(); i++)
+    {
+        RAK3172_Event_Type_t Type;
+
+        Type = RAK3172_EventParser_Parse(&Parser, reinterpret_cast<const uint8_t*>(Corpus[i].Line.c_str()), Corpus[i].Line.length(), &Event);
+        Test_Check(Corpus[i], Type, Event);
+    }
+
+    // Line endings are ignored.
+    RAK3172_EventParser_Reset(&Parser);
+    RAK3172_TEST_EQUAL(RAK_EVENT_JOINED, RAK3172_EventParser_Parse(&Parser, reinterpret_cast<const uint8_t*>("\r\n+EVT:JOINED\r\n"), 15, &Event));
+
+    // Benchmark with the valid single line RUI3 events and responses, which are supported by both implementations.
+    for(size_t i = 0; i < Corpus.size(); i++)
+    {
+        if((Corpus[i].Type == RAK_EVENT_UNKNOWN) || (Corpus[i].Type == RAK_EVENT_PENDING) || (Corpus[i].Type == RAK_EVENT_RX_P2P_TIMEOUT) || (Corpus[i].Line.find(' ') != std::string::npos))
+        {
+            continue;
+        }
+
+        Benchmark.push_back(Corpus[i]);
+    }
+
+    Lines = TEST_PASSES * Benchmark.size();
+
+    Checksum = 0;
+    ParserAllocations = RAK3172_Host_GetAllocations();
+    Start = std::chrono::steady_clock::now();
+    for(size_t Pass = 0; Pass < TEST_PASSES; Pass++)
+    {
+        for(size_t i = 0; i < Benchmark.size(); i++)
+        {
+            Checksum += RAK3172_EventParser_Parse(&Parser, reinterpret_cast<const uint8_t*>(Benchmark[i].Line.data()), Benchmark[i].Line.length(), &Event);
+            Checksum += Event.PayloadLength;
+        }
+    }
+    ParserTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+    ParserAllocations = RAK3172_Host_GetAllocations() - ParserAllocations;
+
+    RAK3172_TEST_EQUAL(0, ParserAllocations);
+
+    Allocations = RAK3172_Host_GetAllocations();
+    Start = std::chrono::steady_clock::now();
+    for(size_t Pass = 0; Pass < TEST_PASSES; Pass++)
+    {
+        for(size_t i = 0; i < Benchmark.size(); i++)
+        {
+            int RSSI = 0;
+            int Port = 0;
+            std::string Payload;
+
+            Checksum += Test_StringParse(Benchmark[i].Line, &RSSI, &Port, &Payload);
+            Checksum += Payload.length();
+        }
+    }
+    StringTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+    Allocations = RAK3172_Host_GetAllocations() - Allocations;
+
+    printf("%u corpus lines, %u benchmark lines (checksum %u)\n", static_cast<unsigned int>(Corpus.size()), static_cast<unsigned int>(Benchmark.size()), static_cast<unsigned int>(Checksum));
+    printf("Decoder             Heap calls / line   ns / line\n");
+    printf("Event parser        %17.2f   %9.1f\n", static_cast<double>(ParserAllocations) / Lines, ParserTime / Lines);
+    printf("String search       %17.2f   %9.1f\n", static_cast<double>(Allocations) / Lines, StringTime / Lines);
+
+    return RAK3172_Test_Result();
+}
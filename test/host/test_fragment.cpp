@@ -0,0 +1,388 @@
+/*
+ * Host test for the fragmentation of LoRaWAN messages.
+ * The test replaces the settings getters and the uplink queue of the driver with a recorder and checks the fragments of
+ * "RAK3172_LoRaWAN_TransmitFragmented" for the current data rate, ADR and the fragment count limit. The reassembly is
+ * checked with fragments in order, reordered and repeated fragments, a last fragment which is received first and parked
+ * at the end of the buffer, lost fragments and a buffer which is too small. A report lists the goodput for each data rate.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "rak3172_test.h"
+
+/** @brief Length of the message of the goodput report in bytes.
+ */
+#define TEST_REPORT_LENGTH                      1000
+
+/** @brief Number of random messages of the reassembly test.
+ */
+#define TEST_ROUNDS                             2000
+
+/** @brief Settings of the simulated module and the queued fragments.
+ */
+typedef struct
+{
+    RAK3172_Band_t Band;
+    RAK3172_DataRate_t DR;
+    bool isADR;
+    std::vector<std::vector<uint8_t>> Fragments;
+} Test_Module_t;
+
+static Test_Module_t _Test_Module;
+
+RAK3172_Error_t RAK3172_LoRaWAN_GetBand(RAK3172_t& p_Device, RAK3172_Band_t* const p_Band, bool Refresh)
+{
+    *p_Band = _Test_Module.Band;
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_GetUplinkDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR)
+{
+    *p_DR = _Test_Module.isADR ? RAK_DR_0 : _Test_Module.DR;
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Submit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, bool Confirmed, uint8_t Retries,
+                                       RAK3172_Uplink_Callback_t on_Done, void* p_Arg, RAK3172_Ticket_t* const p_Ticket, uint32_t Timeout)
+{
+    const uint8_t* Data = static_cast<const uint8_t*>(p_Buffer);
+
+    _Test_Module.Fragments.push_back(std::vector<uint8_t>(Data, Data + Length));
+
+    return RAK3172_ERR_OK;
+}
+
+/** @brief          Set the settings of the simulated module and clear the queued fragments.
+ *  @param Band     Frequency band
+ *  @param DR       Current data rate
+ *  @param isADR    ADR status
+ */
+static void Test_Module_Reset(RAK3172_Band_t Band, RAK3172_DataRate_t DR, bool isADR)
+{
+    _Test_Module.Band = Band;
+    _Test_Module.DR = DR;
+    _Test_Module.isADR = isADR;
+    _Test_Module.Fragments.clear();
+}
+
+/** @brief          Check that the queued fragments contain the message.
+ *  @param Message  Transmitted message
+ *  @param Payload  Expected payload size of all fragments except the last one
+ */
+static void Test_CheckFragments(const std::vector<uint8_t>& Message, size_t Payload)
+{
+    size_t Count = _Test_Module.Fragments.size();
+    std::vector<uint8_t> Data;
+
+    RAK3172_TEST_EQUAL((Message.size() + Payload - 1) / Payload, Count);
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        const std::vector<uint8_t>& Fragment = _Test_Module.Fragments[i];
+
+        RAK3172_TEST_EQUAL(_Test_Module.Fragments[0][0], Fragment[0]);
+        RAK3172_TEST_EQUAL(i, Fragment[1]);
+        RAK3172_TEST_EQUAL(Count, Fragment[2]);
+
+        if((i + 1) < Count)
+        {
+            RAK3172_TEST_EQUAL(Payload + RAK3172_FRAGMENT_HEADER_SIZE, Fragment.size());
+        }
+
+        Data.insert(Data.end(), Fragment.begin() + RAK3172_FRAGMENT_HEADER_SIZE, Fragment.end());
+    }
+
+    RAK3172_TEST_ASSERT(Data == Message);
+}
+
+/** @brief Check the fragment size with and without ADR and the fragment count limit.
+ */
+static void Test_Transmit(RAK3172_t& p_Device)
+{
+    std::vector<uint8_t> Message(1000);
+
+    for(size_t i = 0; i < Message.size(); i++)
+    {
+        Message[i] = static_cast<uint8_t>((i * 151) + 7);
+    }
+
+    // The fragments use the current data rate without ADR.
+    Test_Module_Reset(RAK_BAND_EU868, RAK_DR_5, false);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), Message.size()));
+    Test_CheckFragments(Message, 222 - RAK3172_FRAGMENT_HEADER_SIZE);
+
+    // The ADR can lower the data rate. So the fragments must fit into DR0.
+    Test_Module_Reset(RAK_BAND_EU868, RAK_DR_5, true);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), Message.size()));
+    Test_CheckFragments(Message, 51 - RAK3172_FRAGMENT_HEADER_SIZE);
+
+    // Each message gets a new ID.
+    RAK3172_TEST_ASSERT(_Test_Module.Fragments[0][0] != 0);
+
+    // US915 DR0 carries 8 bytes per fragment. So 2040 bytes is the longest message.
+    Message.resize(255 * 8);
+    Test_Module_Reset(RAK_BAND_US915, RAK_DR_0, false);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), Message.size()));
+    Test_CheckFragments(Message, 8);
+
+    Message.resize(Message.size() + 1);
+    Test_Module_Reset(RAK_BAND_US915, RAK_DR_0, false);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), Message.size()));
+    RAK3172_TEST_EQUAL(0, _Test_Module.Fragments.size());
+
+    // 65536 fragments must not wrap to 0 fragments.
+    Message.resize(65536 * 8);
+    Test_Module_Reset(RAK_BAND_US915, RAK_DR_0, false);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), Message.size()));
+    RAK3172_TEST_EQUAL(0, _Test_Module.Fragments.size());
+
+    // Data rates which aren´t defined for the band.
+    Test_Module_Reset(RAK_BAND_US915, RAK_DR_5, false);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), 10));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), 0));
+}
+
+/** @brief          Build the fragments of a message.
+ *  @param ID       Message ID
+ *  @param Message  Message
+ *  @param Payload  Payload size of all fragments except the last one
+ *  @return         Fragments with header
+ */
+static std::vector<std::vector<uint8_t>> Test_Split(uint8_t ID, const std::vector<uint8_t>& Message, size_t Payload)
+{
+    std::vector<std::vector<uint8_t>> Fragments;
+    size_t Count = (Message.size() + Payload - 1) / Payload;
+
+    for(size_t i = 0; i < Count; i++)
+    {
+        size_t Size = std::min(Payload, Message.size() - (i * Payload));
+        std::vector<uint8_t> Fragment = {ID, static_cast<uint8_t>(i), static_cast<uint8_t>(Count)};
+
+        Fragment.insert(Fragment.end(), Message.begin() + (i * Payload), Message.begin() + (i * Payload) + Size);
+        Fragments.push_back(Fragment);
+    }
+
+    return Fragments;
+}
+
+/** @brief Check the reassembly with special fragment orders.
+ */
+static void Test_Reassemble(void)
+{
+    RAK3172_Reassembly_t Context;
+    std::vector<uint8_t> Message(100);
+    std::vector<uint8_t> Buffer(256);
+    std::vector<std::vector<uint8_t>> Fragments;
+    bool isComplete;
+
+    for(size_t i = 0; i < Message.size(); i++)
+    {
+        Message[i] = static_cast<uint8_t>(i + 1);
+    }
+
+    // 100 bytes in fragments with 30 bytes. The last fragment has 10 bytes.
+    Fragments = Test_Split(1, Message, 30);
+
+    // The last fragment is received first. It´s parked at the end of the buffer and moved when the fragment size is known.
+    RAK3172_LoRaWAN_Reassembly_Init(&Context, Buffer.data(), Buffer.size());
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[3].data(), Fragments[3].size(), &isComplete));
+    RAK3172_TEST_ASSERT(isComplete == false);
+    RAK3172_TEST_EQUAL(0, memcmp(&Buffer[Buffer.size() - 10], &Message[90], 10));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[1].data(), Fragments[1].size(), &isComplete));
+    RAK3172_TEST_EQUAL(0, memcmp(&Buffer[90], &Message[90], 10));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[2].data(), Fragments[2].size(), &isComplete));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[0].data(), Fragments[0].size(), &isComplete));
+    RAK3172_TEST_ASSERT(isComplete);
+    RAK3172_TEST_EQUAL(Message.size(), Context.Length);
+    RAK3172_TEST_EQUAL(0, memcmp(Buffer.data(), Message.data(), Message.size()));
+
+    // The parked fragment overlaps with its final position when the buffer has the size of the message.
+    Buffer.assign(Message.size(), 0);
+    RAK3172_LoRaWAN_Reassembly_Init(&Context, Buffer.data(), Buffer.size());
+    for(size_t i : {3, 0, 2, 1})
+    {
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[i].data(), Fragments[i].size(), &isComplete));
+    }
+    RAK3172_TEST_ASSERT(isComplete);
+    RAK3172_TEST_ASSERT(Buffer == Message);
+
+    // Repeated fragments of the complete message are ignored.
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[2].data(), Fragments[2].size(), &isComplete));
+    RAK3172_TEST_ASSERT(isComplete == false);
+    RAK3172_TEST_EQUAL(0, Context.Dropped);
+
+    // A lost fragment keeps the message incomplete until the next message replaces it.
+    Buffer.assign(256, 0);
+    RAK3172_LoRaWAN_Reassembly_Init(&Context, Buffer.data(), Buffer.size());
+    for(size_t i : {0, 1, 3})
+    {
+        RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[i].data(), Fragments[i].size(), &isComplete));
+        RAK3172_TEST_ASSERT(isComplete == false);
+    }
+    Fragments = Test_Split(2, Message, 60);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[1].data(), Fragments[1].size(), &isComplete));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[0].data(), Fragments[0].size(), &isComplete));
+    RAK3172_TEST_ASSERT(isComplete);
+    RAK3172_TEST_EQUAL(1, Context.Dropped);
+    RAK3172_TEST_EQUAL(0, memcmp(Buffer.data(), Message.data(), Message.size()));
+
+    // A last fragment which is larger than the other fragments doesn´t belong to the message.
+    RAK3172_LoRaWAN_Reassembly_Init(&Context, Buffer.data(), Buffer.size());
+    Fragments = Test_Split(3, Message, 60);
+    Fragments[0].resize(30 + RAK3172_FRAGMENT_HEADER_SIZE);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[1].data(), Fragments[1].size(), &isComplete));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_RESPONSE, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[0].data(), Fragments[0].size(), &isComplete));
+
+    // The message doesn´t fit into the buffer.
+    Buffer.assign(Message.size() - 1, 0);
+    RAK3172_LoRaWAN_Reassembly_Init(&Context, Buffer.data(), Buffer.size());
+    Fragments = Test_Split(4, Message, 30);
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[3].data(), Fragments[3].size(), &isComplete));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_NO_MEM, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[0].data(), Fragments[0].size(), &isComplete));
+    RAK3172_TEST_EQUAL(1, Context.Dropped);
+
+    // Invalid headers.
+    Fragments[0][1] = 4;
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_RESPONSE, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[0].data(), Fragments[0].size(), &isComplete));
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_LoRaWAN_Reassemble(&Context, Fragments[0].data(), RAK3172_FRAGMENT_HEADER_SIZE, &isComplete));
+}
+
+/** @brief Reassemble random messages with reordered, repeated and lost fragments.
+ */
+static void Test_Random(void)
+{
+    std::mt19937 Random(1);
+    RAK3172_Reassembly_t Context;
+    uint32_t Complete = 0;
+    uint32_t Lost = 0;
+
+    for(int Round = 0; Round < TEST_ROUNDS; Round++)
+    {
+        std::vector<uint8_t> Message(1 + (Random() % 3000));
+        size_t Payload = 8 + (Random() % 240);
+        std::vector<std::vector<uint8_t>> Fragments;
+        std::vector<std::vector<uint8_t>> Received;
+        std::vector<uint8_t> Buffer;
+        bool isLost;
+        bool isComplete = false;
+
+        if(((Message.size() + Payload - 1) / Payload) > RAK3172_FRAGMENT_MAX_COUNT)
+        {
+            continue;
+        }
+
+        for(uint8_t& Byte : Message)
+        {
+            Byte = static_cast<uint8_t>(Random());
+        }
+
+        // The buffer can have the size of the message or can be larger.
+        Buffer.resize(Message.size() + (((Random() % 2) == 0) ? 0 : 50));
+        RAK3172_LoRaWAN_Reassembly_Init(&Context, Buffer.data(), Buffer.size());
+
+        Fragments = Test_Split(static_cast<uint8_t>(Round), Message, Payload);
+        Received = Fragments;
+        for(int i = 0; i < 3; i++)
+        {
+            Received.push_back(Fragments[Random() % Fragments.size()]);
+        }
+        std::shuffle(Received.begin(), Received.end(), Random);
+
+        // Lose one fragment in every fourth message.
+        isLost = ((Round % 4) == 0) && (Fragments.size() > 1);
+        if(isLost)
+        {
+            std::vector<uint8_t> Fragment = Fragments[Random() % Fragments.size()];
+
+            Received.erase(std::remove(Received.begin(), Received.end(), Fragment), Received.end());
+        }
+
+        for(const std::vector<uint8_t>& Fragment : Received)
+        {
+            RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_Reassemble(&Context, Fragment.data(), Fragment.size(), &isComplete));
+
+            if(isComplete)
+            {
+                Complete++;
+                RAK3172_TEST_ASSERT(isLost == false);
+                RAK3172_TEST_EQUAL(Message.size(), Context.Length);
+                RAK3172_TEST_EQUAL(0, memcmp(Buffer.data(), Message.data(), Message.size()));
+            }
+        }
+
+        if(isLost)
+        {
+            Lost++;
+            RAK3172_TEST_ASSERT(Context.Count != 0);
+        }
+    }
+
+    printf("Random messages: %u complete, %u with lost fragments\n", static_cast<unsigned int>(Complete), static_cast<unsigned int>(Lost));
+    RAK3172_TEST_ASSERT(Complete > (TEST_ROUNDS / 2));
+}
+
+/** @brief Report the airtime and the goodput of a message for each data rate.
+ */
+static void Test_Goodput(RAK3172_t& p_Device)
+{
+    std::vector<uint8_t> Message(TEST_REPORT_LENGTH);
+
+    printf("Message with %u bytes:\n", TEST_REPORT_LENGTH);
+    printf("    %-8s %-4s %-10s %-11s %-13s %-16s %-15s\n", "Band", "DR", "Fragment", "Fragments", "Airtime [ms]", "Goodput [bit/s]", "Off time 1% [s]");
+
+    for(RAK3172_Band_t Band : {RAK_BAND_EU868, RAK_BAND_US915})
+    {
+        uint32_t Last = 0;
+
+        for(int DR = RAK_DR_0; DR <= RAK_DR_7; DR++)
+        {
+            uint32_t Airtime = 0;
+            uint32_t Goodput;
+
+            if(RAK3172_LoRaWAN_GetMaxPayload(Band, static_cast<RAK3172_DataRate_t>(DR)) == 0)
+            {
+                continue;
+            }
+
+            Test_Module_Reset(Band, static_cast<RAK3172_DataRate_t>(DR), false);
+            RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LoRaWAN_TransmitFragmented(p_Device, 1, Message.data(), Message.size()));
+
+            for(const std::vector<uint8_t>& Fragment : _Test_Module.Fragments)
+            {
+                Airtime += RAK3172_LoRaWAN_GetTimeOnAir(Band, static_cast<RAK3172_DataRate_t>(DR), Fragment.size() + RAK3172_LORAWAN_FRAME_OVERHEAD);
+            }
+
+            Goodput = (Message.size() * 8000UL) / Airtime;
+
+            printf("    %-8s %-4d %-10u %-11u %-13u %-16u %.1f\n", (Band == RAK_BAND_EU868) ? "EU868" : "US915", DR,
+                   static_cast<unsigned int>(_Test_Module.Fragments[0].size()), static_cast<unsigned int>(_Test_Module.Fragments.size()), Airtime, Goodput,
+                   Airtime * 99 / 1000.0);
+
+            // Faster data rates carry more payload per fragment and need less airtime for it.
+            RAK3172_TEST_ASSERT(Goodput > Last);
+            Last = Goodput;
+        }
+    }
+}
+
+int main(void)
+{
+    RAK3172_t Device = {};
+
+    Device.Mode = RAK_MODE_LORAWAN;
+
+    Test_Transmit(Device);
+    Test_Reassemble();
+    Test_Random();
+    Test_Goodput(Device);
+
+    return RAK3172_Test_Result();
+}
@@ -0,0 +1,209 @@
+/*
+ * Host test and benchmark for the hex codec.
+ * The test compares the encoder with "printf" for all byte values and checks the decoder with valid and invalid input.
+ * The benchmark measures the cycles per byte of the encoder, the nibble encoder before the byte pair table and the
+ * transmit path before the codec, which has formatted each byte with "sprintf" and appended it to a string.
+ * NOTE: The cycles are measured with the time stamp counter of x86 hosts. Other hosts report nanoseconds instead.
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+#if(defined __x86_64__) || (defined __i386__)
+    #include <x86intrin.h>
+#endif
+
+#include "Codec/rak3172_hex.h"
+
+#include "rak3172_host_heap.h"
+#include "rak3172_test.h"
+
+/** @brief Number of encoded bytes for each payload size of the benchmark.
+ */
+#define TEST_BYTES                              (16UL * 1024UL * 1024UL)
+
+/** @brief Lookup table of the nibble encoder before the byte pair table.
+ */
+static const char _Test_Hex_Char[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+/** @brief          Nibble encoder before the byte pair table.
+ *  @param p_Data   Pointer to binary data
+ *  @param Length   Length of the binary data
+ *  @param p_Hex    Pointer to output buffer
+ */
+static void __attribute__((noinline)) Test_NibbleEncode(const uint8_t* p_Data, size_t Length, char* p_Hex)
+{
+    for(size_t i = 0; i < Length; i++)
+    {
+        *p_Hex++ = _Test_Hex_Char[p_Data[i] >> 4];
+        *p_Hex++ = _Test_Hex_Char[p_Data[i] & 0x0F];
+    }
+}
+
+/** @brief          Payload encoding of "RAK3172_LoRaWAN_Transmit" before the codec.
+ *  @param p_Data   Pointer to binary data
+ *  @param Length   Length of the binary data
+ *  @return         Hex string
+ */
+static std::string __attribute__((noinline)) Test_SprintfEncode(const uint8_t* p_Data, size_t Length)
+{
+    std::string Payload;
+    char Buffer[3];
+
+    for(size_t i = 0; i < Length; i++)
+    {
+        sprintf(Buffer, "%02x", p_Data[i]);
+        Payload += std::string(Buffer);
+    }
+
+    return Payload;
+}
+
+/** @brief  Get the time stamp for the benchmark.
+ *  @return CPU cycles on x86 hosts, nanoseconds otherwise
+ */
+static inline uint64_t Test_Timestamp(void)
+{
+    #if(defined __x86_64__) || (defined __i386__)
+        return __rdtsc();
+    #else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+/** @brief Compare the encoder with "printf" for all byte values and all tail lengths of the unrolled loop.
+ */
+static void Test_Encode(void)
+{
+    uint8_t Data[256];
+    char Hex[512];
+    char Expected[3];
+
+    for(size_t i = 0; i < sizeof(Data); i++)
+    {
+        Data[i] = static_cast<uint8_t>(i);
+    }
+
+    RAK3172_Hex_Encode(Data, sizeof(Data), Hex);
+    for(size_t i = 0; i < sizeof(Data); i++)
+    {
+        snprintf(Expected, sizeof(Expected), "%02X", static_cast<unsigned int>(i));
+        RAK3172_TEST_ASSERT(memcmp(&Hex[i * 2], Expected, 2) == 0);
+    }
+
+    // The encoder must not write behind the encoded data.
+    for(size_t Length = 0; Length <= 9; Length++)
+    {
+        memset(Hex, '#', sizeof(Hex));
+        RAK3172_Hex_Encode(&Data[0xF0], Length, Hex);
+
+        for(size_t i = 0; i < Length; i++)
+        {
+            snprintf(Expected, sizeof(Expected), "%02X", static_cast<unsigned int>(0xF0 + i));
+            RAK3172_TEST_ASSERT(memcmp(&Hex[i * 2], Expected, 2) == 0);
+        }
+        RAK3172_TEST_EQUAL('#', Hex[Length * 2]);
+    }
+}
+
+/** @brief Check the decoder with a round trip, lower case characters and invalid input.
+ */
+static void Test_Decode(void)
+{
+    uint8_t Data[256];
+    uint8_t Buffer[256];
+    char Hex[512];
+
+    for(size_t i = 0; i < sizeof(Data); i++)
+    {
+        Data[i] = static_cast<uint8_t>(255 - i);
+    }
+
+    RAK3172_Hex_Encode(Data, sizeof(Data), Hex);
+    RAK3172_TEST_EQUAL(sizeof(Data), RAK3172_Hex_Decode(Hex, sizeof(Hex), Buffer, sizeof(Buffer)));
+    RAK3172_TEST_ASSERT(memcmp(Data, Buffer, sizeof(Data)) == 0);
+
+    RAK3172_TEST_EQUAL(3, RAK3172_Hex_Decode("aBcDeF", 6, Buffer, sizeof(Buffer)));
+    RAK3172_TEST_EQUAL(0xAB, Buffer[0]);
+    RAK3172_TEST_EQUAL(0xCD, Buffer[1]);
+    RAK3172_TEST_EQUAL(0xEF, Buffer[2]);
+
+    // The decoding stops at the first invalid character, an incomplete byte or a full buffer.
+    RAK3172_TEST_EQUAL(1, RAK3172_Hex_Decode("01G2", 4, Buffer, sizeof(Buffer)));
+    RAK3172_TEST_EQUAL(1, RAK3172_Hex_Decode("01:2", 4, Buffer, sizeof(Buffer)));
+    RAK3172_TEST_EQUAL(2, RAK3172_Hex_Decode("01020", 5, Buffer, sizeof(Buffer)));
+    RAK3172_TEST_EQUAL(2, RAK3172_Hex_Decode("010203", 6, Buffer, 2));
+    RAK3172_TEST_EQUAL(0, RAK3172_Hex_Decode(NULL, 6, Buffer, sizeof(Buffer)));
+}
+
+int main(void)
+{
+    std::vector<uint8_t> Data(242);
+    std::vector<char> Hex(2 * Data.size());
+    size_t Checksum = 0;
+
+    Test_Encode();
+    Test_Decode();
+
+    for(size_t i = 0; i < Data.size(); i++)
+    {
+        Data[i] = static_cast<uint8_t>((i * 151) + 7);
+    }
+
+    #if(defined __x86_64__) || (defined __i386__)
+        printf("Payload   Byte pair table         Nibble table            sprintf + string\n");
+        printf("[bytes]   [cycles / byte]         [cycles / byte]         [cycles / byte]   [heap calls]\n");
+    #else
+        printf("Payload   Byte pair table         Nibble table            sprintf + string\n");
+        printf("[bytes]   [ns / byte]             [ns / byte]             [ns / byte]       [heap calls]\n");
+    #endif
+
+    // Maximum payload of US915 DR0, of EU868 DR0 and of the fastest data rates.
+    for(size_t Length : {11UL, 51UL, 242UL})
+    {
+        size_t Rounds = TEST_BYTES / Length;
+        size_t Allocations;
+        uint64_t Start;
+        double Pair;
+        double Nibble;
+        double Sprintf;
+
+        Start = Test_Timestamp();
+        for(size_t i = 0; i < Rounds; i++)
+        {
+            RAK3172_Hex_Encode(Data.data(), Length, Hex.data());
+            Checksum += static_cast<uint8_t>(Hex[i % (2 * Length)]);
+        }
+        Pair = static_cast<double>(Test_Timestamp() - Start) / (Rounds * Length);
+
+        Start = Test_Timestamp();
+        for(size_t i = 0; i < Rounds; i++)
+        {
+            Test_NibbleEncode(Data.data(), Length, Hex.data());
+            Checksum += static_cast<uint8_t>(Hex[i % (2 * Length)]);
+        }
+        Nibble = static_cast<double>(Test_Timestamp() - Start) / (Rounds * Length);
+
+        // The old path is much slower. Use less rounds.
+        Rounds /= 16;
+        Allocations = RAK3172_Host_GetAllocations();
+        Start = Test_Timestamp();
+        for(size_t i = 0; i < Rounds; i++)
+        {
+            Checksum += Test_SprintfEncode(Data.data(), Length).length();
+        }
+        Sprintf = static_cast<double>(Test_Timestamp() - Start) / (Rounds * Length);
+        Allocations = RAK3172_Host_GetAllocations() - Allocations;
+
+        printf("%-9u %-23.2f %-23.2f %-17.2f %.1f\n", static_cast<unsigned int>(Length), Pair, Nibble, Sprintf, static_cast<double>(Allocations) / Rounds);
+
+        RAK3172_TEST_ASSERT(Pair < Sprintf);
+    }
+
+    printf("Checksum: %u\n", static_cast<unsigned int>(Checksum));
+
+    return RAK3172_Test_Result();
+}
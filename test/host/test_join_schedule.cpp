@@ -0,0 +1,267 @@
+/*
+ * Host test for the join scheduler.
+ * The test checks the off time of "RAK3172_LoRaWAN_GetJoinDelay" for the three phases of the aggregated join duty cycle and
+ * the random jitter. A fleet simulation replays the schedule of "RAK3172_LoRaWAN_JoinScheduled" for a fleet of devices which
+ * starts to join at the same time (i. e. after a gateway outage) and reports the join time with different jitter settings.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <esp_random.h>
+
+#include "rak3172.h"
+
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+/** @brief Number of devices of the fleet simulation.
+ */
+#define TEST_FLEET_SIZE                         100
+
+/** @brief Number of join channels of the EU868 band.
+ */
+#define TEST_FLEET_CHANNELS                     3
+
+/** @brief Maximum number of join attempts of a device.
+ */
+#define TEST_FLEET_ATTEMPTS                     24
+
+/** @brief Duration of a failed join attempt in milliseconds (join accept window 2 after 6 seconds).
+ */
+#define TEST_FLEET_ATTEMPT_DURATION             7000
+
+/** @brief Length of the PHY payload of a join request in bytes.
+ */
+#define TEST_JOIN_REQUEST_LENGTH                23
+
+/** @brief Join request of the fleet simulation.
+ */
+typedef struct
+{
+    size_t Device;
+    unsigned long Start;
+    uint32_t Airtime;
+    uint8_t Channel;
+    RAK3172_DataRate_t DR;
+} Test_Request_t;
+
+/** @brief State of a simulated device.
+ */
+typedef struct
+{
+    bool isJoined;
+    uint8_t Attempt;
+    RAK3172_DataRate_t DR;
+    unsigned long Next;
+    unsigned long JoinTime;
+    uint32_t Airtime;
+} Test_Device_t;
+
+/** @brief Result of a fleet simulation.
+ */
+typedef struct
+{
+    size_t Joined;
+    unsigned long Median;
+    unsigned long Max;
+    uint32_t Requests;
+    bool isDutyCycleValid;
+} Test_Fleet_t;
+
+/** @brief Check the off time of each duty cycle phase without jitter.
+ */
+static void Test_OffTime(void)
+{
+    RAK3172_TEST_EQUAL(9900, RAK3172_LoRaWAN_GetJoinDelay(100, 0, 0, 0));
+    RAK3172_TEST_EQUAL(9900, RAK3172_LoRaWAN_GetJoinDelay(100, 3599999UL, 0, 0));
+    RAK3172_TEST_EQUAL(99900, RAK3172_LoRaWAN_GetJoinDelay(100, 3600000UL, 0, 0));
+    RAK3172_TEST_EQUAL(99900, RAK3172_LoRaWAN_GetJoinDelay(100, 39599999UL, 0, 0));
+    RAK3172_TEST_EQUAL(999900, RAK3172_LoRaWAN_GetJoinDelay(100, 39600000UL, 0, 0));
+
+    // The duration of the attempt is part of the off time.
+    RAK3172_TEST_EQUAL(2900, RAK3172_LoRaWAN_GetJoinDelay(100, 0, 7000, 0));
+    RAK3172_TEST_EQUAL(0, RAK3172_LoRaWAN_GetJoinDelay(50, 0, 7000, 0));
+
+    // SF12 join request in EU868.
+    RAK3172_TEST_EQUAL(1483UL * 99, RAK3172_LoRaWAN_GetJoinDelay(RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, RAK_DR_0, TEST_JOIN_REQUEST_LENGTH), 0, 0, 0));
+}
+
+/** @brief Check that the jitter stays in its range and desynchronizes the attempts.
+ */
+static void Test_Jitter(void)
+{
+    uint32_t Min = UINT32_MAX;
+    uint32_t Max = 0;
+
+    RAK3172_Host_Reset(1);
+
+    for(int i = 0; i < 10000; i++)
+    {
+        uint32_t Delay = RAK3172_LoRaWAN_GetJoinDelay(100, 0, 7000, 1000);
+
+        Min = std::min(Min, Delay);
+        Max = std::max(Max, Delay);
+    }
+
+    RAK3172_TEST_ASSERT(Min >= 2900);
+    RAK3172_TEST_ASSERT(Max < 3900);
+    RAK3172_TEST_ASSERT((Max - Min) > 900);
+
+    // The jitter is also added when the attempt was longer than the off time.
+    RAK3172_TEST_ASSERT(RAK3172_LoRaWAN_GetJoinDelay(10, 0, 7000, 1000) < 1000);
+}
+
+/** @brief          Simulate a fleet which uses the join schedule of "RAK3172_LoRaWAN_JoinScheduled" with the EU868 band.
+ *                  Requests with the same channel and spreading factor which overlap in time are lost. The capture effect and
+ *                  the downlink capacity of the gateway are not simulated.
+ *  @param Jitter   Maximum random delay of the schedule in milliseconds
+ *  @return         Simulation result
+ */
+static Test_Fleet_t Test_Fleet(uint32_t Jitter)
+{
+    std::vector<Test_Device_t> Devices(TEST_FLEET_SIZE);
+    std::vector<Test_Request_t> History;
+    std::vector<unsigned long> JoinTimes;
+    Test_Fleet_t Result = {0, 0, 0, 0, true};
+
+    RAK3172_Host_Reset(42);
+
+    for(Test_Device_t& Device : Devices)
+    {
+        Device.isJoined = false;
+        Device.Attempt = 0;
+        Device.DR = RAK_DR_5;
+        Device.Next = RAK3172_LoRaWAN_GetJoinDelay(0, 0, 0, Jitter);
+        Device.Airtime = 0;
+    }
+
+    while(true)
+    {
+        Test_Request_t Request;
+        size_t Index = TEST_FLEET_SIZE;
+        bool isLost = false;
+
+        // Transmit the next pending join request. All other requests which can overlap with it are pending or in the history,
+        // because the next attempt of a device starts after the receive windows of its last attempt.
+        for(size_t i = 0; i < TEST_FLEET_SIZE; i++)
+        {
+            if((Devices[i].isJoined == false) && (Devices[i].Attempt < TEST_FLEET_ATTEMPTS) && ((Index == TEST_FLEET_SIZE) || (Devices[i].Next < Devices[Index].Next)))
+            {
+                Index = i;
+            }
+        }
+
+        if(Index == TEST_FLEET_SIZE)
+        {
+            break;
+        }
+
+        Test_Device_t& Device = Devices[Index];
+
+        // Use the more robust data rate after each block of two attempts.
+        if((Device.Attempt > 0) && ((Device.Attempt % 2) == 0) && (Device.DR > RAK_DR_0))
+        {
+            Device.DR = static_cast<RAK3172_DataRate_t>(Device.DR - 1);
+        }
+
+        Request.Device = Index;
+        Request.Start = Device.Next;
+        Request.DR = Device.DR;
+        Request.Airtime = RAK3172_LoRaWAN_GetTimeOnAir(RAK_BAND_EU868, Device.DR, TEST_JOIN_REQUEST_LENGTH);
+        Request.Channel = esp_random() % TEST_FLEET_CHANNELS;
+        History.push_back(Request);
+        Result.Requests++;
+
+        Device.Attempt++;
+        if(Request.Start < 3600000UL)
+        {
+            Device.Airtime += Request.Airtime;
+            Result.isDutyCycleValid &= (Device.Airtime <= 36000);
+        }
+
+        // The channel of a request is drawn when it is transmitted. So a collision is detected with the later request and
+        // the earlier request is lost too.
+        for(size_t i = 0; (i + 1) < History.size(); i++)
+        {
+            const Test_Request_t& Other = History[i];
+
+            if((Other.Channel == Request.Channel) && (Other.DR == Request.DR) && (Other.Start < (Request.Start + Request.Airtime)) && (Request.Start < (Other.Start + Other.Airtime)))
+            {
+                isLost = true;
+
+                // The other device has joined with this request in the simulation already. Revoke the join.
+                if(Devices[Other.Device].isJoined)
+                {
+                    Devices[Other.Device].isJoined = false;
+                    Devices[Other.Device].Next = Other.Start + TEST_FLEET_ATTEMPT_DURATION + RAK3172_LoRaWAN_GetJoinDelay(Other.Airtime, Other.Start, TEST_FLEET_ATTEMPT_DURATION, Jitter);
+                }
+            }
+        }
+
+        if(isLost == false)
+        {
+            Device.isJoined = true;
+            Device.JoinTime = Request.Start + Request.Airtime;
+        }
+        else
+        {
+            Device.Next = Request.Start + TEST_FLEET_ATTEMPT_DURATION + RAK3172_LoRaWAN_GetJoinDelay(Request.Airtime, Request.Start, TEST_FLEET_ATTEMPT_DURATION, Jitter);
+        }
+    }
+
+    for(const Test_Device_t& Device : Devices)
+    {
+        if(Device.isJoined)
+        {
+            JoinTimes.push_back(Device.JoinTime);
+        }
+    }
+
+    Result.Joined = JoinTimes.size();
+    if(JoinTimes.size() > 0)
+    {
+        std::sort(JoinTimes.begin(), JoinTimes.end());
+        Result.Median = JoinTimes[JoinTimes.size() / 2];
+        Result.Max = JoinTimes.back();
+    }
+
+    return Result;
+}
+
+int main(void)
+{
+    Test_Fleet_t NoJitter = {};
+    Test_Fleet_t Jitter = {};
+
+    Test_OffTime();
+    Test_Jitter();
+
+    printf("Fleet of %u devices, EU868, DR5 to DR0, 2 attempts per data rate, %u attempts:\n", TEST_FLEET_SIZE, TEST_FLEET_ATTEMPTS);
+    printf("    %-12s %-8s %-12s %-12s %-10s\n", "Jitter [ms]", "Joined", "Median [s]", "Max [s]", "Requests");
+
+    for(uint32_t Value : {0U, 5000U, 30000U, 120000U})
+    {
+        Test_Fleet_t Result = Test_Fleet(Value);
+
+        printf("    %-12u %-8u %-12.1f %-12.1f %-10u\n", Value, static_cast<unsigned int>(Result.Joined), Result.Median / 1000.0, Result.Max / 1000.0,
+               Result.Requests);
+
+        RAK3172_TEST_ASSERT(Result.isDutyCycleValid);
+
+        if(Value == 0)
+        {
+            NoJitter = Result;
+        }
+        else if(Value == 30000)
+        {
+            Jitter = Result;
+        }
+    }
+
+    // Devices without jitter repeat their collisions, because all devices use the same off time.
+    RAK3172_TEST_EQUAL(TEST_FLEET_SIZE, Jitter.Joined);
+    RAK3172_TEST_ASSERT(Jitter.Requests < NoJitter.Requests);
+
+    return RAK3172_Test_Result();
+}
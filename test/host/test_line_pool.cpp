@@ -0,0 +1,208 @@
+/*
+ * Host test for the receive path of the driver: line pool, event parser and payload decoder.
+ * The test feeds received lines through the same steps as "RAK3172_UART_EventTask" and the command functions and
+ * checks that no heap allocation happens once the pool is initialized. The old receive path with a heap allocated
+ * string per line is measured for comparison.
+ */
+
+#include <chrono>
+#include <string>
+#include <string.h>
+
+#include "rak3172_defs.h"
+
+#include "Buffer/rak3172_line_pool.h"
+#include "Codec/rak3172_hex.h"
+#include "Parser/rak3172_event_parser.h"
+
+#include "rak3172_host.h"
+#include "rak3172_host_heap.h"
+#include "rak3172_test.h"
+
+/** @brief Number of passes through the line list for the measurement.
+ */
+#define TEST_PASSES                             20000
+
+/** @brief Lines as they are received by the event task (responses, events and downlinks).
+ */
+static const char* _Test_Lines[] = {
+    "OK\r\n",
+    "AT+DEVEUI=AC1F09FFFE0A1B2C\r\n",
+    "RUI_4.0.5_RAK3172-E\r\n",
+    "AT_BUSY_ERROR\r\n",
+    "+EVT:JOINED\r\n",
+    "+EVT:SEND_CONFIRMED_OK\r\n",
+    "+EVT:RX_1:-72:9:UNICAST:2:0102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F20\r\n",
+    "+EVT:RXP2P:-41:11:48656C6C6F20576F726C64\r\n",
+    "AT+BAND=4\r\n",
+};
+
+/** @brief          Pass a line through the new receive path.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Parser Pointer to event parser object
+ *  @param p_Data   Pointer to received data
+ *  @param Length   Length of the received data
+ *  @return         Number of processed payload bytes
+ */
+static size_t Test_Pool_Receive(RAK3172_t& p_Device, RAK3172_EventParser_t* p_Parser, const uint8_t* p_Data, size_t Length)
+{
+    RAK3172_Event_t Event;
+    RAK3172_Line_t* Line;
+    RAK3172_Rx_t Received;
+    size_t Processed = 0;
+
+    // Event task: decode events directly from the receive buffer.
+    if(RAK3172_EventParser_Parse(p_Parser, p_Data, Length, &Event) != RAK_EVENT_NONE)
+    {
+        if((Event.Type == RAK_EVENT_RX) || (Event.Type == RAK_EVENT_RX_P2P))
+        {
+            Received.Length = RAK3172_Hex_Decode(Event.p_Payload, Event.PayloadLength, Received.Payload, sizeof(Received.Payload));
+            xQueueSend(p_Device.Internal.ReceiveQueue, &Received, 0);
+        }
+
+        return 0;
+    }
+
+    // Event task: copy the line into a pool slot.
+    Line = RAK3172_LinePool_Take(p_Device);
+    if(Line == NULL)
+    {
+        return 0;
+    }
+
+    Line->Length = 0;
+    for(size_t i = 0; (i < Length) && (Line->Length < CONFIG_RAK3172_UART_LINE_LENGTH); i++)
+    {
+        if((p_Data[i] != '\n') && (p_Data[i] != '\r'))
+        {
+            Line->Data[Line->Length++] = p_Data[i];
+        }
+    }
+    Line->Data[Line->Length] = '\0';
+
+    RAK3172_LinePool_Push(p_Device, Line);
+
+    // Command function: consume the line and return the slot.
+    Line = RAK3172_LinePool_Receive(p_Device, 0);
+    if(Line != NULL)
+    {
+        Processed = Line->Length;
+        RAK3172_LinePool_Release(p_Device, Line);
+    }
+
+    return Processed;
+}
+
+/** @brief          Pass a line through the receive path of the driver before the line pool was introduced.
+ *                  Each line was copied into a new string and the pointer was passed through the message queue.
+ *  @param Queue    Message queue for string pointers
+ *  @param p_Data   Pointer to received data
+ *  @param Length   Length of the received data
+ *  @return         Number of processed payload bytes
+ */
+static size_t Test_String_Receive(QueueHandle_t Queue, const uint8_t* p_Data, size_t Length)
+{
+    std::string* Line;
+    size_t Processed = 0;
+
+    Line = new std::string(reinterpret_cast<const char*>(p_Data), Length);
+    Line->erase(Line->find_last_not_of("\r\n") + 1);
+    xQueueSend(Queue, &Line, 0);
+
+    if(xQueueReceive(Queue, &Line, 0) == pdPASS)
+    {
+        // The old event handling searched the line with temporary substrings.
+        if(Line->find("+EVT") != std::string::npos)
+        {
+            std::string Payload = Line->substr(Line->find_last_of(':') + 1);
+
+            Processed = Payload.length();
+        }
+        else
+        {
+            Processed = Line->length();
+        }
+
+        delete Line;
+    }
+
+    return Processed;
+}
+
+int main(void)
+{
+    RAK3172_t Device = {};
+    RAK3172_EventParser_t Parser;
+    QueueHandle_t StringQueue;
+    size_t Allocations;
+    size_t Bytes;
+    size_t PoolAllocations;
+    size_t PoolBytes;
+    size_t Lines;
+    size_t Sum;
+    std::chrono::steady_clock::time_point Start;
+    double PoolTime;
+    double StringTime;
+
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LinePool_Init(Device));
+    Device.Internal.ReceiveQueue = xQueueCreate(CONFIG_RAK3172_UART_LINE_POOL_SIZE, sizeof(RAK3172_Rx_t));
+    StringQueue = xQueueCreate(CONFIG_RAK3172_UART_LINE_POOL_SIZE, sizeof(std::string*));
+    RAK3172_EventParser_Reset(&Parser);
+
+    Lines = TEST_PASSES * (sizeof(_Test_Lines) / sizeof(_Test_Lines[0]));
+
+    // New receive path. No allocation is allowed after the initialization.
+    Sum = 0;
+    PoolAllocations = RAK3172_Host_GetAllocations();
+    PoolBytes = RAK3172_Host_GetAllocatedBytes();
+    Start = std::chrono::steady_clock::now();
+    for(size_t Pass = 0; Pass < TEST_PASSES; Pass++)
+    {
+        for(size_t i = 0; i < (sizeof(_Test_Lines) / sizeof(_Test_Lines[0])); i++)
+        {
+            Sum += Test_Pool_Receive(Device, &Parser, reinterpret_cast<const uint8_t*>(_Test_Lines[i]), strlen(_Test_Lines[i]));
+            xQueueReset(Device.Internal.ReceiveQueue);
+        }
+    }
+    PoolTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+    PoolAllocations = RAK3172_Host_GetAllocations() - PoolAllocations;
+    PoolBytes = RAK3172_Host_GetAllocatedBytes() - PoolBytes;
+
+    RAK3172_TEST_EQUAL(0, PoolAllocations);
+    RAK3172_TEST_ASSERT(Sum > 0);
+
+    // All slots must be back in the pool.
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UART_LINE_POOL_SIZE; i++)
+    {
+        RAK3172_TEST_ASSERT(RAK3172_LinePool_Take(Device) != NULL);
+    }
+    RAK3172_TEST_ASSERT(RAK3172_LinePool_Take(Device) == NULL);
+
+    // Old receive path for comparison.
+    Sum = 0;
+    Allocations = RAK3172_Host_GetAllocations();
+    Bytes = RAK3172_Host_GetAllocatedBytes();
+    Start = std::chrono::steady_clock::now();
+    for(size_t Pass = 0; Pass < TEST_PASSES; Pass++)
+    {
+        for(size_t i = 0; i < (sizeof(_Test_Lines) / sizeof(_Test_Lines[0])); i++)
+        {
+            Sum += Test_String_Receive(StringQueue, reinterpret_cast<const uint8_t*>(_Test_Lines[i]), strlen(_Test_Lines[i]));
+        }
+    }
+    StringTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+    Allocations = RAK3172_Host_GetAllocations() - Allocations;
+    Bytes = RAK3172_Host_GetAllocatedBytes() - Bytes;
+
+    RAK3172_TEST_ASSERT(Sum > 0);
+
+    printf("Receive path        Heap calls / line   Heap bytes / line   ns / line\n");
+    printf("Line pool           %17.2f   %17.2f   %9.1f\n", static_cast<double>(PoolAllocations) / Lines, static_cast<double>(PoolBytes) / Lines, PoolTime / Lines);
+    printf("String per line     %17.2f   %17.2f   %9.1f\n", static_cast<double>(Allocations) / Lines, static_cast<double>(Bytes) / Lines, StringTime / Lines);
+
+    vQueueDelete(StringQueue);
+    vQueueDelete(Device.Internal.ReceiveQueue);
+    RAK3172_LinePool_Deinit(Device);
+
+    return RAK3172_Test_Result();
+}
@@ -0,0 +1,229 @@
+/*
+ * Host test and measurement for the transmit path of the driver.
+ * The test sends uplink payloads with "RAK3172_SendCommandHex" and checks the data which is written into the UART driver.
+ * The measurement compares the sender side TX occupancy with the transmit path before the streaming, which has encoded the
+ * whole payload into a string with "sprintf" and passed the complete command to "RAK3172_SendCommand":
+ *  - Heap bytes which are allocated for the command
+ *  - Largest block which is passed to the UART driver at once
+ *  - Time from the start of the transmission until the first byte is passed to the UART driver
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "Buffer/rak3172_line_pool.h"
+
+#include "rak3172_host.h"
+#include "rak3172_host_heap.h"
+#include "rak3172_test.h"
+
+/** @brief Number of transmissions for each payload size of the measurement.
+ */
+#define TEST_ROUNDS                             2000
+
+/** @brief Data which is written into the UART driver for a transmission.
+ */
+typedef struct
+{
+    RAK3172_t* p_Device;
+    std::string Data;
+    size_t Writes;
+    size_t MaxWrite;
+    bool isFirst;
+    std::chrono::steady_clock::time_point First;
+} Test_UART_t;
+
+static Test_UART_t _Test_UART;
+
+/** @brief          UART hook. The module answers with "OK" when the command is complete.
+ *  @param p_Data   Pointer to written data
+ *  @param Length   Length of the written data
+ */
+static void Test_UART_Write(const char* p_Data, size_t Length)
+{
+    if(_Test_UART.isFirst)
+    {
+        _Test_UART.First = std::chrono::steady_clock::now();
+        _Test_UART.isFirst = false;
+    }
+
+    _Test_UART.Data.append(p_Data, Length);
+    _Test_UART.Writes++;
+    _Test_UART.MaxWrite = std::max(_Test_UART.MaxWrite, Length);
+
+    if((Length == 2) && (memcmp(p_Data, "\r\n", 2) == 0))
+    {
+        RAK3172_Line_t* Line = RAK3172_LinePool_Take(*_Test_UART.p_Device);
+
+        if(Line != NULL)
+        {
+            strcpy(Line->Data, "OK");
+            Line->Length = 2;
+            RAK3172_LinePool_Push(*_Test_UART.p_Device, Line);
+        }
+    }
+}
+
+/** @brief Start the recording of a transmission.
+ */
+static void Test_UART_Reset(void)
+{
+    _Test_UART.Data.clear();
+    _Test_UART.Writes = 0;
+    _Test_UART.MaxWrite = 0;
+    _Test_UART.isFirst = true;
+}
+
+/** @brief          Payload transmission of "RAK3172_LoRaWAN_Transmit" before the streaming.
+ *  @param p_Device RAK3172 device object
+ *  @param Port     Application port
+ *  @param p_Data   Pointer to payload
+ *  @param Length   Length of the payload
+ *  @return         RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t Test_StringTransmit(RAK3172_t& p_Device, uint8_t Port, const uint8_t* p_Data, size_t Length)
+{
+    std::string Payload;
+    std::string Status;
+    char Buffer[3];
+
+    for(size_t i = 0; i < Length; i++)
+    {
+        sprintf(Buffer, "%02X", p_Data[i]);
+        Payload += std::string(Buffer);
+    }
+
+    return RAK3172_SendCommand(p_Device, "AT+SEND=" + std::to_string(Port) + ":" + Payload, NULL, &Status);
+}
+
+/** @brief          Payload transmission with the streaming of "RAK3172_SendCommandHex".
+ *  @param p_Device RAK3172 device object
+ *  @param Port     Application port
+ *  @param p_Data   Pointer to payload
+ *  @param Length   Length of the payload
+ *  @return         RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t Test_StreamTransmit(RAK3172_t& p_Device, uint8_t Port, const uint8_t* p_Data, size_t Length)
+{
+    std::string Status;
+
+    return RAK3172_SendCommandHex(p_Device, "AT+SEND=" + std::to_string(Port) + ":", p_Data, Length, NULL, &Status);
+}
+
+/** @brief Check the written command of the streaming transmission.
+ */
+static void Test_Stream(RAK3172_t& p_Device)
+{
+    uint8_t Data[100];
+    RAK3172_Segment_t Segments[3];
+
+    for(size_t i = 0; i < sizeof(Data); i++)
+    {
+        Data[i] = static_cast<uint8_t>(i);
+    }
+
+    // Payload with a partial last chunk.
+    Test_UART_Reset();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Test_StreamTransmit(p_Device, 2, Data, 33));
+    RAK3172_TEST_ASSERT(_Test_UART.Data == "AT+SEND=2:000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F20\r\n");
+    RAK3172_TEST_EQUAL(4, _Test_UART.Writes);
+
+    // The old path writes the same command.
+    Test_UART_Reset();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Test_StringTransmit(p_Device, 2, Data, 33));
+    RAK3172_TEST_ASSERT(_Test_UART.Data == "AT+SEND=2:000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F20\r\n");
+
+    // Segments are written in order without separator.
+    Segments[0] = {&Data[0], 2};
+    Segments[1] = {NULL, 0};
+    Segments[2] = {&Data[0x10], 3};
+    Test_UART_Reset();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_SendCommandHex(p_Device, "AT+SEND=3:", Segments, 3));
+    RAK3172_TEST_ASSERT(_Test_UART.Data == "AT+SEND=3:0001101112\r\n");
+
+    // Invalid segments are rejected before anything is written.
+    Segments[1] = {NULL, 4};
+    Test_UART_Reset();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_INVALID_ARG, RAK3172_SendCommandHex(p_Device, "AT+SEND=3:", Segments, 3));
+    RAK3172_TEST_EQUAL(0, _Test_UART.Writes);
+}
+
+int main(void)
+{
+    RAK3172_t Device = {};
+    std::vector<uint8_t> Data(1000);
+
+    Device.UART.Interface = UART_NUM_1;
+    Device.Internal.Lock = xSemaphoreCreateRecursiveMutex();
+    RAK3172_TEST_EQUAL(RAK3172_ERR_OK, RAK3172_LinePool_Init(Device));
+    Device.Internal.isInitialized = true;
+
+    _Test_UART.p_Device = &Device;
+    RAK3172_Host_SetUART(Test_UART_Write);
+
+    Test_Stream(Device);
+
+    for(size_t i = 0; i < Data.size(); i++)
+    {
+        Data[i] = static_cast<uint8_t>((i * 151) + 7);
+    }
+
+    printf("Payload   Transmit path       Heap bytes   Largest write   First byte [ns]   Command [ns]\n");
+
+    // Maximum payload of EU868 DR0, of the fastest data rates and of a long payload.
+    for(size_t Length : {51UL, 242UL, 1000UL})
+    {
+        for(int Path = 0; Path < 2; Path++)
+        {
+            size_t Bytes;
+            size_t MaxWrite = 0;
+            double First = 0;
+            double Total = 0;
+
+            Bytes = RAK3172_Host_GetAllocatedBytes();
+            for(int i = 0; i < TEST_ROUNDS; i++)
+            {
+                std::chrono::steady_clock::time_point Start;
+                RAK3172_Error_t Error;
+
+                Test_UART_Reset();
+                Start = std::chrono::steady_clock::now();
+                if(Path == 0)
+                {
+                    Error = Test_StreamTransmit(Device, 2, Data.data(), Length);
+                }
+                else
+                {
+                    Error = Test_StringTransmit(Device, 2, Data.data(), Length);
+                }
+                Total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+                First += std::chrono::duration<double, std::nano>(_Test_UART.First - Start).count();
+                MaxWrite = std::max(MaxWrite, _Test_UART.MaxWrite);
+
+                RAK3172_TEST_EQUAL(RAK3172_ERR_OK, Error);
+                RAK3172_TEST_EQUAL(10 + (2 * Length) + 2, _Test_UART.Data.length());
+            }
+
+            // The recorder keeps the capacity of its string. So all allocated bytes belong to the transmit path.
+            Bytes = RAK3172_Host_GetAllocatedBytes() - Bytes;
+
+            printf("%-9u %-19s %-12.0f %-15u %-17.0f %.0f\n", static_cast<unsigned int>(Length), (Path == 0) ? "Stream" : "sprintf + string",
+                   static_cast<double>(Bytes) / TEST_ROUNDS, static_cast<unsigned int>(MaxWrite), First / TEST_ROUNDS, Total / TEST_ROUNDS);
+
+            if(Path == 0)
+            {
+                RAK3172_TEST_ASSERT(MaxWrite <= 64);
+            }
+        }
+    }
+
+    RAK3172_Host_SetUART(NULL);
+    RAK3172_LinePool_Deinit(Device);
+
+    return RAK3172_Test_Result();
+}